@@ -0,0 +1,411 @@
+// [analyze.c] file
+
+// sysconf is POSIX, not part of plain C11
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h> // for writing the rows
+#include <stdlib.h> // for malloc / free of queued paths
+#include <string.h> // for comparing arguments and copying paths
+#include <time.h> // for timespec_get (run time)
+#include <pthread.h> // for the worker threads and the work queue
+#include <unistd.h> // for sysconf (number of CPU cores)
+
+#include "analyze.h" // declare "analyze" methods
+#include "bitoperations.h" // PopCount64 for the piece counts
+#include "filewalk.h" // WalkFiles for directories of save files
+#include "game.h" // GameState, PositionProblem and CheckWinner
+#include "movegen.h" // GenerateMoves and MoveToText
+#include "saveload.h" // ReadGameFile
+#include "search.h" // SearchBestMove
+#include "tt.h" // one transposition table per worker
+#include "zobrist.h" // InitZobrist before the workers start
+
+// files waiting in the queue at most, the directory walk waits while it is full
+#define QUEUE_CAPACITY 256
+
+// default and maximum settings
+#define ANALYZE_DEFAULT_DEPTH 8
+#define ANALYZE_MAX_JOBS 256
+
+// size of each worker's transposition table, in MB
+#define ANALYZE_TABLE_MB 2
+
+// fixed-size queue of file paths shared by the directory walk and the workers
+typedef struct
+{
+    char* paths[QUEUE_CAPACITY]; // circular buffer of queued paths
+    int head; // index of the oldest queued path
+    int count; // paths currently queued
+    int closed; // flagger set once no more paths will be added
+    pthread_mutex_t lock; // protects every field above
+    pthread_cond_t notEmpty; // signalled when a path is added or the queue closes
+    pthread_cond_t notFull; // signalled when a path is taken
+} WorkQueue;
+
+// settings and shared state of one analysis run
+typedef struct
+{
+    WorkQueue queue; // files still to analyze
+    FILE* output; // where the rows are written
+    pthread_mutex_t outputLock; // one row is written at a time
+    int jsonl; // 1 for JSON lines, 0 for CSV
+    int depth; // search depth for the best move
+    unsigned long long rows; // rows written (protected by "outputLock")
+    unsigned long long failed; // files that could not be read (protected by "outputLock")
+} Analysis;
+
+// method to read the wall clock in seconds
+static double WallSeconds(void)
+{
+    struct timespec now; // current wall clock time
+    timespec_get(&now, TIME_UTC);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+// method to add a copy of "path" to the queue, waits while the queue is full
+static void QueuePush(WorkQueue* queue, const char* path)
+{
+    size_t length = strlen(path) + 1u; // bytes including the terminator
+    char* copy = (char*)malloc(length); // owned by the queue until a worker frees it
+
+    // qualifier: skip the file if its path cannot be stored
+    if (copy == NULL)
+    {
+        fprintf(stderr, "Out of memory, skipped: %s\n", path);
+        return;
+    }
+    memcpy(copy, path, length);
+
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == QUEUE_CAPACITY) { pthread_cond_wait(&queue->notFull, &queue->lock); }
+    queue->paths[(queue->head + queue->count) % QUEUE_CAPACITY] = copy;
+    queue->count++;
+    pthread_cond_signal(&queue->notEmpty);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+// method to take the oldest path from the queue, waits while the queue is empty
+// returns NULL once the queue is closed and empty, the caller frees the returned path
+static char* QueuePop(WorkQueue* queue)
+{
+    char* path = NULL; // path taken from the queue
+
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == 0 && !queue->closed) { pthread_cond_wait(&queue->notEmpty, &queue->lock); }
+    if (queue->count > 0)
+    {
+        path = queue->paths[queue->head];
+        queue->head = (queue->head + 1) % QUEUE_CAPACITY;
+        queue->count--;
+        pthread_cond_signal(&queue->notFull);
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return path;
+}
+
+// method to mark the queue as finished, wakes every waiting worker
+static void QueueClose(WorkQueue* queue)
+{
+    pthread_mutex_lock(&queue->lock);
+    queue->closed = 1;
+    pthread_cond_broadcast(&queue->notEmpty);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+// method to queue one file found by WalkFiles, "context" is the Analysis
+static void QueueFile(const char* path, void* context)
+{
+    QueuePush(&((Analysis*)context)->queue, path);
+}
+
+// method to write "text" as a quoted CSV field into "buffer", doubling any quotes
+// returns the number of characters written (the buffer holds at least "size" characters)
+static int CsvText(char* buffer, int size, const char* text)
+{
+    int length = 0; // characters written so far
+
+    if (size < 3) { return 0; }
+    buffer[length++] = '"';
+    for (; *text != '\0' && length < size - 3; text++)
+    {
+        if (*text == '"') { buffer[length++] = '"'; }
+        buffer[length++] = *text;
+    }
+    buffer[length++] = '"';
+    buffer[length] = '\0';
+    return length;
+}
+
+// method to write "text" as a quoted JSON string into "buffer", escaping quotes, backslashes and control characters
+// returns the number of characters written (the buffer holds at least "size" characters)
+static int JsonText(char* buffer, int size, const char* text)
+{
+    int length = 0; // characters written so far
+
+    if (size < 3) { return 0; }
+    buffer[length++] = '"';
+    for (; *text != '\0' && length < size - 8; text++)
+    {
+        unsigned char c = (unsigned char)*text; // character being copied
+
+        if (c == '"' || c == '\\') { buffer[length++] = '\\'; buffer[length++] = (char)c; }
+        else if (c < 0x20) { length = length + snprintf(buffer + length, (size_t)(size - length), "\\u%04x", c); }
+        else { buffer[length++] = (char)c; }
+    }
+    buffer[length++] = '"';
+    buffer[length] = '\0';
+    return length;
+}
+
+// method to analyze one save file and write its row
+// "table" is this worker's transposition table
+static void AnalyzeFile(Analysis* analysis, const char* path, TranspositionTable* table)
+{
+    GameState game; // position read from the file
+    SearchResult result; // best move, score, depth and nodes
+    MoveList list; // legal moves for the player to move
+    char problemText[64] = ""; // why the file or position is invalid
+    char moveText[64] = ""; // best move as text
+    char file[2 * WALK_PATH_MAX + 8]; // quoted / escaped path
+    char problem[2 * sizeof(problemText) + 8]; // quoted / escaped problem
+    char row[2 * WALK_PATH_MAX + 512]; // complete row
+    int errorLine = 0; // first invalid line of the file
+    int loaded = 0; // flagger for the file being read
+    int moves = 0; // legal move count
+    int winner = 0; // 1 or 2 when the game is over
+    int length = 0; // characters in "row"
+
+    result.score = 0;
+    result.depth = 0;
+    result.nodes = 0ull;
+
+    loaded = ReadGameFile(path, &game, &errorLine);
+
+    // qualifier: a file that cannot be read still gets a row, explaining why
+    if (!loaded)
+    {
+        if (errorLine == 0) { snprintf(problemText, sizeof(problemText), "could not open file"); }
+        else { snprintf(problemText, sizeof(problemText), "invalid line %d", errorLine); }
+        game.player1_men = game.player1_kings = game.player2_men = game.player2_kings = 0ull;
+        game.current_turn = 0;
+    }
+    // qualifier: only a legal position is played out
+    else if (PositionProblem(&game) != NULL)
+    {
+        snprintf(problemText, sizeof(problemText), "%s", PositionProblem(&game));
+    }
+    else
+    {
+        SearchLimits limits; // fixed depth, so every run gives the same answer
+
+        limits.maxDepth = analysis->depth;
+        limits.timeLimitMs = 0;
+        limits.nodeLimit = 0ull;
+        limits.verbose = 0;
+        limits.table = table;
+        limits.threads = 1;
+        limits.tablebase = NULL;
+        limits.stop = NULL;
+        limits.progress = NULL;
+        limits.progressContext = NULL;
+        limits.weights = NULL;
+
+        moves = GenerateMoves(&game, &list);
+
+        // the game is over when a player has no pieces, or the player to move is blocked
+        winner = CheckWinner(&game);
+        if (winner == 0 && moves == 0) { winner = IsRedPlayer1Turn(&game) ? 2 : 1; }
+
+        // qualifier: search for the best move while the game is still going
+        if (winner == 0)
+        {
+            if (table != NULL) { TTClear(table); }
+            if (SearchBestMove(&game, &limits, &result)) { MoveToText(&result.bestMove, moveText, (int)sizeof(moveText)); }
+        }
+    }
+
+    // build the row in the chosen format
+    if (analysis->jsonl)
+    {
+        JsonText(file, (int)sizeof(file), path);
+        if (problemText[0] != '\0') { JsonText(problem, (int)sizeof(problem), problemText); }
+        else { snprintf(problem, sizeof(problem), "null"); }
+
+        length = snprintf(row, sizeof(row),
+            "{\"file\":%s,\"loaded\":%s,\"problem\":%s,\"turn\":%d,\"red_men\":%d,\"red_kings\":%d,"
+            "\"black_men\":%d,\"black_kings\":%d,\"moves\":%d,\"winner\":%d,\"best_move\":%s%s%s,"
+            "\"score\":%d,\"depth\":%d,\"nodes\":%llu}\n",
+            file, loaded ? "true" : "false", problem, game.current_turn,
+            PopCount64(game.player1_men), PopCount64(game.player1_kings),
+            PopCount64(game.player2_men), PopCount64(game.player2_kings), moves, winner,
+            (moveText[0] != '\0') ? "\"" : "", (moveText[0] != '\0') ? moveText : "null", (moveText[0] != '\0') ? "\"" : "",
+            result.score, result.depth, result.nodes);
+    }
+    else
+    {
+        CsvText(file, (int)sizeof(file), path);
+        CsvText(problem, (int)sizeof(problem), problemText);
+
+        length = snprintf(row, sizeof(row), "%s,%d,%s,%d,%d,%d,%d,%d,%d,%d,%s,%d,%d,%llu\n",
+            file, loaded, problem, game.current_turn,
+            PopCount64(game.player1_men), PopCount64(game.player1_kings),
+            PopCount64(game.player2_men), PopCount64(game.player2_kings), moves, winner,
+            moveText, result.score, result.depth, result.nodes);
+    }
+
+    // qualifier: a truncated row is still written up to the buffer size
+    if (length < 0) { return; }
+    if (length >= (int)sizeof(row)) { length = (int)sizeof(row) - 1; }
+
+    // write the whole row at once, so rows from different workers never mix
+    pthread_mutex_lock(&analysis->outputLock);
+    fwrite(row, 1u, (size_t)length, analysis->output);
+    analysis->rows++;
+    if (!loaded) { analysis->failed++; }
+    pthread_mutex_unlock(&analysis->outputLock);
+}
+
+// method run by each worker thread, analyzes files until the queue is closed and empty
+static void* Worker(void* argument)
+{
+    Analysis* analysis = (Analysis*)argument; // shared run state
+    TranspositionTable table; // this worker's own table
+    TranspositionTable* tablePointer = NULL; // "table" once allocated
+    char* path = NULL; // file being analyzed
+
+    // qualifier: the search still works without a table if memory is short
+    if (TTInit(&table, ANALYZE_TABLE_MB)) { tablePointer = &table; }
+
+    while ((path = QueuePop(&analysis->queue)) != NULL)
+    {
+        AnalyzeFile(analysis, path, tablePointer);
+        free(path);
+    }
+
+    if (tablePointer != NULL) { TTFree(tablePointer); }
+    return NULL;
+}
+
+// method to find the number of CPU cores, 1 if unknown
+static int CoreCount(void)
+{
+#ifdef _SC_NPROCESSORS_ONLN
+    long cores = sysconf(_SC_NPROCESSORS_ONLN); // cores currently online
+    if (cores > 0) { return (cores > ANALYZE_MAX_JOBS) ? ANALYZE_MAX_JOBS : (int)cores; }
+#endif
+    return 1;
+}
+
+// run the batch analysis, "argc" / "argv" are the arguments after "analyze"
+int RunAnalyze(int argc, char* argv[])
+{
+    static Analysis analysis; // shared run state (static, the queue is large)
+    pthread_t workers[ANALYZE_MAX_JOBS]; // worker thread handles
+    const char* outputName = NULL; // output file, NULL for the terminal
+    int jobs = CoreCount(); // worker threads
+    int started = 0; // workers actually running
+    int errors = 0; // unreadable paths
+    int firstPath = 0; // index of the first path argument
+    double startTime = WallSeconds(); // for the summary line
+    int i = 0; // loop iterator for arguments and workers
+
+    analysis.jsonl = 0;
+    analysis.depth = ANALYZE_DEFAULT_DEPTH;
+
+    // read the options, the first argument that is not an option starts the paths
+    for (i = 0; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--format") == 0 && i + 1 < argc)
+        {
+            i++;
+            if (strcmp(argv[i], "jsonl") == 0) { analysis.jsonl = 1; }
+            else if (strcmp(argv[i], "csv") == 0) { analysis.jsonl = 0; }
+            else
+            {
+                printf("Format must be csv or jsonl.\n");
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) { outputName = argv[++i]; }
+        else if (strcmp(argv[i], "--depth") == 0 && i + 1 < argc) { analysis.depth = atoi(argv[++i]); }
+        else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) { jobs = atoi(argv[++i]); }
+        else { break; }
+    }
+    firstPath = i;
+
+    // qualifier: at least one path, and settings inside a sensible range
+    if (firstPath >= argc)
+    {
+        printf("Usage: bitboardcheckers analyze [--format csv|jsonl] [--output FILE] [--depth D] [--jobs N] <dir|files...>\n");
+        return 1;
+    }
+    if (analysis.depth < 1 || analysis.depth > SEARCH_MAX_DEPTH)
+    {
+        printf("Depth must be between 1 and %d.\n", SEARCH_MAX_DEPTH);
+        return 1;
+    }
+    if (jobs < 1 || jobs > ANALYZE_MAX_JOBS)
+    {
+        printf("Jobs must be between 1 and %d.\n", ANALYZE_MAX_JOBS);
+        return 1;
+    }
+
+    // open the output
+    analysis.output = stdout;
+    if (outputName != NULL)
+    {
+        analysis.output = fopen(outputName, "w");
+        if (analysis.output == NULL)
+        {
+            printf("Could not open file for writing: %s\n", outputName);
+            return 1;
+        }
+    }
+
+    // qualifier: CSV starts with the column names
+    if (!analysis.jsonl)
+    {
+        fprintf(analysis.output, "file,loaded,problem,turn,red_men,red_kings,black_men,black_kings,"
+            "moves,winner,best_move,score,depth,nodes\n");
+    }
+
+    // the key tables are filled once here, the workers only read them
+    InitZobrist();
+
+    pthread_mutex_init(&analysis.queue.lock, NULL);
+    pthread_cond_init(&analysis.queue.notEmpty, NULL);
+    pthread_cond_init(&analysis.queue.notFull, NULL);
+    pthread_mutex_init(&analysis.outputLock, NULL);
+
+    // start the workers, then feed them every path
+    for (i = 0; i < jobs; i++)
+    {
+        if (pthread_create(&workers[started], NULL, Worker, &analysis) == 0) { started++; }
+    }
+
+    // qualifier: nothing would empty the queue without a worker
+    if (started == 0)
+    {
+        fprintf(stderr, "Could not start worker threads.\n");
+        if (analysis.output != stdout) { fclose(analysis.output); }
+        return 1;
+    }
+
+    for (i = firstPath; i < argc; i++) { errors = errors + WalkFiles(argv[i], QueueFile, &analysis); }
+    QueueClose(&analysis.queue);
+
+    for (i = 0; i < started; i++) { pthread_join(workers[i], NULL); }
+
+    pthread_mutex_destroy(&analysis.queue.lock);
+    pthread_cond_destroy(&analysis.queue.notEmpty);
+    pthread_cond_destroy(&analysis.queue.notFull);
+    pthread_mutex_destroy(&analysis.outputLock);
+
+    if (analysis.output != stdout) { fclose(analysis.output); }
+
+    // summary on the error stream, so the rows stay clean
+    fprintf(stderr, "Analyzed %llu files (%llu unreadable, %d paths skipped) in %.3f s with %d workers.\n",
+        analysis.rows, analysis.failed, errors, WallSeconds() - startTime, started);
+
+    return (analysis.failed > 0ull || errors > 0) ? 1 : 0;
+}
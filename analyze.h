@@ -0,0 +1,46 @@
+// [analyze.h] header file
+// function declarations for "analyze.c"
+// implemented in "main.c"
+
+#ifndef ANALYZE_H
+#define ANALYZE_H
+
+// { Phase 4 - Batch Analysis } //
+// non-interactive mode for large collections of 5-line save files
+
+/*
+    Usage:
+        ./bitboardcheckers analyze [options] <dir|files...>
+
+        --format csv|jsonl  row format (default csv)
+        --output FILE       write the rows to FILE (default: the terminal)
+        --depth D           search depth for the best move (default 8)
+        --jobs N            worker threads (default: one per CPU core)
+
+    Directories are searched for save files, including their sub-folders
+    (names starting with "." are skipped). Every file is read with the same
+    rules as "Load Game" and gets one row:
+
+        file         path of the save file
+        loaded       1 if the file could be read, 0 if not
+        problem      why the file or position is invalid (empty if legal)
+        turn         player to move, 1 (Red) or 2 (Black)
+        red_men, red_kings, black_men, black_kings   piece counts
+        moves        number of legal moves for the player to move
+        winner       1 (Red) or 2 (Black) if the game is over, otherwise 0
+        best_move    best move found by the search ("21-28" / "28x42x56")
+        score        search score for the player to move (a man is worth 100)
+        depth        depth searched
+        nodes        positions visited by the search
+
+    Files are handed to the workers through a fixed-size queue, so memory
+    use stays the same however many files there are. Rows are written as
+    each file finishes, so their order can change between runs; the search
+    itself is deterministic (fixed depth, table cleared for every position).
+*/
+
+// run the batch analysis, "argc" / "argv" are the arguments after "analyze"
+// returns 0 when every file was analyzed, 1 on a usage error or if any file failed to load
+int RunAnalyze(int argc, char* argv[]);
+
+#endif
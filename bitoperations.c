@@ -86,29 +86,10 @@ int GetBit(unsigned int value, int position)
 // Counting and finding //
 
 // count number of 1s in "value"
-// loops through each bit (0-31) and adds all bits set
+// uses the 64-bit population count (one instruction where available)
 int CountBits(unsigned int value)
 {
-    int count = 0; // initialize count of set bits
-    int i = 0; // loop index for each bit position (0-31)
-
-    // traverse each bit position
-    for (i = 0; i < 32; i++) 
-    {
-        // create a mask for the current bit position,
-        // shifting 1 to the left by i bits
-        // this isolates the bit at position i
-        unsigned int mask = (1u << i);
-
-        // qualifier: if value AND mask is not zero, that bit is set
-        if ((value & mask) != 0u) 
-        {
-            count = count + 1; // increment count for each bit set
-        }
-    }
-
-    // return the total count of set bits
-    return count;
+    return PopCount64((unsigned long long)value);
 }
 
 // Shift operations //
@@ -180,4 +161,20 @@ void PrintHex(unsigned int value)
     // use printf to format and print value in hexadecimal
     // with "0x" and zero-padded to 8 digits
     printf("Printed Hex: 0x%08X\n", value);
-}
\ No newline at end of file
+}
+
+// 64-bit Bitboard Operations //
+
+// lookup table for the portable de Bruijn bit scan in "bitoperations.h"
+// entry (((bit * 0x03F79D71B4CB0A89) >> 58)) holds the index of the single set "bit"
+const unsigned char bitScanIndex64[64] =
+{
+     0,  1, 48,  2, 57, 49, 28,  3,
+    61, 58, 50, 42, 38, 29, 17,  4,
+    62, 55, 59, 36, 53, 51, 43, 22,
+    45, 39, 33, 30, 24, 18, 12,  5,
+    63, 47, 56, 27, 60, 41, 37, 16,
+    54, 35, 52, 21, 44, 32, 23, 11,
+    46, 26, 40, 15, 34, 20, 31, 10,
+    25, 14, 19,  9, 13,  8,  7,  6
+};
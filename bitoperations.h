@@ -46,7 +46,7 @@ int GetBit(unsigned int value, int position);
 // Counting and finding //
 
 // count number of 1s in "value"
-// loops through each bit (0-31) and adds all bits set
+// uses the 64-bit population count below (one instruction where available)
 int CountBits(unsigned int value);
 
 // Shift operations //
@@ -77,4 +77,109 @@ void PrintHex(unsigned int value);
 // if "position" is outside range, returns 0 by default
 unsigned int CreateMask(int position);
 
+// { Phase 4 - 64-bit Bitboard Operations } //
+// counting and scanning for the 64-bit game bitboards (unsigned long long)
+
+/*
+    The move generator, search and position checks call these for every
+    position, so they are defined here as "static inline" functions and
+    compile down to single instructions when the compiler offers them:
+
+        GCC / Clang   __builtin_ctzll / __builtin_clzll (bsf / bsr, or tzcnt / lzcnt with BMI)
+                      __builtin_popcountll when POPCNT is enabled (-mpopcnt or -march=native),
+                      or on targets other than x86 where it is always a short instruction sequence
+        MSVC (x64)    _BitScanForward64 / _BitScanReverse64, __popcnt64 with /arch:AVX or later
+        otherwise     portable fallback: parallel bit count and a de Bruijn multiply lookup
+
+    Plain x86-64 builds without POPCNT use the parallel bit count, which is
+    faster than the library call the compiler would otherwise make.
+    "board" must be non-zero for the bit scans.
+
+    Set bits are visited with PopLowestBit64:
+        while (board != 0ull) { int square = PopLowestBit64(&board); ... }
+*/
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define BITOPS_GCC_SCAN 1
+    #if defined(__POPCNT__) || !(defined(__x86_64__) || defined(__i386__))
+        #define BITOPS_GCC_POPCOUNT 1
+    #endif
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+    #include <intrin.h> // _BitScanForward64 / _BitScanReverse64 / __popcnt64
+    #define BITOPS_MSVC_SCAN 1
+    #if defined(_M_X64) && defined(__AVX__)
+        #define BITOPS_MSVC_POPCOUNT 1
+    #endif
+#endif
+
+// lookup table for the portable de Bruijn bit scan, defined in "bitoperations.c"
+extern const unsigned char bitScanIndex64[64];
+
+// count the set bits (pieces) on "board" (0-64)
+static inline int PopCount64(unsigned long long board)
+{
+#if defined(BITOPS_GCC_POPCOUNT)
+    return __builtin_popcountll(board);
+#elif defined(BITOPS_MSVC_POPCOUNT)
+    return (int)__popcnt64(board);
+#else
+    // parallel bit count: sums of 2, 4, then 8 bits, added up by one multiply
+    board = board - ((board >> 1) & 0x5555555555555555ull);
+    board = (board & 0x3333333333333333ull) + ((board >> 2) & 0x3333333333333333ull);
+    board = (board + (board >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return (int)((board * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+// isolate the lowest set bit of "board" as a mask (0 if "board" is 0)
+static inline unsigned long long LowestSetBit64(unsigned long long board)
+{
+    return board & (0ull - board);
+}
+
+// index (0-63) of the lowest set bit of a non-zero "board"
+static inline int BitScanForward64(unsigned long long board)
+{
+#if defined(BITOPS_GCC_SCAN)
+    return __builtin_ctzll(board);
+#elif defined(BITOPS_MSVC_SCAN)
+    unsigned long index = 0; // filled by the intrinsic
+    _BitScanForward64(&index, board);
+    return (int)index;
+#else
+    // a de Bruijn multiply maps the isolated bit to a unique table slot
+    return bitScanIndex64[(LowestSetBit64(board) * 0x03F79D71B4CB0A89ull) >> 58];
+#endif
+}
+
+// index (0-63) of the highest set bit of a non-zero "board"
+static inline int BitScanReverse64(unsigned long long board)
+{
+#if defined(BITOPS_GCC_SCAN)
+    return 63 - __builtin_clzll(board);
+#elif defined(BITOPS_MSVC_SCAN)
+    unsigned long index = 0; // filled by the intrinsic
+    _BitScanReverse64(&index, board);
+    return (int)index;
+#else
+    // spread the highest bit into every lower bit, keep only the highest, then scan it
+    board = board | (board >> 1);
+    board = board | (board >> 2);
+    board = board | (board >> 4);
+    board = board | (board >> 8);
+    board = board | (board >> 16);
+    board = board | (board >> 32);
+    return bitScanIndex64[((board & ~(board >> 1)) * 0x03F79D71B4CB0A89ull) >> 58];
+#endif
+}
+
+// index (0-63) of the lowest set bit of a non-zero "*board", which is cleared
+// used to walk over every set bit (every piece) of a bitboard
+static inline int PopLowestBit64(unsigned long long* board)
+{
+    int index = BitScanForward64(*board); // square of the lowest set bit
+    *board = *board & (*board - 1ull); // clear it
+    return index;
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,150 @@
+// [board32.c] file
+
+#include "board32.h" // declare "board32" and "game" variables/methods
+#include "zobrist.h" // position key for unpacked boards
+#include "evaluate.h" // evaluation features for unpacked boards
+
+// board index (0-63) of each square number, entry 0 is unused
+static const int squareIndex[BOARD32_SQUARES + 1] =
+{
+    -1,
+     1,  3,  5,  7,  8, 10, 12, 14,
+    17, 19, 21, 23, 24, 26, 28, 30,
+    33, 35, 37, 39, 40, 42, 44, 46,
+    49, 51, 53, 55, 56, 58, 60, 62
+};
+
+// square number (1-32) of each board index, 0 for light squares
+static const int indexSquare[64] =
+{
+     0,  1,  0,  2,  0,  3,  0,  4,
+     5,  0,  6,  0,  7,  0,  8,  0,
+     0,  9,  0, 10,  0, 11,  0, 12,
+    13,  0, 14,  0, 15,  0, 16,  0,
+     0, 17,  0, 18,  0, 19,  0, 20,
+    21,  0, 22,  0, 23,  0, 24,  0,
+     0, 25,  0, 26,  0, 27,  0, 28,
+    29,  0, 30,  0, 31,  0, 32,  0
+};
+
+// square set masks used by Board32Step
+#define EVEN_ROWS 0x0F0F0F0Fu // rows 0, 2, 4, 6
+#define ODD_ROWS 0xF0F0F0F0u // rows 1, 3, 5, 7
+#define FIRST_IN_ROW 0x11111111u // leftmost square of each row
+#define LAST_IN_ROW 0x88888888u // rightmost square of each row
+#define TOP_ROW 0x0000000Fu // squares 1-4
+#define BOTTOM_ROW 0xF0000000u // squares 29-32
+
+// convert a square number (1-32) to its board index (0-63)
+int SquareToIndex(int square)
+{
+    // qualifier: only squares 1-32 exist
+    if (square < 1 || square > BOARD32_SQUARES) { return -1; }
+    return squareIndex[square];
+}
+
+// convert a board index (0-63) to its square number (1-32)
+int IndexToSquare(int index)
+{
+    // qualifier: only indexes 0-63 exist
+    if (index < 0 || index > 63) { return 0; }
+    return indexSquare[index];
+}
+
+// squeeze the dark squares of a 64-bit bitboard into a square set
+// even rows use the odd columns and odd rows the even columns, so both are lined up on
+// the even bits of the even-row bytes, packed 4 bits per row, then the 4 row-pair bytes are joined
+unsigned int CompressBoard(unsigned long long board)
+{
+    unsigned long long evenRows = (board >> 1) & 0x0055005500550055ull; // rows 0, 2, 4, 6 (columns 1, 3, 5, 7)
+    unsigned long long oddRows = (board >> 8) & 0x0055005500550055ull; // rows 1, 3, 5, 7 (columns 0, 2, 4, 6)
+    unsigned long long packed = 0ull; // row pair "r" in byte 2r (low 4 bits even row, high 4 bits odd row)
+
+    // qualifier: squeeze bits 0, 2, 4, 6 of every byte into bits 0-3
+    evenRows = (evenRows | (evenRows >> 1)) & 0x3333333333333333ull;
+    evenRows = (evenRows | (evenRows >> 2)) & 0x0F0F0F0F0F0F0F0Full;
+    oddRows = (oddRows | (oddRows >> 1)) & 0x3333333333333333ull;
+    oddRows = (oddRows | (oddRows >> 2)) & 0x0F0F0F0F0F0F0F0Full;
+
+    // join bytes 0, 2, 4, 6 into one 32-bit square set
+    packed = evenRows | (oddRows << 4);
+    packed = (packed | (packed >> 8)) & 0x0000FFFF0000FFFFull;
+    packed = (packed | (packed >> 16)) & 0x00000000FFFFFFFFull;
+    return (unsigned int)packed;
+}
+
+// spread a square set back onto the dark squares of a 64-bit bitboard (reverse of CompressBoard)
+unsigned long long ExpandBoard(unsigned int squares)
+{
+    unsigned long long spread = (unsigned long long)(squares & 0xFFFFFFFFu); // row pair "r" moved to byte 2r
+    unsigned long long evenRows = 0ull; // rows 0, 2, 4, 6
+    unsigned long long oddRows = 0ull; // rows 1, 3, 5, 7
+
+    spread = (spread | (spread << 16)) & 0x0000FFFF0000FFFFull;
+    spread = (spread | (spread << 8)) & 0x00FF00FF00FF00FFull;
+
+    // qualifier: spread bits 0-3 of every byte onto bits 0, 2, 4, 6
+    evenRows = spread & 0x000F000F000F000Full;
+    oddRows = (spread >> 4) & 0x000F000F000F000Full;
+    evenRows = (evenRows | (evenRows << 2)) & 0x3333333333333333ull;
+    evenRows = (evenRows | (evenRows << 1)) & 0x5555555555555555ull;
+    oddRows = (oddRows | (oddRows << 2)) & 0x3333333333333333ull;
+    oddRows = (oddRows | (oddRows << 1)) & 0x5555555555555555ull;
+
+    return (evenRows << 1) | (oddRows << 8);
+}
+
+// convert "game" into the 32-square layout
+void PackBoard(const GameState* game, PackedBoard* packed)
+{
+    packed->red = CompressBoard(game->player1_men | game->player1_kings);
+    packed->black = CompressBoard(game->player2_men | game->player2_kings);
+    packed->kings = CompressBoard(game->player1_kings | game->player2_kings);
+    packed->turn = game->current_turn;
+}
+
+// convert "packed" back into "game"
+int UnpackBoard(const PackedBoard* packed, GameState* game)
+{
+    // qualifier: reject boards that no GameState could have produced
+    if ((packed->red & packed->black) != 0u) { return 0; }
+    if ((packed->kings & ~(packed->red | packed->black)) != 0u) { return 0; }
+    if (packed->turn != 1 && packed->turn != 2) { return 0; }
+
+    game->player1_men = ExpandBoard(packed->red & ~packed->kings);
+    game->player1_kings = ExpandBoard(packed->red & packed->kings);
+    game->player2_men = ExpandBoard(packed->black & ~packed->kings);
+    game->player2_kings = ExpandBoard(packed->black & packed->kings);
+    game->current_turn = packed->turn;
+    game->zobrist_key = ComputeZobristKey(game);
+    ComputeEvalTerms(game);
+    return 1;
+}
+
+// move every square in "squares" one diagonal step in "direction"
+// each direction is two masked shifts: one for the even rows and one for the odd rows
+unsigned int Board32Step(unsigned int squares, int direction)
+{
+    switch (direction)
+    {
+        // down-right: even rows +5 (not the last square of the row), odd rows +4
+        case BOARD32_DOWN_RIGHT:
+            return ((squares & EVEN_ROWS & ~LAST_IN_ROW) << 5) | ((squares & ODD_ROWS & ~BOTTOM_ROW) << 4);
+
+        // down-left: even rows +4, odd rows +3 (not the first square of the row)
+        case BOARD32_DOWN_LEFT:
+            return ((squares & EVEN_ROWS) << 4) | ((squares & ODD_ROWS & ~FIRST_IN_ROW & ~BOTTOM_ROW) << 3);
+
+        // up-right: even rows -3 (not the top row or the last square of the row), odd rows -4
+        case BOARD32_UP_RIGHT:
+            return ((squares & EVEN_ROWS & ~LAST_IN_ROW & ~TOP_ROW) >> 3) | ((squares & ODD_ROWS) >> 4);
+
+        // up-left: even rows -4 (not the top row), odd rows -5 (not the first square of the row)
+        case BOARD32_UP_LEFT:
+            return ((squares & EVEN_ROWS & ~TOP_ROW) >> 4) | ((squares & ODD_ROWS & ~FIRST_IN_ROW) >> 5);
+
+        // unknown direction, nothing moves
+        default:
+            return 0u;
+    }
+}
@@ -0,0 +1,83 @@
+// [board32.h] header file
+// function declarations for "board32.c"
+// implemented in "posdb.c"
+
+#ifndef BOARD32_H
+#define BOARD32_H
+
+#include "game.h" // implement GameState structure
+
+// { Phase 4 - 32-Square Board } //
+// compact board layout using only the 32 playable squares,
+// with conversions to and from the 64-bit GameState bitboards
+
+/*
+    Standard checkers numbering: the dark squares are numbered 1-32 row by
+    row from the top of the board, so square n is at
+
+        row = (n - 1) / 4
+        col = 2 * ((n - 1) % 4) + 1   on even rows (0, 2, 4, 6)
+        col = 2 * ((n - 1) % 4)       on odd rows  (1, 3, 5, 7)
+
+        row 0:     1     2     3     4        (indexes  1,  3,  5,  7)
+        row 1:  5     6     7     8           (indexes  8, 10, 12, 14)
+        ...
+        row 7: 29    30    31    32           (indexes 56, 58, 60, 62)
+
+    Red moves first and starts on squares 1-12, Black starts on 21-32
+    (the same squares as the first and second player in published games).
+
+    A "square set" is a 32-bit unsigned int with bit (n - 1) for square n.
+    A PackedBoard holds 3 square sets and the turn (16 bytes instead of 40).
+
+    Diagonal steps are not a single shift in this numbering: moving down
+    from square n reaches n + 4 and n + 5 from an even row, n + 3 and n + 4
+    from an odd row. Board32Step does each direction with two masked shifts
+    and no branches.
+*/
+
+// number of playable squares
+#define BOARD32_SQUARES 32
+
+// step directions for Board32Step, in the same order as the 64-bit shifts +9, +7, -7, -9
+#define BOARD32_DOWN_RIGHT 0 // row + 1, col + 1 (index + 9)
+#define BOARD32_DOWN_LEFT 1 // row + 1, col - 1 (index + 7)
+#define BOARD32_UP_RIGHT 2 // row - 1, col + 1 (index - 7)
+#define BOARD32_UP_LEFT 3 // row - 1, col - 1 (index - 9)
+
+// position using 32-bit square sets
+typedef struct
+{
+    unsigned int red; // Red pieces (men and kings)
+    unsigned int black; // Black pieces (men and kings)
+    unsigned int kings; // kings of either player
+    int turn; // 1 Red, 2 Black (same as "current_turn")
+} PackedBoard;
+
+// convert a square number (1-32) to its board index (0-63)
+// returns -1 if "square" is outside 1-32
+int SquareToIndex(int square);
+
+// convert a board index (0-63) to its square number (1-32)
+// returns 0 for a light square or an index outside 0-63
+int IndexToSquare(int index);
+
+// squeeze the dark squares of a 64-bit bitboard into a square set (light squares are dropped)
+unsigned int CompressBoard(unsigned long long board);
+
+// spread a square set back onto the dark squares of a 64-bit bitboard
+unsigned long long ExpandBoard(unsigned int squares);
+
+// convert "game" into the 32-square layout
+void PackBoard(const GameState* game, PackedBoard* packed);
+
+// convert "packed" back into "game" (bitboards, "current_turn" and "zobrist_key")
+// returns 1 on success, 0 if "packed" is invalid (Red and Black on one square,
+// a king on an empty square, or a turn other than 1 / 2), "game" is then unchanged
+int UnpackBoard(const PackedBoard* packed, GameState* game);
+
+// move every square in "squares" one diagonal step in "direction" (BOARD32_DOWN_RIGHT ...)
+// squares that would leave the board are dropped
+unsigned int Board32Step(unsigned int squares, int direction);
+
+#endif
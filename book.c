@@ -0,0 +1,352 @@
+// [book.c] file
+
+#include <stdio.h> // for writing the book file
+#include <stdlib.h> // for calloc / malloc / qsort
+#include <string.h> // for comparing the header magic
+
+#include "book.h" // declare "book", "game", "movegen" and "mapfile" variables/methods
+
+// first 8 bytes of every book file
+static const unsigned char bookMagic[8] = { 'B', 'B', 'C', 'K', 'B', 'K', '0', '1' };
+
+// slots in a new builder table, doubled whenever it is half full
+#define BUILDER_START_SLOTS 4096u
+
+// largest count a record can hold
+#define BOOK_MAX_COUNT 65535u
+
+// statistics of one (position, move) pair while the book is built
+struct BookEntry
+{
+    unsigned long long key; // Zobrist key of the position before the move
+    unsigned char from; // FROM square of the move
+    unsigned char to; // TO square (final landing square of a capture)
+    unsigned int games; // games counted, 0 marks an empty slot
+    unsigned int wins; // games won by the player making the move
+    unsigned int draws; // games drawn
+    unsigned int losses; // games lost
+};
+
+// Little-Endian Numbers //
+
+// method to write a 16-bit number as 2 little-endian bytes
+static void Write16(unsigned char* bytes, unsigned int value)
+{
+    bytes[0] = (unsigned char)(value & 0xFFu);
+    bytes[1] = (unsigned char)((value >> 8) & 0xFFu);
+}
+
+// method to write a 32-bit number as 4 little-endian bytes
+static void Write32(unsigned char* bytes, unsigned int value)
+{
+    Write16(bytes, value & 0xFFFFu);
+    Write16(bytes + 2, value >> 16);
+}
+
+// method to write a 64-bit number as 8 little-endian bytes
+static void Write64(unsigned char* bytes, unsigned long long value)
+{
+    Write32(bytes, (unsigned int)(value & 0xFFFFFFFFull));
+    Write32(bytes + 4, (unsigned int)(value >> 32));
+}
+
+// method to read 2 little-endian bytes as a 16-bit number
+static unsigned int Read16(const unsigned char* bytes)
+{
+    return (unsigned int)bytes[0] | ((unsigned int)bytes[1] << 8);
+}
+
+// method to read 4 little-endian bytes as a 32-bit number
+static unsigned int Read32(const unsigned char* bytes)
+{
+    return Read16(bytes) | (Read16(bytes + 2) << 16);
+}
+
+// method to read 8 little-endian bytes as a 64-bit number
+static unsigned long long Read64(const unsigned char* bytes)
+{
+    return (unsigned long long)Read32(bytes) | ((unsigned long long)Read32(bytes + 4) << 32);
+}
+
+// Building //
+
+// method to find the slot of a (key, from, to) pair in "entries", or the empty slot where it belongs
+static size_t FindEntrySlot(const BookEntry* entries, size_t capacity, unsigned long long key, int from, int to)
+{
+    unsigned long long hash = key ^ ((unsigned long long)from << 6 | (unsigned long long)to) * 0x9E3779B97F4A7C15ull; // mixed pair
+    size_t slot = (size_t)(hash ^ (hash >> 29)) & (capacity - 1u); // first slot to try
+
+    // qualifier: linear probing, the table is never more than half full
+    while (entries[slot].games != 0u
+        && (entries[slot].key != key || entries[slot].from != from || entries[slot].to != to))
+    {
+        slot = (slot + 1u) & (capacity - 1u);
+    }
+    return slot;
+}
+
+// method to double the builder table, moving every entry into the new one
+// returns 1 on success, 0 if the memory could not be allocated (the old table is kept)
+static int GrowBuilder(BookBuilder* builder)
+{
+    size_t capacity = (builder->capacity == 0u) ? BUILDER_START_SLOTS : builder->capacity * 2u; // new slot count
+    BookEntry* entries = (BookEntry*)calloc(capacity, sizeof(BookEntry)); // new table, every slot empty
+    size_t i = 0; // loop iterator for the old slots
+
+    if (entries == NULL) { return 0; }
+
+    for (i = 0; i < builder->capacity; i++)
+    {
+        const BookEntry* entry = &builder->entries[i]; // old slot
+
+        if (entry->games == 0u) { continue; }
+        entries[FindEntrySlot(entries, capacity, entry->key, entry->from, entry->to)] = *entry;
+    }
+
+    free(builder->entries);
+    builder->entries = entries;
+    builder->capacity = capacity;
+    return 1;
+}
+
+// start an empty builder
+void InitBookBuilder(BookBuilder* builder)
+{
+    builder->entries = NULL;
+    builder->capacity = 0u;
+    builder->count = 0u;
+    builder->failed = 0;
+}
+
+// count "move" played in "game" in a game that ended with "result"
+int AddBookMove(BookBuilder* builder, const GameState* game, const Move* move, int result)
+{
+    BookEntry* entry = NULL; // slot of the pair
+
+    // qualifier: keep the table at most half full so probing stays short
+    if ((builder->count + 1u) * 2u > builder->capacity && !GrowBuilder(builder))
+    {
+        builder->failed = 1;
+        return 0;
+    }
+
+    entry = &builder->entries[FindEntrySlot(builder->entries, builder->capacity, game->zobrist_key, move->from, move->to)];
+    if (entry->games == 0u)
+    {
+        entry->key = game->zobrist_key;
+        entry->from = (unsigned char)move->from;
+        entry->to = (unsigned char)move->to;
+        builder->count++;
+    }
+
+    entry->games++;
+    if (result == BOOK_RESULT_DRAW) { entry->draws++; }
+    else if (result == game->current_turn) { entry->wins++; }
+    else { entry->losses++; }
+    return 1;
+}
+
+// method to order entries by key, then by most games, then by move (qsort comparison)
+static int CompareEntries(const void* left, const void* right)
+{
+    const BookEntry* a = (const BookEntry*)left; // first entry
+    const BookEntry* b = (const BookEntry*)right; // second entry
+
+    if (a->key != b->key) { return (a->key < b->key) ? -1 : 1; }
+    if (a->games != b->games) { return (a->games > b->games) ? -1 : 1; }
+    if (a->from != b->from) { return (a->from < b->from) ? -1 : 1; }
+    if (a->to != b->to) { return (a->to < b->to) ? -1 : 1; }
+    return 0;
+}
+
+// method to fill one record from "entry", scaling the counts down together when one is too large
+static void PackRecord(const BookEntry* entry, unsigned char* record)
+{
+    unsigned int largest = entry->wins; // largest of the three counts
+    unsigned long long wins = entry->wins; // counts as stored
+    unsigned long long draws = entry->draws;
+    unsigned long long losses = entry->losses;
+
+    if (entry->draws > largest) { largest = entry->draws; }
+    if (entry->losses > largest) { largest = entry->losses; }
+
+    // qualifier: keep the ratios, a count that was not 0 stays at least 1
+    if (largest > BOOK_MAX_COUNT)
+    {
+        wins = (wins * BOOK_MAX_COUNT + largest - 1u) / largest;
+        draws = (draws * BOOK_MAX_COUNT + largest - 1u) / largest;
+        losses = (losses * BOOK_MAX_COUNT + largest - 1u) / largest;
+    }
+
+    Write64(record, entry->key);
+    record[8] = entry->from;
+    record[9] = entry->to;
+    Write16(record + 10, (unsigned int)wins);
+    Write16(record + 12, (unsigned int)draws);
+    Write16(record + 14, (unsigned int)losses);
+}
+
+// write every pair played in at least "minGames" games as a book file "filename"
+int WriteBook(const BookBuilder* builder, const char* filename, unsigned int minGames,
+    unsigned long long* positions, unsigned long long* records)
+{
+    unsigned char header[BOOK_HEADER_BYTES] = { 0 }; // magic, record size, reserved
+    BookEntry* kept = NULL; // pairs written, sorted
+    size_t keptCount = 0u; // entries in "kept"
+    unsigned long long keys = 0ull; // different positions written
+    FILE* file = NULL; // book being written
+    int failed = 0; // flagger set if any write failed
+    size_t i = 0; // loop iterator for the entries
+
+    if (positions != NULL) { *positions = 0ull; }
+    if (records != NULL) { *records = 0ull; }
+    if (builder->failed) { return 0; }
+
+    // qualifier: an empty builder still writes a valid (empty) book
+    if (builder->count > 0u)
+    {
+        kept = (BookEntry*)malloc(builder->count * sizeof(BookEntry));
+        if (kept == NULL) { return 0; }
+    }
+    for (i = 0; i < builder->capacity; i++)
+    {
+        if (builder->entries[i].games != 0u && builder->entries[i].games >= minGames) { kept[keptCount++] = builder->entries[i]; }
+    }
+    if (keptCount > 1u) { qsort(kept, keptCount, sizeof(BookEntry), CompareEntries); }
+
+    file = fopen(filename, "wb");
+    if (file == NULL)
+    {
+        free(kept);
+        return 0;
+    }
+
+    memcpy(header, bookMagic, sizeof(bookMagic));
+    Write32(header + 8, BOOK_RECORD_BYTES);
+    if (fwrite(header, 1u, sizeof(header), file) != sizeof(header)) { failed = 1; }
+
+    for (i = 0; i < keptCount && !failed; i++)
+    {
+        unsigned char record[BOOK_RECORD_BYTES]; // packed pair
+
+        if (i == 0u || kept[i].key != kept[i - 1u].key) { keys++; }
+        PackRecord(&kept[i], record);
+        if (fwrite(record, 1u, sizeof(record), file) != sizeof(record)) { failed = 1; }
+    }
+
+    if (fclose(file) != 0) { failed = 1; }
+    free(kept);
+
+    if (positions != NULL) { *positions = keys; }
+    if (records != NULL) { *records = (unsigned long long)keptCount; }
+    return !failed;
+}
+
+// release the memory of a builder
+void FreeBookBuilder(BookBuilder* builder)
+{
+    free(builder->entries);
+    InitBookBuilder(builder);
+}
+
+// Lookup //
+
+// map the book "filename" and check its header
+int OpenBook(const char* filename, OpeningBook* book)
+{
+    book->records = NULL;
+    book->count = 0ull;
+
+    if (!MapFile(filename, &book->map)) { return 0; }
+
+    // qualifier: the header must be complete and match this format
+    if (book->map.size < BOOK_HEADER_BYTES || memcmp(book->map.data, bookMagic, sizeof(bookMagic)) != 0
+        || Read32(book->map.data + 8) != BOOK_RECORD_BYTES
+        || (book->map.size - BOOK_HEADER_BYTES) % BOOK_RECORD_BYTES != 0u)
+    {
+        UnmapFile(&book->map);
+        return 0;
+    }
+
+    book->records = book->map.data + BOOK_HEADER_BYTES;
+    book->count = (unsigned long long)((book->map.size - BOOK_HEADER_BYTES) / BOOK_RECORD_BYTES);
+    AdviseRandomAccess(&book->map);
+    return 1;
+}
+
+// fill "moves" with the book moves of "game", by most games first
+int LookupBook(const OpeningBook* book, const GameState* game, BookMove* moves, int maxMoves)
+{
+    unsigned long long low = 0ull; // first record that may hold the key
+    unsigned long long high = book->count; // one past the last record that may hold it
+    MoveList legal; // legal moves of "game", each record must be one of them
+    int found = 0; // moves stored in "moves"
+
+    // binary search for the first record whose key is not below the position's key
+    while (low < high)
+    {
+        unsigned long long middle = low + (high - low) / 2u; // record in the middle of the range
+
+        if (Read64(book->records + (size_t)middle * BOOK_RECORD_BYTES) < game->zobrist_key) { low = middle + 1u; }
+        else { high = middle; }
+    }
+
+    // qualifier: position not in the book
+    if (low == book->count || Read64(book->records + (size_t)low * BOOK_RECORD_BYTES) != game->zobrist_key) { return 0; }
+
+    GenerateMoves(game, &legal);
+    for (; low < book->count && found < maxMoves; low++)
+    {
+        const unsigned char* record = book->records + (size_t)low * BOOK_RECORD_BYTES; // current record
+        int i = 0; // loop iterator for the legal moves
+
+        if (Read64(record) != game->zobrist_key) { break; }
+
+        // qualifier: only legal moves are returned, this also catches key collisions
+        for (i = 0; i < legal.count; i++)
+        {
+            if (legal.moves[i].from == record[8] && legal.moves[i].to == record[9]) { break; }
+        }
+        if (i == legal.count) { continue; }
+
+        moves[found].move = legal.moves[i];
+        moves[found].wins = Read16(record + 10);
+        moves[found].draws = Read16(record + 12);
+        moves[found].losses = Read16(record + 14);
+        moves[found].weight = 2u * moves[found].wins + moves[found].draws;
+        found++;
+    }
+    return found;
+}
+
+// choose a book move for "game", weighted by its points
+int ChooseBookMove(const OpeningBook* book, const GameState* game, unsigned long long random, BookMove* chosen)
+{
+    BookMove moves[MAX_MOVES]; // book moves of the position
+    unsigned long long total = 0ull; // sum of every weight
+    int count = LookupBook(book, game, moves, MAX_MOVES); // moves found
+    int i = 0; // loop iterator for the book moves
+
+    for (i = 0; i < count; i++) { total += moves[i].weight; }
+
+    // qualifier: not in the book, or every book move only lost
+    if (total == 0ull) { return 0; }
+
+    random %= total;
+    for (i = 0; i < count; i++)
+    {
+        if (random < moves[i].weight) { break; }
+        random -= moves[i].weight;
+    }
+
+    *chosen = moves[i];
+    return 1;
+}
+
+// release the mapping of a book opened by OpenBook
+void CloseBook(OpeningBook* book)
+{
+    UnmapFile(&book->map);
+    book->records = NULL;
+    book->count = 0ull;
+}
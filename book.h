@@ -0,0 +1,126 @@
+// [book.h] header file
+// function declarations for "book.c"
+// implemented in "booktool.c" / "main.c"
+
+#ifndef BOOK_H
+#define BOOK_H
+
+#include <stddef.h> // for size_t (builder table)
+
+#include "game.h" // implement GameState structure
+#include "movegen.h" // implement Move structure
+#include "mapfile.h" // implement MappedFile structure
+
+// { Phase 4 - Opening Book } //
+// every game starts from the SetBoard position, so the first moves are
+// looked up in a book built from finished games instead of being searched again
+
+/*
+    The builder replays every game from SetBoard and counts, for each
+    (position, move) pair seen in the first plies, how often the player
+    who made the move went on to win, draw or lose. The position is
+    identified by its Zobrist key (see "zobrist.h").
+
+    File layout, every number little-endian:
+
+        header, BOOK_HEADER_BYTES (16) bytes:
+            bytes 0-7    magic text "BBCKBK01"
+            bytes 8-11   record size (BOOK_RECORD_BYTES)
+            bytes 12-15  reserved (0)
+
+        records, BOOK_RECORD_BYTES (16) bytes each, sorted by key,
+        the moves of one position by most games first:
+            bytes 0-7    Zobrist key of the position before the move
+            byte  8      FROM square (0-63)
+            byte  9      TO square (0-63, final landing square of a capture)
+            bytes 10-11  wins   of the player making the move
+            bytes 12-13  draws
+            bytes 14-15  losses
+
+    The reader maps the file and finds the first record of a position with
+    a binary search, O(log n) for any book size without reading the file.
+    Each record is checked against the legal moves of the position, so a
+    key collision can never produce an illegal move. Counts above 65535
+    are scaled down together, so the ratios stay the same.
+
+    A book move is chosen at random, weighted by the points it scored
+    (2 for a win, 1 for a draw), so the computer opponent varies its
+    openings but prefers the moves that did well. Moves that only lost
+    are never chosen.
+*/
+
+// size of the file header and of one record, in bytes
+#define BOOK_HEADER_BYTES 16
+#define BOOK_RECORD_BYTES 16
+
+// plies from the start position the builder keeps by default
+#define BOOK_DEFAULT_PLIES 16
+
+// result of a game given to the builder, same numbers as CheckWinner
+#define BOOK_RESULT_DRAW 0 // drawn game
+#define BOOK_RESULT_RED 1 // Player 1 (Red) won
+#define BOOK_RESULT_BLACK 2 // Player 2 (Black) won
+
+// one book move of a position, filled by LookupBook
+typedef struct
+{
+    Move move; // the legal move, as produced by GenerateMoves
+    unsigned int wins; // games won by the player making the move
+    unsigned int draws; // games drawn
+    unsigned int losses; // games lost
+    unsigned int weight; // 2 * wins + draws, chance of being chosen
+} BookMove;
+
+// statistics of one (position, move) pair while the book is built, see "book.c"
+typedef struct BookEntry BookEntry;
+
+// collects the moves of many games in memory before the book is written
+typedef struct
+{
+    BookEntry* entries; // open addressing hash table of (key, move) pairs
+    size_t capacity; // slots in "entries", a power of 2
+    size_t count; // slots in use
+    int failed; // flagger set if the table could not grow (out of memory)
+} BookBuilder;
+
+// start an empty builder
+void InitBookBuilder(BookBuilder* builder);
+
+// count "move" played in "game" in a game that ended with "result" (BOOK_RESULT_*)
+// returns 1 on success, 0 if the table ran out of memory
+int AddBookMove(BookBuilder* builder, const GameState* game, const Move* move, int result);
+
+// write every pair played in at least "minGames" games as a book file "filename"
+// "positions" / "records" (may be NULL) receive the positions and records written
+// returns 1 on success, 0 if the file could not be written or memory ran out
+int WriteBook(const BookBuilder* builder, const char* filename, unsigned int minGames,
+    unsigned long long* positions, unsigned long long* records);
+
+// release the memory of a builder
+void FreeBookBuilder(BookBuilder* builder);
+
+// a book opened for reading, the records stay inside the file mapping
+typedef struct
+{
+    MappedFile map; // whole file, mapped read-only
+    const unsigned char* records; // first record (inside "map")
+    unsigned long long count; // number of records
+} OpeningBook;
+
+// map the book "filename" and check its header
+// returns 1 on success, 0 if the file is missing, has no valid header,
+// or ends with a partial record
+int OpenBook(const char* filename, OpeningBook* book);
+
+// fill "moves" (room for "maxMoves") with the book moves of "game", by most games first
+// returns the number of moves found, 0 if the position is not in the book
+int LookupBook(const OpeningBook* book, const GameState* game, BookMove* moves, int maxMoves);
+
+// choose a book move for "game", weighted by its points, "random" is any 64-bit random number
+// returns 1 and fills "chosen", 0 if no book move of the position scored any points
+int ChooseBookMove(const OpeningBook* book, const GameState* game, unsigned long long random, BookMove* chosen);
+
+// release the mapping of a book opened by OpenBook
+void CloseBook(OpeningBook* book);
+
+#endif
@@ -0,0 +1,346 @@
+// [booktool.c] file
+
+#include <stdio.h> // for printing and reading game records
+#include <stdlib.h> // for atoi / malloc / free
+#include <string.h> // for comparing arguments and tokens
+#include <time.h> // for timespec_get (build time)
+
+#include "booktool.h" // declare "booktool" methods
+#include "book.h" // book builder and lookup
+#include "filewalk.h" // WalkFiles for directories of game records
+#include "game.h" // SetBoard / CheckWinner / CheckLegalMoves
+#include "movegen.h" // MoveFromText / MoveToText / ApplyMove
+#include "saveload.h" // ReadGameFile for "bookprobe"
+#include "gamerecord.h" // ReadFen for the [FEN] start of a record
+
+// longest token read from a game record, longer tokens are reported as illegal moves
+// (a [FEN] value with 24 pieces, all of them kings, still fits)
+#define TOKEN_MAX 128
+
+// most plies "--plies" accepts
+#define BOOKBUILD_MAX_PLIES 1000
+
+// result token "*", the game is unfinished (next to the BOOK_RESULT_* numbers)
+#define RESULT_UNFINISHED 3
+
+// state shared by the "bookbuild" file visitor
+typedef struct
+{
+    BookBuilder builder; // moves counted so far
+    int maxPlies; // plies from the start position that are counted
+    GameState* positions; // position before each counted ply of the current game
+    Move* moves; // each counted ply of the current game
+    unsigned long long games; // finished games counted
+    unsigned long long unfinished; // games left out without a result
+    unsigned long long illegal; // games left out because of an illegal move
+    int unreadable; // files that could not be opened
+} BookRun;
+
+// one game record being read
+typedef struct
+{
+    GameState game; // position after the moves read so far
+    int plies; // moves read so far
+    int broken; // flagger set after an illegal move, the rest of the game is skipped
+} RecordGame;
+
+// method to read the wall clock in seconds
+static double WallSeconds(void)
+{
+    struct timespec now; // current wall clock time
+    timespec_get(&now, TIME_UTC);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+// method to read the next whitespace separated token of "file" into "token" (holds TOKEN_MAX characters)
+// "#" comments are skipped, "line" counts the lines read
+// returns 1 if a token was read, 0 at the end of the file
+static int ReadToken(FILE* file, char* token, int* line)
+{
+    int length = 0; // characters stored in "token"
+    int c = fgetc(file); // current character
+
+    // skip whitespace and comments before the token
+    while (c != EOF)
+    {
+        if (c == '#')
+        {
+            while (c != EOF && c != '\n') { c = fgetc(file); }
+            continue;
+        }
+        if (c == '\n') { (*line)++; }
+        else if (c != ' ' && c != '\t' && c != '\r') { break; }
+        c = fgetc(file);
+    }
+    if (c == EOF) { return 0; }
+
+    // qualifier: a token ends at whitespace or a comment, the extra characters of a long token are dropped
+    while (c != EOF && c != ' ' && c != '\t' && c != '\r' && c != '\n' && c != '#')
+    {
+        if (length < TOKEN_MAX - 1) { token[length++] = (char)c; }
+        c = fgetc(file);
+    }
+    if (c != EOF) { ungetc(c, file); }
+
+    token[length] = '\0';
+    return 1;
+}
+
+// method to start a new game record from the SetBoard position
+static void StartRecordGame(RecordGame* record)
+{
+    SetBoard(&record->game);
+    record->plies = 0;
+    record->broken = 0;
+}
+
+// method to count the finished game "record" with "result" (BOOK_RESULT_*) in the builder
+static void FinishRecordGame(BookRun* run, const RecordGame* record, int result)
+{
+    int counted = (record->plies < run->maxPlies) ? record->plies : run->maxPlies; // plies kept
+    int ply = 0; // loop iterator for the kept plies
+
+    for (ply = 0; ply < counted; ply++) { AddBookMove(&run->builder, &run->positions[ply], &run->moves[ply], result); }
+    run->games++;
+}
+
+// method to read one game record file found by WalkFiles, "context" is the BookRun
+static void BuildFile(const char* path, void* context)
+{
+    BookRun* run = (BookRun*)context; // builder and counters
+    RecordGame record; // game being read
+    char token[TOKEN_MAX]; // current token
+    int line = 1; // line of the current token
+    FILE* file = fopen(path, "r"); // game record file
+
+    if (file == NULL)
+    {
+        fprintf(stderr, "Could not open game record, skipped: %s\n", path);
+        run->unreadable++;
+        return;
+    }
+
+    StartRecordGame(&record);
+    while (ReadToken(file, token, &line))
+    {
+        int result = -1; // result token, -1 when the token is a move
+        size_t length = strlen(token); // characters in the token
+        Move move; // move read from the token
+
+        if (strcmp(token, "1-0") == 0) { result = BOOK_RESULT_RED; }
+        else if (strcmp(token, "0-1") == 0) { result = BOOK_RESULT_BLACK; }
+        else if (strcmp(token, "1/2-1/2") == 0) { result = BOOK_RESULT_DRAW; }
+        else if (strcmp(token, "*") == 0) { result = RESULT_UNFINISHED; }
+
+        // qualifier: a result ends the game, an unfinished or broken game is left out
+        if (result >= 0)
+        {
+            if (record.broken) { run->illegal++; }
+            else if (result == RESULT_UNFINISHED) { run->unfinished++; }
+            else { FinishRecordGame(run, &record, result); }
+            StartRecordGame(&record);
+            continue;
+        }
+
+        // qualifier: a [FEN "..."] tag before the first move replaces the SetBoard start
+        if (strcmp(token, "[FEN") == 0)
+        {
+            GameState start; // position read from the tag
+            int closed = 0; // flagger set if the value ends with the closing quote and bracket
+
+            if (!ReadToken(file, token, &line)) { token[0] = '\0'; }
+            length = strlen(token);
+            if (length >= 3 && token[length - 1] == ']' && token[length - 2] == '"')
+            {
+                token[length - 2] = '\0';
+                closed = 1;
+            }
+            if (record.broken) { continue; }
+            if (record.plies > 0 || !closed || token[0] != '"' || !ReadFen(token + 1, &start))
+            {
+                fprintf(stderr, "%s:%d: invalid FEN tag (ply %d), game left out\n", path, line, record.plies + 1);
+                record.broken = 1;
+                continue;
+            }
+            record.game = start;
+            continue;
+        }
+
+        // qualifier: move numbers ("12.") and the moves after an illegal one are skipped
+        if (token[length - 1] == '.' || record.broken) { continue; }
+
+        if (!MoveFromText(&record.game, token, &move))
+        {
+            fprintf(stderr, "%s:%d: illegal move \"%s\" (ply %d), game left out\n", path, line, token, record.plies + 1);
+            record.broken = 1;
+            continue;
+        }
+
+        if (record.plies < run->maxPlies)
+        {
+            run->positions[record.plies] = record.game;
+            run->moves[record.plies] = move;
+        }
+        ApplyMove(&record.game, &move);
+        record.plies++;
+    }
+
+    // qualifier: a game still open at the end of the file counts only if it is already decided
+    if (record.broken) { run->illegal++; }
+    else if (record.plies > 0)
+    {
+        int winner = CheckWinner(&record.game); // player with pieces left, 0 if both have some
+
+        if (winner == 0 && !CheckLegalMoves(&record.game)) { winner = 3 - record.game.current_turn; }
+        if (winner != 0) { FinishRecordGame(run, &record, winner); }
+        else { run->unfinished++; }
+    }
+    fclose(file);
+}
+
+// run the "bookbuild" command
+int RunBookBuild(int argc, char* argv[])
+{
+    BookRun run; // builder and counters
+    unsigned long long positions = 0ull; // positions written
+    unsigned long long records = 0ull; // records written
+    int minGames = 1; // fewest games a written move needs
+    double start = 0.0; // wall clock at the start
+    int argument = 0; // loop iterator for the arguments
+    int written = 0; // flagger set if the book was written
+    int i = 0; // loop iterator for the game record paths
+
+    run.maxPlies = BOOK_DEFAULT_PLIES;
+
+    // read the options, they come before the book name
+    while (argument < argc && strncmp(argv[argument], "--", 2) == 0)
+    {
+        if (strcmp(argv[argument], "--plies") == 0 && argument + 1 < argc)
+        {
+            run.maxPlies = atoi(argv[argument + 1]);
+            argument += 2;
+        }
+        else if (strcmp(argv[argument], "--min-games") == 0 && argument + 1 < argc)
+        {
+            minGames = atoi(argv[argument + 1]);
+            argument += 2;
+        }
+        else { break; }
+    }
+
+    // qualifier: a book name and at least one game record are required
+    if (argc - argument < 2 || run.maxPlies < 1 || run.maxPlies > BOOKBUILD_MAX_PLIES || minGames < 1)
+    {
+        printf("Usage: bitboardcheckers bookbuild [--plies N] [--min-games N] <book> <dir|files...>\n");
+        printf("       --plies between 1 and %d, --min-games at least 1\n", BOOKBUILD_MAX_PLIES);
+        return 1;
+    }
+
+    run.positions = (GameState*)malloc((size_t)run.maxPlies * sizeof(GameState));
+    run.moves = (Move*)malloc((size_t)run.maxPlies * sizeof(Move));
+    if (run.positions == NULL || run.moves == NULL)
+    {
+        printf("Not enough memory.\n");
+        free(run.positions);
+        free(run.moves);
+        return 1;
+    }
+    InitBookBuilder(&run.builder);
+    run.games = 0ull;
+    run.unfinished = 0ull;
+    run.illegal = 0ull;
+    run.unreadable = 0;
+
+    start = WallSeconds();
+    for (i = argument + 1; i < argc; i++) { run.unreadable += WalkFiles(argv[i], BuildFile, &run); }
+    written = WriteBook(&run.builder, argv[argument], (unsigned int)minGames, &positions, &records);
+
+    printf("Games: %llu counted, %llu unfinished, %llu with an illegal move\n", run.games, run.unfinished, run.illegal);
+    if (written)
+    {
+        printf("Book: %llu positions, %llu moves written to %s (%.2f s)\n", positions, records, argv[argument],
+            WallSeconds() - start);
+    }
+    else if (run.builder.failed) { printf("Not enough memory for the book.\n"); }
+    else { printf("Could not write the book: %s\n", argv[argument]); }
+
+    FreeBookBuilder(&run.builder);
+    free(run.positions);
+    free(run.moves);
+    return (written && run.unreadable == 0 && run.illegal == 0ull) ? 0 : 1;
+}
+
+// method to print the book moves of "game", "name" labels the position
+static void PrintBookMoves(const OpeningBook* book, const GameState* game, const char* name)
+{
+    BookMove moves[MAX_MOVES]; // book moves of the position
+    int count = LookupBook(book, game, moves, MAX_MOVES); // moves found
+    unsigned int total = 0u; // sum of every weight
+    int i = 0; // loop iterator for the book moves
+
+    if (count == 0)
+    {
+        printf("%s: not in the book\n", name);
+        return;
+    }
+
+    for (i = 0; i < count; i++) { total += moves[i].weight; }
+    printf("%s: %d book move%s\n", name, count, (count == 1) ? "" : "s");
+    for (i = 0; i < count; i++)
+    {
+        char text[64]; // move as text
+        double chance = (total > 0u) ? 100.0 * moves[i].weight / total : 0.0; // chance of being played
+
+        printf("  %-12s %6u games  %6u wins %6u draws %6u losses  played %5.1f%%\n",
+            MoveToText(&moves[i].move, text, (int)sizeof(text)), moves[i].wins + moves[i].draws + moves[i].losses,
+            moves[i].wins, moves[i].draws, moves[i].losses, chance);
+    }
+}
+
+// run the "bookprobe" command
+int RunBookProbe(int argc, char* argv[])
+{
+    OpeningBook book; // mapped book
+    int failed = 0; // save files that could not be read
+    int i = 0; // loop iterator for the save files
+
+    // qualifier: a book is required
+    if (argc < 1)
+    {
+        printf("Usage: bitboardcheckers bookprobe <book> [savefiles...]\n");
+        return 1;
+    }
+
+    if (!OpenBook(argv[0], &book))
+    {
+        printf("Could not open the book: %s\n", argv[0]);
+        return 1;
+    }
+    printf("Book: %llu moves\n", book.count);
+
+    // qualifier: without save files, look the start position up
+    if (argc == 1)
+    {
+        GameState game; // start position
+
+        SetBoard(&game);
+        PrintBookMoves(&book, &game, "start position");
+    }
+
+    for (i = 1; i < argc; i++)
+    {
+        GameState game; // position to look up
+        int errorLine = 0; // first invalid line of the file
+
+        if (!ReadGameFile(argv[i], &game, &errorLine))
+        {
+            printf("%s: could not read the save file\n", argv[i]);
+            failed++;
+            continue;
+        }
+        PrintBookMoves(&book, &game, argv[i]);
+    }
+
+    CloseBook(&book);
+    return (failed == 0) ? 0 : 1;
+}
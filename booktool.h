@@ -0,0 +1,51 @@
+// [booktool.h] header file
+// function declarations for "booktool.c"
+// implemented in "main.c"
+
+#ifndef BOOKTOOL_H
+#define BOOKTOOL_H
+
+// { Phase 4 - Opening Book } //
+// command line builder and lookup for the opening book (see "book.h")
+
+/*
+    Usage:
+        ./bitboardcheckers bookbuild [--plies N] [--min-games N] <book> <dir|files...>
+            read every game record (folders include their sub-folders) and
+            write the moves of their first N plies (default 16) into <book>
+            --min-games N   leave out moves played in fewer than N games (default 1)
+
+        ./bitboardcheckers bookprobe <book> [savefiles...]
+            print the book moves of each 5-line save file, or of the start
+            position when no save file is given
+
+    Game record files are plain text, every game is played from SetBoard:
+
+        # comment until the end of the line
+        1. 21-28 42-35 2. 28x42 51x33 ... 1-0
+
+    Moves are written as MoveToText prints them ("FROM-TO", "FROMxLANDx...",
+    see "movegen.h"), a capture may also be shortened to "FROMxTO". Move
+    numbers ("1.") are skipped. A game ends with its result:
+
+        1-0       Player 1 (Red) won
+        0-1       Player 2 (Black) won
+        1/2-1/2   draw
+        *         unfinished, the game is left out
+
+    A game without a result at the end of the file counts when its last
+    position is already won (no pieces or no legal moves for the player to
+    move), otherwise it is left out. A game with an illegal move is
+    reported with its file and line and left out.
+*/
+
+// run the "bookbuild" command, "argc" / "argv" are the arguments after "bookbuild"
+// returns 0 on success, 1 on a usage error, if the book could not be written,
+// or if any file could not be read or held an illegal move
+int RunBookBuild(int argc, char* argv[]);
+
+// run the "bookprobe" command, "argc" / "argv" are the arguments after "bookprobe"
+// returns 0 on success, 1 on a usage error or if the book or a save file could not be read
+int RunBookProbe(int argc, char* argv[]);
+
+#endif
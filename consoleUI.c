@@ -5,6 +5,7 @@
 #include <stdlib.h> // for parsing integers from user input
 
 #include "consoleUI.h" // declare "consoleUI" and "game" variables/methods
+#include "render.h" // buffered board text for PrintReferenceBoard
 
 // print the program banner the first time program runs
 void PrintTitle(void) 
@@ -23,7 +24,11 @@ void DisplayMenu(void)
     printf("5 - Bit Operations Demo (Phase 1 - Test Functions)\n");
     printf("6 - How To Play\n");
     printf("7 - New Game (Reset Board)\n");
-    printf("8 - Exit\n");
+    printf("8 - Play vs Computer (On/Off)\n");
+    printf("9 - Exit\n");
+    printf("10 - Undo Move\n");
+    printf("11 - Redo Move\n");
+    printf("12 - Move History (go to a move)\n");
     printf("-----------------------------------\n");
     printf("Enter option number: ");
 }
@@ -133,13 +138,20 @@ void PrintInstructions(void)
     printf("    - Capture: Jump diagonally over an adjacent opponent piece onto an empty dark square.\n");
     printf("      Make sure to input the number you're jumping to, which is over the opposing player piece.\n");
     printf("      (Ex: \"b\" initially on (FROM) index 40, will jump TO index 26, capturing the \"r\" piece on index 33)\n");
-    printf("      * Normally, men and kings can perform multiple captures, but in this version,\n");
-    printf("        capture only works for 1 piece (single-capture only), for men and kings.\n\n");
+    printf("      * Captures are mandatory! If any of your pieces can jump, you must capture.\n");
+    printf("      * Multiple captures: if the piece can keep jumping it must continue. Enter the FINAL\n");
+    printf("        landing square as TO and every piece along the way is captured.\n");
+    printf("        A man that reaches the far edge during a capture is promoted and its move ends.\n\n");
     printf("    - King Promotion: A player that reaches the far edge is promoted to KING (\"r\" -> \"R\" or \"b\" -> \"B\")\n");
     printf("      and can move both ways.\n\n");
+    printf("- Play vs Computer: Option 8 turns the computer opponent on or off. You keep the side\n");
+    printf("  whose turn it is and the computer replies to each of your moves right away.\n\n");
     printf("- Win Condition: When all opposing player pieces are captured OR a player has no legal moves left.\n");
     printf("- Save and Load functions use a simple text file containing the game state. Enter the string name of\n");
     printf("  your save file when you save. When loading, type the save file exactly as typed.\n");
+    printf("  The moves of the game are saved next to it as \"<name>.pdn\" and come back when it is loaded.\n");
+    printf("- Undo / Redo: Options 10 and 11 take the last move back or play it again, option 12 lists\n");
+    printf("  every move and jumps to the one you enter. Against the computer they skip over its reply.\n");
     printf("======================================================\n");
 }
 
@@ -166,42 +178,13 @@ void PrintWhoseTurn(const GameState* game)
 // helps to reference what index you're piece is on and where to move
 void PrintReferenceBoard(void) 
 {
-    int row = 0; // row index for printing
+    char frame[RENDER_REFERENCE_SIZE]; // text of the whole reference board
+    RenderBuffer buffer; // frame being built
 
-    printf("===============================\n");
-    printf("{Bit Board Checkers Reference}\n");
-    printf("Use this board to refer to your positions\n\n");
-    printf("\tColumns 0 - 7 \n");
-
-    // print each row with its corresponding index
-    for (row = 0; row < 8; row++) 
-    {
-        int col = 0; // column index for printing
-        int base = row * 8; // base index for the row, used to calculate each column index
-        printf("Row %d: ", row);
-
-        // print each column index
-        for (col = 0; col < 8; col++) 
-        {
-            int index = base + col; // calculate the index for this column
-            
-            // qualifier: column 0 prints without leading space
-            if (col == 0) 
-            {
-                // index formatted to width 2 for alignment
-                printf("%2d", index);
-            }
-
-            // qualifier: column 1-7 prints with leading space
-            else
-            {
-                // index formatted to width 2 for alignment
-                printf(" %2d", index);
-            }
-        }
-        printf("\n");
-    }
-    printf("===============================\n\n");
+    // build the reference board in memory, then send it with one write
+    RenderInit(&buffer, frame, sizeof(frame));
+    RenderReferenceBoard(&buffer);
+    RenderPrint(&buffer, stdout);
 }
 
 // print “Player 1 (Red)” or “Player 2 (Black)”
@@ -228,4 +211,36 @@ void PrintMoveText(int player, int fromPosition, int toPosition)
     PrintPlayerText(player); // print the current player
     // indicate player movement using FROM and TO positions indexes
     printf(" Moved FROM %d TO %d.\n", fromPosition, toPosition);
+}
+
+// print what happened during a move, from the record filled by TryMove / MakeMove
+// one line for every piece captured (in jump order) and one line if promoted to KING
+void PrintMoveResult(const MoveRecord* record) 
+{
+    int previous = record->move.from; // square the current jump started from
+    int i = 0; // loop iterator for the jumps of a capture chain
+
+    // announce each jump of the chain, the jumped square sits halfway between landings
+    for (i = 0; i < record->move.jumps; i++) 
+    {
+        int jumped = (previous + record->move.path[i]) / 2; // square jumped over
+
+        // qualifier: the capturing player decides which message is printed
+        if (record->player == 1) 
+        {
+            printf("Player 1 (Red) captured Player 2 (Black)! Jumping over position %d.\n", jumped);
+        }
+        else 
+        {
+            printf("Player 2 (Black) captured Player 1 (Red)! Jumping over position %d.\n", jumped);
+        }
+        previous = record->move.path[i];
+    }
+
+    // qualifier: announce a promotion on the far row
+    if (record->promoted) 
+    {
+        PrintPlayerText(record->player);
+        printf(" piece promoted to KING at position %d.\n", record->move.to);
+    }
 }
\ No newline at end of file
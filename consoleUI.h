@@ -6,6 +6,7 @@
 #define CONSOLEUI_H
 
 #include "game.h" // implement GameState strucutre
+#include "movegen.h" // implement MoveRecord structure
 
 // { Phase 2 -  Checkers Game Implementation } //
 // Implement additional UI to support the required game functions
@@ -62,4 +63,8 @@ void PrintPlayerText(int player);
 // and enters a unoccupied and fair dark square (#) (TO)
 void PrintMoveText(int player, int fromPosition, int toPosition);
 
+// print what happened during a move, from the record filled by TryMove / MakeMove
+// one line for every piece captured (in jump order) and one line if promoted to KING
+void PrintMoveResult(const MoveRecord* record);
+
 #endif
\ No newline at end of file
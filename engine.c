@@ -0,0 +1,484 @@
+// [engine.c] file
+
+#include <stdio.h> // for reading commands and printing answers
+#include <stdlib.h> // for atoi / strtoull
+#include <errno.h> // for ERANGE from strtoull (limits of "go")
+#include <limits.h> // for INT_MAX (limits of "go")
+#include <string.h> // for comparing commands
+#include <stdarg.h> // for the formatted answers
+#include <stdatomic.h> // for the stop flag of the worker
+#include <pthread.h> // for the search worker thread
+#include <time.h> // for time (seed of the book move choice)
+
+#include "engine.h" // declare "engine" methods
+#include "game.h" // SetBoard / PositionProblem
+#include "movegen.h" // GenerateMoves / MoveFromText / MoveToText
+#include "search.h" // SearchBestMove on the worker thread
+#include "tt.h" // transposition table kept between searches
+#include "tablebase.h" // optional endgame tablebase
+#include "zobrist.h" // ComputeZobristKey for "position"
+#include "evaluate.h" // ComputeEvalTerms for "position", weight files
+#include "book.h" // opening book probed before every search ("--book")
+#include "stats.h" // game core counters for "stats"
+
+// transposition table size without "--hash", in MB
+#define ENGINE_DEFAULT_HASH_MB 16
+
+// longest command line read, a "position" with a few hundred moves fits
+#define ENGINE_LINE_MAX 16384
+
+// state of the engine, shared by the reading thread and the search worker
+typedef struct
+{
+    GameState position; // position set by "position" / "newgame"
+    GameState searched; // copy of "position" searched by the worker
+    SearchLimits limits; // limits of the running search
+    TranspositionTable table; // table kept between searches
+    int hasTable; // flagger for "table" being allocated
+    Tablebase tablebase; // endgame tablebase ("--tablebase")
+    int hasTablebase; // flagger for "tablebase" being open
+    EvalWeights weights; // evaluation weights ("--weights")
+    int hasWeights; // flagger for "weights" being read from a file, otherwise the defaults are used
+    OpeningBook book; // opening book ("--book")
+    int hasBook; // flagger for "book" being open
+    unsigned long long bookRandom; // state of the book move choice
+    int threads; // search threads ("--threads")
+    pthread_t worker; // thread running the search
+    int searching; // flagger for "worker" having to be joined (reading thread only)
+    int waitForStop; // flagger for "infinite" / "ponder": hold "bestmove" until "stop"
+    int infinite; // flagger for "infinite" being given to the running search
+    int pondering; // flagger for a running "go ponder" search, waiting for "ponderhit"
+    SearchLimits ponderLimits; // limits given to "go ponder", searched with once "ponderhit" arrives
+    int quiet; // flagger set to end the running search without its "bestmove" (reading thread only)
+    _Atomic int stop; // set by "stop" to end the search
+    pthread_mutex_t lock; // guards the output and "stopSignal"
+    pthread_cond_t stopSignal; // wakes a finished "infinite" search on "stop"
+} Engine;
+
+// method to print one answer line and flush it, the worker and the reading thread never mix lines
+static void Reply(Engine* engine, const char* format, ...)
+{
+    va_list arguments; // values for "format"
+
+    pthread_mutex_lock(&engine->lock);
+    va_start(arguments, format);
+    vprintf(format, arguments);
+    va_end(arguments);
+    printf("\n");
+    fflush(stdout);
+    pthread_mutex_unlock(&engine->lock);
+}
+
+// method called by the search after every finished depth, prints the "info" line
+static void ReportProgress(const SearchResult* result, void* context)
+{
+    Engine* engine = (Engine*)context; // engine answering
+    char text[1024]; // principal variation
+    double seconds = (result->seconds > 0.0) ? result->seconds : 1e-9; // avoid dividing by 0
+
+    Reply(engine, "info depth %d score %d nodes %llu time %d nps %.0f pv %s", result->depth, result->score,
+        result->nodes, (int)(result->seconds * 1000.0), (double)result->nodes / seconds,
+        PrincipalVariationText(result, text, (int)sizeof(text)));
+}
+
+// method run by the worker thread, searches "engine->searched" and prints "bestmove"
+static void* SearchWorker(void* argument)
+{
+    Engine* engine = (Engine*)argument; // engine answering
+    SearchResult result; // best move and principal variation
+    char best[64]; // best move as text
+    char ponder[64]; // expected reply as text
+    int found = SearchBestMove(&engine->searched, &engine->limits, &result); // flagger for a legal move
+
+    // qualifier: "infinite" / "ponder" answer only once they are told to stop
+    if (engine->waitForStop)
+    {
+        pthread_mutex_lock(&engine->lock);
+        while (!atomic_load(&engine->stop)) { pthread_cond_wait(&engine->stopSignal, &engine->lock); }
+        pthread_mutex_unlock(&engine->lock);
+    }
+
+    // qualifier: a ponder search ended by "ponderhit" is searched again, only that search answers
+    if (engine->quiet) { return NULL; }
+
+    if (!found) { Reply(engine, "bestmove none"); }
+    else if (result.pvLength > 1)
+    {
+        Reply(engine, "bestmove %s ponder %s", MoveToText(&result.bestMove, best, (int)sizeof(best)),
+            MoveToText(&result.pv[1], ponder, (int)sizeof(ponder)));
+    }
+    else { Reply(engine, "bestmove %s", MoveToText(&result.bestMove, best, (int)sizeof(best))); }
+    return NULL;
+}
+
+// method for the splitmix64 random number generator, advances "state" and returns the next number
+// only used to vary the book moves, the search itself is not random
+static unsigned long long NextRandom(unsigned long long* state)
+{
+    unsigned long long mixed = 0ull; // number being scrambled
+
+    *state = *state + 0x9E3779B97F4A7C15ull;
+    mixed = *state;
+    mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ull;
+    mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBull;
+    return mixed ^ (mixed >> 31);
+}
+
+// method to end the running search (if any) and wait until its "bestmove" is printed
+static void StopSearch(Engine* engine)
+{
+    if (!engine->searching) { return; }
+
+    pthread_mutex_lock(&engine->lock);
+    atomic_store(&engine->stop, 1);
+    pthread_cond_broadcast(&engine->stopSignal);
+    pthread_mutex_unlock(&engine->lock);
+
+    pthread_join(engine->worker, NULL);
+    engine->searching = 0;
+}
+
+// method to read a bitboard written in decimal or hex ("0x..."), returns 1 on success
+static int ReadBitboard(const char* text, unsigned long long* board)
+{
+    char* end = NULL; // character after the number
+
+    if (text == NULL) { return 0; }
+    *board = strtoull(text, &end, 0);
+    return end != text && *end == '\0';
+}
+
+// method for the "position" command, the words after "position" are read with strtok
+static void SetPosition(Engine* engine)
+{
+    GameState game; // position being built
+    char* word = strtok(NULL, " \t\r\n"); // first word after "position"
+    int ply = 0; // moves played after the position
+
+    // qualifier: "start" or the four bitboards and the turn
+    if (word != NULL && strcmp(word, "start") == 0) { SetBoard(&game); }
+    else
+    {
+        const char* problem = NULL; // why the position is not legal
+
+        memset(&game, 0, sizeof(game));
+        if (!ReadBitboard(word, &game.player1_men) || !ReadBitboard(strtok(NULL, " \t\r\n"), &game.player1_kings)
+            || !ReadBitboard(strtok(NULL, " \t\r\n"), &game.player2_men) || !ReadBitboard(strtok(NULL, " \t\r\n"), &game.player2_kings))
+        {
+            Reply(engine, "error position needs \"start\" or 4 bitboards and the turn");
+            return;
+        }
+        word = strtok(NULL, " \t\r\n");
+        if (word == NULL || (strcmp(word, "1") != 0 && strcmp(word, "2") != 0))
+        {
+            Reply(engine, "error position turn must be 1 (Red) or 2 (Black)");
+            return;
+        }
+        game.current_turn = atoi(word);
+        game.zobrist_key = ComputeZobristKey(&game);
+        ComputeEvalTerms(&game);
+
+        problem = PositionProblem(&game);
+        if (problem != NULL)
+        {
+            Reply(engine, "error position %s", problem);
+            return;
+        }
+    }
+
+    // qualifier: then the moves played from there
+    word = strtok(NULL, " \t\r\n");
+    if (word != NULL && strcmp(word, "moves") != 0)
+    {
+        Reply(engine, "error position expected \"moves\", got \"%s\"", word);
+        return;
+    }
+    while ((word = strtok(NULL, " \t\r\n")) != NULL)
+    {
+        Move move; // move read
+
+        ply++;
+        if (!MoveFromText(&game, word, &move))
+        {
+            Reply(engine, "error position illegal move \"%s\" (move %d)", word, ply);
+            return;
+        }
+        ApplyMove(&game, &move);
+    }
+    engine->position = game;
+}
+
+// method to read a limit of "go" into "value", a positive whole number up to "maximum"
+// returns 1 on success, 0 for anything else (signs, letters, 0, or too large)
+static int ReadLimit(const char* text, unsigned long long maximum, unsigned long long* value)
+{
+    char* end = NULL; // character after the number
+
+    if (text == NULL || text[0] < '0' || text[0] > '9') { return 0; }
+    errno = 0;
+    *value = strtoull(text, &end, 10);
+    return *end == '\0' && errno != ERANGE && *value > 0ull && *value <= maximum;
+}
+
+// method to start the worker on the current position with "engine->limits"
+// a position in the opening book is answered with a book move instead, unless "bestmove" has to wait for "stop"
+static void LaunchSearch(Engine* engine)
+{
+    // qualifier: a position in the opening book is answered with a book move and no search,
+    // except for "infinite" / "ponder", which have to wait for "stop" and are searched as usual
+    if (engine->hasBook && !engine->waitForStop)
+    {
+        BookMove bookMove; // move chosen from the opening book
+        char text[64]; // chosen move as text
+
+        if (ChooseBookMove(&engine->book, &engine->position, NextRandom(&engine->bookRandom), &bookMove))
+        {
+            MoveToText(&bookMove.move, text, (int)sizeof(text));
+            Reply(engine, "info book %s wins %u draws %u losses %u", text, bookMove.wins, bookMove.draws, bookMove.losses);
+            Reply(engine, "bestmove %s", text);
+            return;
+        }
+    }
+
+    engine->searched = engine->position;
+    engine->quiet = 0;
+    atomic_store(&engine->stop, 0);
+    if (pthread_create(&engine->worker, NULL, SearchWorker, engine) != 0)
+    {
+        Reply(engine, "error go could not start the search thread");
+        return;
+    }
+    engine->searching = 1;
+}
+
+// method for the "ponderhit" command: the expected move was played, so a "go ponder" search
+// goes on with the limits it was given, its time counted from now; ignored for any other search
+static void PonderHit(Engine* engine)
+{
+    if (!engine->searching || !engine->pondering) { return; }
+
+    // the ponder search ends without an answer, the table keeps what it found for the new search
+    engine->quiet = 1;
+    StopSearch(engine);
+    engine->pondering = 0;
+    engine->waitForStop = engine->infinite;
+    engine->limits = engine->ponderLimits;
+    LaunchSearch(engine);
+}
+
+// method for the "go" command, starts the worker on the current position
+static void StartSearch(Engine* engine)
+{
+    SearchLimits* limits = &engine->limits; // limits of the new search
+    char* word = NULL; // current word after "go"
+
+    limits->maxDepth = 0;
+    limits->timeLimitMs = 0;
+    limits->nodeLimit = 0ull;
+    limits->verbose = 0;
+    limits->table = engine->hasTable ? &engine->table : NULL;
+    limits->threads = engine->threads;
+    limits->tablebase = engine->hasTablebase ? &engine->tablebase : NULL;
+    limits->stop = &engine->stop;
+    limits->progress = ReportProgress;
+    limits->progressContext = engine;
+    limits->weights = engine->hasWeights ? &engine->weights : NULL;
+    engine->infinite = 0;
+    engine->pondering = 0;
+
+    while ((word = strtok(NULL, " \t\r\n")) != NULL)
+    {
+        unsigned long long value = 0ull; // number after "depth" / "movetime" / "nodes"
+        unsigned long long maximum = (strcmp(word, "nodes") == 0) ? ~0ull : (unsigned long long)INT_MAX; // largest value accepted
+
+        if (strcmp(word, "infinite") == 0) { engine->infinite = 1; continue; }
+        if (strcmp(word, "ponder") == 0) { engine->pondering = 1; continue; }
+
+        if (strcmp(word, "depth") != 0 && strcmp(word, "movetime") != 0 && strcmp(word, "nodes") != 0)
+        {
+            Reply(engine, "error go unknown limit \"%s\"", word);
+            return;
+        }
+        if (!ReadLimit(strtok(NULL, " \t\r\n"), maximum, &value))
+        {
+            Reply(engine, "error go %s needs a positive number", word);
+            return;
+        }
+        if (strcmp(word, "depth") == 0) { limits->maxDepth = (int)value; }
+        else if (strcmp(word, "movetime") == 0) { limits->timeLimitMs = (int)value; }
+        else { limits->nodeLimit = value; }
+    }
+    engine->waitForStop = engine->infinite || engine->pondering;
+
+    // qualifier: "ponder" keeps its limits for "ponderhit", until then it runs like "infinite"
+    if (engine->pondering) { engine->ponderLimits = *limits; }
+
+    // qualifier: "infinite" / "ponder" ignore the limits, they run until "stop"
+    if (engine->waitForStop)
+    {
+        limits->maxDepth = 0;
+        limits->timeLimitMs = 0;
+        limits->nodeLimit = 0ull;
+    }
+    LaunchSearch(engine);
+}
+
+// method for the "moves" command, prints every legal move of the current position
+static void PrintLegalMoves(Engine* engine)
+{
+    MoveList list; // legal moves
+    char line[MAX_MOVES * 48]; // "moves" and every move
+    int length = snprintf(line, sizeof(line), "moves"); // characters in "line"
+    int i = 0; // loop iterator for the moves
+
+    GenerateMoves(&engine->position, &list);
+    for (i = 0; i < list.count; i++)
+    {
+        char move[64]; // one move as text
+
+        MoveToText(&list.moves[i], move, (int)sizeof(move));
+        if (length + 1 + (int)strlen(move) >= (int)sizeof(line)) { break; }
+        length = length + snprintf(line + length, sizeof(line) - (size_t)length, " %s", move);
+    }
+    Reply(engine, "%s", line);
+}
+
+// run the "engine" command
+int RunEngine(int argc, char* argv[])
+{
+    Engine* engine = NULL; // engine state, large enough to keep off the stack
+    char* line = NULL; // current command line
+    int hashMb = ENGINE_DEFAULT_HASH_MB; // table size
+    const char* tablebaseFolder = NULL; // "--tablebase" folder, NULL for none
+    const char* weightsName = NULL; // "--weights" file, NULL for the default weights
+    const char* bookName = NULL; // "--book" file, NULL for none
+    int tablebaseCacheMb = TB_DEFAULT_CACHE_MB; // "--tbcache" size
+    int threads = 1; // "--threads" count
+    int running = 1; // flagger cleared by "quit"
+    int argument = 0; // loop iterator for the arguments
+
+    for (argument = 0; argument < argc; argument++)
+    {
+        if (argument + 1 < argc && strcmp(argv[argument], "--threads") == 0) { threads = atoi(argv[++argument]); }
+        else if (argument + 1 < argc && strcmp(argv[argument], "--hash") == 0) { hashMb = atoi(argv[++argument]); }
+        else if (argument + 1 < argc && strcmp(argv[argument], "--tablebase") == 0) { tablebaseFolder = argv[++argument]; }
+        else if (argument + 1 < argc && strcmp(argv[argument], "--tbcache") == 0) { tablebaseCacheMb = atoi(argv[++argument]); }
+        else if (argument + 1 < argc && strcmp(argv[argument], "--weights") == 0) { weightsName = argv[++argument]; }
+        else if (argument + 1 < argc && strcmp(argv[argument], "--book") == 0) { bookName = argv[++argument]; }
+        else { threads = 0; break; }
+    }
+
+    // qualifier: every option needs a sensible value
+    if (threads < 1 || threads > SEARCH_MAX_THREADS || hashMb < 0 || tablebaseCacheMb < 0)
+    {
+        printf("Usage: bitboardcheckers engine [--threads N] [--hash MB] [--tablebase DIR] [--tbcache MB] [--weights FILE]\n");
+        printf("                               [--book FILE]\n");
+        printf("       --threads between 1 and %d, --hash 0 searches without a table\n", SEARCH_MAX_THREADS);
+        return 1;
+    }
+
+    engine = (Engine*)calloc(1, sizeof(Engine));
+    line = (char*)malloc(ENGINE_LINE_MAX);
+    if (engine == NULL || line == NULL)
+    {
+        printf("Not enough memory.\n");
+        free(engine);
+        free(line);
+        return 1;
+    }
+    if (weightsName != NULL)
+    {
+        int errorLine = 0; // first invalid line of the weight file
+
+        // qualifier: a weight file that cannot be used is an error, not a silent fall back to the defaults
+        if (!LoadEvalWeights(weightsName, &engine->weights, &errorLine))
+        {
+            if (errorLine > 0) { printf("Invalid weight in %s, line %d.\n", weightsName, errorLine); }
+            else { printf("Could not read weight file %s.\n", weightsName); }
+            free(engine);
+            free(line);
+            return 1;
+        }
+        engine->hasWeights = 1;
+    }
+    if (bookName != NULL)
+    {
+        // qualifier: like the weights, a book that was asked for but cannot be read is an error
+        if (!OpenBook(bookName, &engine->book))
+        {
+            printf("Could not open the opening book: %s\n", bookName);
+            free(engine);
+            free(line);
+            return 1;
+        }
+        engine->hasBook = 1;
+        engine->bookRandom = (unsigned long long)time(NULL);
+    }
+    pthread_mutex_init(&engine->lock, NULL);
+    pthread_cond_init(&engine->stopSignal, NULL);
+    atomic_init(&engine->stop, 0);
+    engine->threads = threads;
+    engine->hasTable = (hashMb > 0) && TTInit(&engine->table, (size_t)hashMb);
+    if (tablebaseFolder != NULL)
+    {
+        engine->hasTablebase = (OpenTablebase(tablebaseFolder, (size_t)tablebaseCacheMb, &engine->tablebase) > 0);
+        if (!engine->hasTablebase) { CloseTablebase(&engine->tablebase); }
+    }
+    SetBoard(&engine->position);
+
+    Reply(engine, "id name Bit Board Checkers");
+
+    // read one command per line until "quit" or the end of the input
+    while (running && fgets(line, ENGINE_LINE_MAX, stdin) != NULL)
+    {
+        char* command = strtok(line, " \t\r\n"); // first word of the line
+
+        if (command == NULL) { continue; }
+
+        if (strcmp(command, "isready") == 0) { Reply(engine, "readyok"); }
+        else if (strcmp(command, "stop") == 0) { StopSearch(engine); }
+        else if (strcmp(command, "ponderhit") == 0) { PonderHit(engine); }
+        else if (strcmp(command, "quit") == 0) { running = 0; }
+        else if (strcmp(command, "position") == 0)
+        {
+            StopSearch(engine);
+            SetPosition(engine);
+        }
+        else if (strcmp(command, "newgame") == 0)
+        {
+            StopSearch(engine);
+            if (engine->hasTable) { TTClear(&engine->table); }
+            SetBoard(&engine->position);
+        }
+        else if (strcmp(command, "go") == 0)
+        {
+            StopSearch(engine);
+            StartSearch(engine);
+        }
+        else if (strcmp(command, "moves") == 0) { PrintLegalMoves(engine); }
+        else if (strcmp(command, "stats") == 0)
+        {
+            pthread_mutex_lock(&engine->lock);
+            printf("stats ");
+            PrintStats(stdout, STATS_FORMAT_JSON);
+            fflush(stdout);
+            pthread_mutex_unlock(&engine->lock);
+        }
+        else if (strcmp(command, "show") == 0)
+        {
+            Reply(engine, "position %llu %llu %llu %llu %d key %016llx", engine->position.player1_men, engine->position.player1_kings,
+                engine->position.player2_men, engine->position.player2_kings, engine->position.current_turn, engine->position.zobrist_key);
+        }
+        else { Reply(engine, "error unknown command \"%s\"", command); }
+    }
+
+    StopSearch(engine);
+    if (engine->hasTable) { TTFree(&engine->table); }
+    if (engine->hasTablebase) { CloseTablebase(&engine->tablebase); }
+    if (engine->hasBook) { CloseBook(&engine->book); }
+    pthread_cond_destroy(&engine->stopSignal);
+    pthread_mutex_destroy(&engine->lock);
+    free(engine);
+    free(line);
+    return 0;
+}
@@ -0,0 +1,70 @@
+// [engine.h] header file
+// function declarations for "engine.c"
+// implemented in "main.c"
+
+#ifndef ENGINE_H
+#define ENGINE_H
+
+// { Phase 4 - Engine Protocol } //
+// line protocol on stdin / stdout, so a GUI or a test harness can drive the
+// computer opponent without the menu and the ASCII boards
+
+/*
+    Usage:
+        ./bitboardcheckers engine [--threads N] [--hash MB] [--tablebase DIR] [--tbcache MB] [--weights FILE]
+                                   [--book FILE]
+
+    "--weights" reads the evaluation weights from a weight file (see "evaluate.h").
+    "--book" opens an opening book (see "book.h"): "go" in a book position is
+    answered with "info book M wins W draws D losses L" and "bestmove M"
+    without a search, except with "infinite" or "ponder".
+
+    The engine prints "id name Bit Board Checkers" and then reads one command
+    per line. Every answer is one line, flushed straight away. Moves use the
+    notation the computer prints ("21-28", "28x42", "10x28x46", see
+    "movegen.h"), a capture may be shortened to "FROMxTO" when unique.
+
+        isready                      answers "readyok", also while searching
+        newgame                      clears the table, back to the start position
+        position start [moves M...]  start position, then the moves given
+        position <red men> <red kings> <black men> <black kings> <turn> [moves M...]
+                                     bitboards as in a save file (decimal, or hex
+                                     with "0x"), turn 1 (Red) or 2 (Black)
+        show                         answers "position <bitboards> <turn> key <hex>"
+        moves                        answers "moves M M ..." (legal moves, may be empty)
+        stats                        answers "stats {...}", the game core counters as JSON
+                                     ({"enabled":false} unless built with "make STATS=1")
+        go [depth D] [movetime MS] [nodes N] [infinite] [ponder]
+                                     starts searching the current position, every
+                                     limit is a whole number above 0
+        stop                         ends the search, its "bestmove" comes first
+        ponderhit                    the expected move was played: a "go ponder"
+                                     search goes on with the limits it was given
+                                     (time counted from "ponderhit"), ignored for
+                                     any other search
+        quit                         ends the search and the program
+
+    While searching, the engine prints one line per finished depth:
+
+        info depth D score S nodes N time MS nps N pv M M ...
+
+    and finally "bestmove M", followed by "ponder M" when the expected reply
+    is known, or "bestmove none" when the player to move has no legal move.
+    A search with "infinite" prints its "bestmove" only after "stop", even if
+    it finished earlier. "ponder" searches without limits in the same way until
+    "stop" or "ponderhit"; after "ponderhit" the position is searched again with
+    the limits, the table keeps what the ponder search found, and only that
+    search answers (with "infinite" as well it still waits). A search without any
+    limit runs until "stop" but answers as soon as it ends by itself.
+
+    The search runs on a worker thread while this thread keeps reading, so
+    "stop" and "isready" are answered at once. "position", "newgame", "go"
+    and "quit" end a running search first. Problems are answered with
+    "error <description>" and the command is ignored.
+*/
+
+// run the "engine" command, "argc" / "argv" are the arguments after "engine"
+// returns 0 after "quit" or the end of the input, 1 on a usage error
+int RunEngine(int argc, char* argv[]);
+
+#endif
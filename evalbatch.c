@@ -0,0 +1,332 @@
+// [evalbatch.c] file
+
+// note: the AVX2 backend is compiled with a function "target" attribute, so the
+// rest of the program keeps the default flags and still runs on any x86 processor
+
+#include <stdlib.h> // for malloc / free of the batch arrays
+
+#include "evalbatch.h" // declare "evalbatch" structures and methods
+#include "bitoperations.h" // PopCount64 for the scalar backend
+#include "movetables.h" // dark-square mask
+
+// AVX2 backend: GCC / Clang on x86, selected at run time with __builtin_cpu_supports
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    #define EVALBATCH_AVX2 1
+    #include <immintrin.h> // AVX2 intrinsics
+#endif
+
+// every square except column 0 / column 7 (steps that would wrap around the board edge)
+#define NOT_COL_0 0xFEFEFEFEFEFEFEFEull
+#define NOT_COL_7 0x7F7F7F7F7F7F7F7Full
+
+// rows 1-6, the only rows a man can stand on and still count for advancement
+#define ROWS_1_TO_6 0x00FFFFFFFFFFFF00ull
+
+// row number bit planes: a square is in ROW_BIT_n when bit "n" of its row (0-7) is set
+// so the rows of a set of men add up to count(ROW_BIT_0) + 2 * count(ROW_BIT_1) + 4 * count(ROW_BIT_2)
+#define ROW_BIT_0 0xFF00FF00FF00FF00ull
+#define ROW_BIT_1 0xFFFF0000FFFF0000ull
+#define ROW_BIT_2 0xFFFFFFFF00000000ull
+
+// Batch Memory //
+
+// allocate "batch" for up to "capacity" positions, starts empty
+// returns 1 on success, 0 if the memory could not be allocated
+int InitPositionBatch(PositionBatch* batch, int capacity)
+{
+    size_t boards = (size_t)capacity * sizeof(unsigned long long); // bytes of one bitboard array
+
+    batch->count = 0;
+    batch->capacity = capacity;
+    batch->redMen = (unsigned long long*)malloc(boards);
+    batch->redKings = (unsigned long long*)malloc(boards);
+    batch->blackMen = (unsigned long long*)malloc(boards);
+    batch->blackKings = (unsigned long long*)malloc(boards);
+    batch->turn = (int*)malloc((size_t)capacity * sizeof(int));
+
+    // qualifier: every array is needed, give back the ones that were allocated
+    if (capacity < 1 || batch->redMen == NULL || batch->redKings == NULL || batch->blackMen == NULL
+        || batch->blackKings == NULL || batch->turn == NULL)
+    {
+        FreePositionBatch(batch);
+        return 0;
+    }
+    return 1;
+}
+
+// release the memory of "batch"
+void FreePositionBatch(PositionBatch* batch)
+{
+    free(batch->redMen);
+    free(batch->redKings);
+    free(batch->blackMen);
+    free(batch->blackKings);
+    free(batch->turn);
+    batch->redMen = NULL;
+    batch->redKings = NULL;
+    batch->blackMen = NULL;
+    batch->blackKings = NULL;
+    batch->turn = NULL;
+    batch->count = 0;
+    batch->capacity = 0;
+}
+
+// append "game" to "batch"
+// returns 1 if it was added, 0 if the batch is full
+int AddToPositionBatch(PositionBatch* batch, const GameState* game)
+{
+    int i = batch->count; // slot for the new position
+
+    // qualifier: never write past the end of the arrays
+    if (i >= batch->capacity) { return 0; }
+
+    batch->redMen[i] = game->player1_men;
+    batch->redKings[i] = game->player1_kings;
+    batch->blackMen[i] = game->player2_men;
+    batch->blackKings[i] = game->player2_kings;
+    batch->turn[i] = game->current_turn;
+    batch->count = i + 1;
+    return 1;
+}
+
+// allocate "features" for up to "capacity" positions
+// returns 1 on success, 0 if the memory could not be allocated
+int InitFeatureBatch(FeatureBatch* features, int capacity)
+{
+    size_t bytes = (size_t)capacity * sizeof(int); // bytes of one feature array
+
+    features->capacity = capacity;
+    features->material = (int*)malloc(bytes);
+    features->kings = (int*)malloc(bytes);
+    features->mobility = (int*)malloc(bytes);
+    features->advancement = (int*)malloc(bytes);
+    features->materialScore = (int*)malloc(bytes);
+
+    // qualifier: every array is needed, give back the ones that were allocated
+    if (capacity < 1 || features->material == NULL || features->kings == NULL || features->mobility == NULL
+        || features->advancement == NULL || features->materialScore == NULL)
+    {
+        FreeFeatureBatch(features);
+        return 0;
+    }
+    return 1;
+}
+
+// release the memory of "features"
+void FreeFeatureBatch(FeatureBatch* features)
+{
+    free(features->material);
+    free(features->kings);
+    free(features->mobility);
+    free(features->advancement);
+    free(features->materialScore);
+    features->material = NULL;
+    features->kings = NULL;
+    features->mobility = NULL;
+    features->advancement = NULL;
+    features->materialScore = NULL;
+    features->capacity = 0;
+}
+
+// Scalar Backend //
+
+// method to evaluate position "i" of "batch" into slot "i" of "features"
+// the reference every other backend has to match exactly
+static void EvaluateOne(const PositionBatch* batch, FeatureBatch* features, int i)
+{
+    unsigned long long redMen = batch->redMen[i]; // Red men
+    unsigned long long redKings = batch->redKings[i]; // Red kings
+    unsigned long long blackMen = batch->blackMen[i]; // Black men
+    unsigned long long blackKings = batch->blackKings[i]; // Black kings
+    unsigned long long empty = darkSquareMask & ~(redMen | redKings | blackMen | blackKings); // free dark squares
+    unsigned long long redDown = redMen | redKings; // Red pieces moving down (forward for Red men)
+    unsigned long long blackUp = blackMen | blackKings; // Black pieces moving up (forward for Black men)
+    unsigned long long redSteps = 0ull; // squares a Red piece can step to
+    unsigned long long blackSteps = 0ull; // squares a Black piece can step to
+    int material = 0; // Red minus Black material
+    int advancement = 0; // Red minus Black advancement bonus
+    int row = 0; // loop iterator for the rows
+
+    material = EVAL_MAN_VALUE * (PopCount64(redMen) - PopCount64(blackMen))
+        + EVAL_KING_VALUE * (PopCount64(redKings) - PopCount64(blackKings));
+
+    // Down-Right (+9) / Down-Left (+7) / Up-Right (-7) / Up-Left (-9), kings use all four
+    redSteps = (((redDown & NOT_COL_7) << 9) | ((redDown & NOT_COL_0) << 7)
+        | ((redKings & NOT_COL_7) >> 7) | ((redKings & NOT_COL_0) >> 9)) & empty;
+    blackSteps = (((blackUp & NOT_COL_7) >> 7) | ((blackUp & NOT_COL_0) >> 9)
+        | ((blackKings & NOT_COL_7) << 9) | ((blackKings & NOT_COL_0) << 7)) & empty;
+
+    // Red men advance "down" (towards row 7), Black men advance "up" (towards row 0)
+    for (row = 1; row < 7; row++)
+    {
+        unsigned long long rowMask = 0xFFull << (8 * row); // squares of this row
+
+        advancement = advancement + EVAL_ADVANCE_VALUE * row * PopCount64(redMen & rowMask);
+        advancement = advancement - EVAL_ADVANCE_VALUE * (7 - row) * PopCount64(blackMen & rowMask);
+    }
+
+    features->material[i] = material;
+    features->kings[i] = PopCount64(redKings) - PopCount64(blackKings);
+    features->mobility[i] = PopCount64(redSteps) - PopCount64(blackSteps);
+    features->advancement[i] = advancement;
+
+    // qualifier: flip the sign so the score is for the player to move
+    features->materialScore[i] = (batch->turn[i] == 1) ? material + advancement : -(material + advancement);
+}
+
+// evaluate every position of "batch" into "features" one at a time (reference results)
+void EvaluateBatchScalar(const PositionBatch* batch, FeatureBatch* features)
+{
+    int i = 0; // loop iterator for the positions
+
+    for (i = 0; i < batch->count; i++) { EvaluateOne(batch, features, i); }
+}
+
+// AVX2 Backend //
+
+#ifdef EVALBATCH_AVX2
+
+// method to count the set bits of each of the 4 bitboards in "boards"
+// every byte is split into two 4-bit halves that index a 16 entry count table,
+// then the byte counts of each bitboard are added up by one sum of absolute differences
+__attribute__((target("avx2")))
+static __m256i CountBits4(__m256i boards)
+{
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4); // set bits of 0-15, once per 128-bit half
+    const __m256i lowNibble = _mm256_set1_epi8(0x0F); // low 4 bits of every byte
+    __m256i low = _mm256_and_si256(boards, lowNibble); // low half of every byte
+    __m256i high = _mm256_and_si256(_mm256_srli_epi16(boards, 4), lowNibble); // high half of every byte
+    __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(table, low), _mm256_shuffle_epi8(table, high));
+
+    return _mm256_sad_epu8(bytes, _mm256_setzero_si256());
+}
+
+// method to keep the low 32 bits of each of the 4 64-bit lanes of "lanes" as 4 ints
+__attribute__((target("avx2")))
+static __m128i LowHalves(__m256i lanes)
+{
+    return _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(lanes, _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6)));
+}
+
+// method to add up the rows of every man in each of the 4 bitboards in "men"
+__attribute__((target("avx2")))
+static __m256i SumRows4(__m256i men)
+{
+    __m256i bit0 = CountBits4(_mm256_and_si256(men, _mm256_set1_epi64x((long long)ROW_BIT_0)));
+    __m256i bit1 = CountBits4(_mm256_and_si256(men, _mm256_set1_epi64x((long long)ROW_BIT_1)));
+    __m256i bit2 = CountBits4(_mm256_and_si256(men, _mm256_set1_epi64x((long long)ROW_BIT_2)));
+
+    return _mm256_add_epi64(bit0, _mm256_add_epi64(_mm256_slli_epi64(bit1, 1), _mm256_slli_epi64(bit2, 2)));
+}
+
+// method to evaluate "batch" 4 positions per instruction, the last (count % 4) positions use EvaluateOne
+// every feature is built from the same integer sums as EvaluateOne, so the results are identical
+__attribute__((target("avx2")))
+static void EvaluateBatchAvx2(const PositionBatch* batch, FeatureBatch* features)
+{
+    const __m256i notCol0 = _mm256_set1_epi64x((long long)NOT_COL_0); // steps to the left
+    const __m256i notCol7 = _mm256_set1_epi64x((long long)NOT_COL_7); // steps to the right
+    const __m256i dark = _mm256_set1_epi64x((long long)darkSquareMask); // playable squares
+    const __m256i rows = _mm256_set1_epi64x((long long)ROWS_1_TO_6); // rows counted for advancement
+    const __m256i manValue = _mm256_set1_epi64x(EVAL_MAN_VALUE);
+    const __m256i kingValue = _mm256_set1_epi64x(EVAL_KING_VALUE);
+    const __m256i advanceValue = _mm256_set1_epi64x(EVAL_ADVANCE_VALUE);
+    int i = 0; // first position of each group of 4
+
+    for (i = 0; i + 4 <= batch->count; i += 4)
+    {
+        __m256i redMen = _mm256_loadu_si256((const __m256i*)&batch->redMen[i]);
+        __m256i redKings = _mm256_loadu_si256((const __m256i*)&batch->redKings[i]);
+        __m256i blackMen = _mm256_loadu_si256((const __m256i*)&batch->blackMen[i]);
+        __m256i blackKings = _mm256_loadu_si256((const __m256i*)&batch->blackKings[i]);
+        __m256i redDown = _mm256_or_si256(redMen, redKings); // Red pieces moving down
+        __m256i blackUp = _mm256_or_si256(blackMen, blackKings); // Black pieces moving up
+        __m256i empty = _mm256_andnot_si256(_mm256_or_si256(redDown, blackUp), dark); // free dark squares
+        __m256i redSteps, blackSteps; // squares each side can step to
+        __m256i redManCount = CountBits4(redMen);
+        __m256i redKingCount = CountBits4(redKings);
+        __m256i blackManCount = CountBits4(blackMen);
+        __m256i blackKingCount = CountBits4(blackKings);
+        __m256i material, kings, mobility, redAdvance, blackAdvance, blackRowMen; // per position, 64-bit lanes
+        __m128i materialInts, advanceInts, total, turns, redToMove; // per position, 32-bit lanes
+
+        // material and king difference
+        material = _mm256_sub_epi64(
+            _mm256_add_epi64(_mm256_mul_epu32(redManCount, manValue), _mm256_mul_epu32(redKingCount, kingValue)),
+            _mm256_add_epi64(_mm256_mul_epu32(blackManCount, manValue), _mm256_mul_epu32(blackKingCount, kingValue)));
+        kings = _mm256_sub_epi64(redKingCount, blackKingCount);
+
+        // simple steps, Down-Right (+9) / Down-Left (+7) / Up-Right (-7) / Up-Left (-9)
+        redSteps = _mm256_or_si256(
+            _mm256_or_si256(_mm256_slli_epi64(_mm256_and_si256(redDown, notCol7), 9),
+                _mm256_slli_epi64(_mm256_and_si256(redDown, notCol0), 7)),
+            _mm256_or_si256(_mm256_srli_epi64(_mm256_and_si256(redKings, notCol7), 7),
+                _mm256_srli_epi64(_mm256_and_si256(redKings, notCol0), 9)));
+        blackSteps = _mm256_or_si256(
+            _mm256_or_si256(_mm256_srli_epi64(_mm256_and_si256(blackUp, notCol7), 7),
+                _mm256_srli_epi64(_mm256_and_si256(blackUp, notCol0), 9)),
+            _mm256_or_si256(_mm256_slli_epi64(_mm256_and_si256(blackKings, notCol7), 9),
+                _mm256_slli_epi64(_mm256_and_si256(blackKings, notCol0), 7)));
+        mobility = _mm256_sub_epi64(CountBits4(_mm256_and_si256(redSteps, empty)),
+            CountBits4(_mm256_and_si256(blackSteps, empty)));
+
+        // advancement: Red men score their row, Black men score (7 - row), rows 1-6 only
+        redAdvance = _mm256_mul_epu32(SumRows4(_mm256_and_si256(redMen, rows)), advanceValue);
+        blackRowMen = _mm256_and_si256(blackMen, rows);
+        blackAdvance = _mm256_sub_epi64(_mm256_mul_epu32(CountBits4(blackRowMen), _mm256_set1_epi64x(7)), SumRows4(blackRowMen));
+        blackAdvance = _mm256_mul_epu32(blackAdvance, advanceValue);
+
+        materialInts = LowHalves(material);
+        advanceInts = LowHalves(_mm256_sub_epi64(redAdvance, blackAdvance));
+        _mm_storeu_si128((__m128i*)&features->material[i], materialInts);
+        _mm_storeu_si128((__m128i*)&features->kings[i], LowHalves(kings));
+        _mm_storeu_si128((__m128i*)&features->mobility[i], LowHalves(mobility));
+        _mm_storeu_si128((__m128i*)&features->advancement[i], advanceInts);
+
+        // flip the sign of the score wherever Black is to move
+        total = _mm_add_epi32(materialInts, advanceInts);
+        turns = _mm_loadu_si128((const __m128i*)&batch->turn[i]);
+        redToMove = _mm_cmpeq_epi32(turns, _mm_set1_epi32(1));
+        total = _mm_blendv_epi8(_mm_sub_epi32(_mm_setzero_si128(), total), total, redToMove);
+        _mm_storeu_si128((__m128i*)&features->materialScore[i], total);
+    }
+
+    // the last few positions do not fill a group of 4
+    for (; i < batch->count; i++) { EvaluateOne(batch, features, i); }
+}
+
+// method to check whether this processor supports AVX2
+static int HasAvx2(void)
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") ? 1 : 0;
+}
+
+#endif
+
+// Backend Selection //
+
+// evaluate every position of "batch" into "features" with the fastest backend
+// "features" must hold at least "batch->count" positions
+void EvaluateBatch(const PositionBatch* batch, FeatureBatch* features)
+{
+#ifdef EVALBATCH_AVX2
+    // qualifier: use the AVX2 backend when the processor has it
+    if (HasAvx2())
+    {
+        EvaluateBatchAvx2(batch, features);
+        return;
+    }
+#endif
+    EvaluateBatchScalar(batch, features);
+}
+
+// name of the backend EvaluateBatch uses on this machine ("avx2" or "scalar")
+const char* EvalBatchBackend(void)
+{
+#ifdef EVALBATCH_AVX2
+    if (HasAvx2()) { return "avx2"; }
+#endif
+    return "scalar";
+}
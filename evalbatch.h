@@ -0,0 +1,100 @@
+// [evalbatch.h] header file
+// function declarations for "evalbatch.c"
+// implemented in "evaluate.c" / "posdbtool.c"
+
+#ifndef EVALBATCH_H
+#define EVALBATCH_H
+
+#include "game.h" // implement GameState structure
+
+// { Phase 4 - Batch Evaluation } //
+// scores large numbers of positions at once, for database scoring and training data
+
+/*
+    Positions are stored "structure of arrays": one array per bitboard and
+    one for the side to move, so the same field of neighbouring positions
+    sits next to each other in memory and can be loaded together.
+
+    Features written for every position (Red minus Black unless noted):
+
+        material       men * EVAL_MAN_VALUE + kings * EVAL_KING_VALUE
+        kings          number of kings
+        mobility       empty squares reachable by one simple step (captures ignored)
+        advancement    EVAL_ADVANCE_VALUE for every row a man has advanced (rows 1-6)
+        materialScore  material + advancement, for the player to move
+
+    "materialScore" is only the material and tempo part of the score the
+    search uses: the back rank, center and runaway features and the weights
+    of "evaluate.h" are left out. Use EvaluatePosition for the search score
+    ("dbscore --output" writes both, "./evalcheck" checks that the shared
+    features agree).
+
+    EvaluateBatch picks the fastest backend at run time:
+
+        avx2    x86 processors with AVX2, 4 positions per instruction
+                (GCC / Clang builds, no extra compiler flags needed)
+        scalar  everything else, one position at a time
+
+    Both backends give exactly the same numbers, EvaluateBatchScalar can be
+    called directly to check that.
+*/
+
+// material values, in points (a man is worth 100), the default weights of "evaluate.h"
+#define EVAL_MAN_VALUE 100
+#define EVAL_KING_VALUE 130
+
+// bonus for every row a man has advanced towards promotion, the default tempo weight of "evaluate.h"
+#define EVAL_ADVANCE_VALUE 2
+
+// positions to evaluate, one array per field ("count" used of "capacity")
+typedef struct
+{
+    unsigned long long* redMen; // player1_men of each position
+    unsigned long long* redKings; // player1_kings of each position
+    unsigned long long* blackMen; // player2_men of each position
+    unsigned long long* blackKings; // player2_kings of each position
+    int* turn; // current_turn of each position (1 Red, 2 Black)
+    int count; // positions stored
+    int capacity; // positions the arrays can hold
+} PositionBatch;
+
+// features of every position in a PositionBatch, one array per feature
+typedef struct
+{
+    int* material; // Red minus Black material
+    int* kings; // Red minus Black kings
+    int* mobility; // Red minus Black simple-step squares
+    int* advancement; // Red minus Black advancement bonus
+    int* materialScore; // material + advancement for the player to move (not the full search score)
+    int capacity; // positions the arrays can hold
+} FeatureBatch;
+
+// allocate "batch" for up to "capacity" positions, starts empty
+// returns 1 on success, 0 if the memory could not be allocated
+int InitPositionBatch(PositionBatch* batch, int capacity);
+
+// release the memory of "batch"
+void FreePositionBatch(PositionBatch* batch);
+
+// append "game" to "batch"
+// returns 1 if it was added, 0 if the batch is full
+int AddToPositionBatch(PositionBatch* batch, const GameState* game);
+
+// allocate "features" for up to "capacity" positions
+// returns 1 on success, 0 if the memory could not be allocated
+int InitFeatureBatch(FeatureBatch* features, int capacity);
+
+// release the memory of "features"
+void FreeFeatureBatch(FeatureBatch* features);
+
+// evaluate every position of "batch" into "features" with the fastest backend
+// "features" must hold at least "batch->count" positions
+void EvaluateBatch(const PositionBatch* batch, FeatureBatch* features);
+
+// evaluate every position of "batch" into "features" one at a time (reference results)
+void EvaluateBatchScalar(const PositionBatch* batch, FeatureBatch* features);
+
+// name of the backend EvaluateBatch uses on this machine ("avx2" or "scalar")
+const char* EvalBatchBackend(void);
+
+#endif
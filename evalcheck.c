@@ -0,0 +1,271 @@
+// [evalcheck.c] file
+// run the evaluation checks here!
+
+/*
+    Checks the position evaluation ("evaluate.h") the way perft checks the
+    move generator: every check prints one line ending in "ok" or "FAILED",
+    and the exit code is 1 when any check failed.
+
+    Usage:
+        ./evalcheck [positions]
+
+        [positions]  random game positions to check (default 10000)
+
+    Checks:
+        weights     weight files beyond EVAL_WEIGHT_LIMIT (and values that
+                    are not numbers) are rejected, files at the limit load
+        bounds      with every weight at +/- EVAL_WEIGHT_LIMIT, the static
+                    score of every position stays within EVAL_SCORE_LIMIT
+        batch       EvaluateBatch agrees with the search evaluation on every
+                    feature they share (material, kings, mobility, tempo),
+                    and its "materialScore" is EvaluatePosition with only
+                    the material and tempo weights
+        search      searches with those weights only report scores within
+                    EVAL_SCORE_LIMIT or real wins, never one that could be
+                    taken for a tablebase win
+
+    The positions come from random games played from SetBoard with a fixed
+    seed, so every run checks the same positions.
+*/
+
+#include <stdio.h> // for printing and writing the weight files
+#include <stdlib.h> // for atoi / malloc / free
+#include <string.h> // for strchr
+
+#include "game.h" // GameState structure, SetBoard
+#include "movegen.h" // GenerateMoves / ApplyMove for the random games
+#include "evaluate.h" // evaluation being checked
+#include "evalbatch.h" // batch evaluator, compared with the search evaluation
+#include "search.h" // SearchBestMove and its score ranges
+#include "stats.h" // game core counters of instrumented builds
+
+// random positions checked without an argument
+#define EVALCHECK_DEFAULT_POSITIONS 10000
+
+// plies of a random game before a new one is started
+#define EVALCHECK_GAME_PLIES 120
+
+// weight file written and read back by the checks, removed again afterwards
+#define EVALCHECK_WEIGHT_FILE "evalcheck_weights.tmp"
+
+// depth and number of positions of the search check
+#define EVALCHECK_SEARCH_DEPTH 6
+#define EVALCHECK_SEARCHES 50
+
+// method to step the random number generator and return its next value (64-bit LCG, high bits)
+static unsigned int NextRandom(unsigned long long* state)
+{
+    *state = *state * 6364136223846793005ull + 1442695040888963407ull;
+    return (unsigned int)(*state >> 33);
+}
+
+// method to fill "positions" with "count" positions from random games, always with a legal move
+static void MakePositions(GameState* positions, int count)
+{
+    unsigned long long seed = 1ull; // fixed seed, every run checks the same positions
+    GameState game; // random game being played
+    int plies = 0; // plies of the current game
+    int i = 0; // loop iterator for the positions
+
+    SetBoard(&game);
+    for (i = 0; i < count; i++)
+    {
+        MoveList list; // legal moves of the current position
+
+        // qualifier: a finished or long game starts over from the starting position
+        if (GenerateMoves(&game, &list) == 0 || plies >= EVALCHECK_GAME_PLIES)
+        {
+            SetBoard(&game);
+            GenerateMoves(&game, &list);
+            plies = 0;
+        }
+        ApplyMove(&game, &list.moves[NextRandom(&seed) % (unsigned int)list.count]);
+        plies++;
+        positions[i] = game;
+    }
+}
+
+// method to write "text" as the weight file and load it into "weights"
+// returns what LoadEvalWeights returned, 0 as well if the file could not be written
+static int LoadWeightText(const char* text, EvalWeights* weights)
+{
+    FILE* file = fopen(EVALCHECK_WEIGHT_FILE, "w"); // weight file of this check
+    int errorLine = 0; // first invalid line reported by LoadEvalWeights
+    int loaded = 0; // result of LoadEvalWeights
+
+    if (file == NULL) { return 0; }
+    fputs(text, file);
+    fclose(file);
+
+    loaded = LoadEvalWeights(EVALCHECK_WEIGHT_FILE, weights, &errorLine);
+    remove(EVALCHECK_WEIGHT_FILE);
+    return loaded;
+}
+
+// method to print the result of one check, returns 1 if it failed
+static int Report(const char* name, int passed, const char* detail)
+{
+    printf("%-8s %-52s %s\n", name, detail, passed ? "ok" : "FAILED");
+    return passed ? 0 : 1;
+}
+
+// method to check that out of range weight files are rejected and files at the limit load
+static int CheckWeightFiles(void)
+{
+    static const char* rejected[] = { "man 1001\n", "king -1001\n", "runaway 99999999999999999999\n", "tempo 12x\n" }; // invalid files
+    EvalWeights weights = defaultEvalWeights; // weights read by each check
+    char text[256]; // weight file at the limit
+    int failed = 0; // checks that failed
+    int i = 0; // loop iterator for the files
+
+    for (i = 0; i < 4; i++)
+    {
+        char detail[64]; // file of this check, without its newline
+
+        snprintf(detail, sizeof(detail), "rejects \"%.*s\"", (int)(strchr(rejected[i], '\n') - rejected[i]), rejected[i]);
+        failed += Report("weights", !LoadWeightText(rejected[i], &weights), detail);
+    }
+
+    snprintf(text, sizeof(text), "man %d\nking %d\nback_rank %d\n", EVAL_WEIGHT_LIMIT, -EVAL_WEIGHT_LIMIT, EVAL_WEIGHT_LIMIT);
+    failed += Report("weights", LoadWeightText(text, &weights) && weights.values[EVAL_TERM_KINGS] == -EVAL_WEIGHT_LIMIT,
+        "loads weights at EVAL_WEIGHT_LIMIT");
+    return failed;
+}
+
+// method to check that the score stays within EVAL_SCORE_LIMIT with extreme weights, for both signs
+static int CheckBounds(const GameState* positions, int count)
+{
+    EvalWeights weights; // every weight at the limit
+    int worst = 0; // largest score seen (either sign)
+    int sign = 0; // loop iterator for the weight sign
+    int term = 0; // loop iterator for the weights
+    int i = 0; // loop iterator for the positions
+    char detail[64]; // result line
+
+    for (sign = -1; sign <= 1; sign += 2)
+    {
+        for (term = 0; term < EVAL_TERMS; term++) { weights.values[term] = sign * EVAL_WEIGHT_LIMIT; }
+        for (i = 0; i < count; i++)
+        {
+            int score = EvaluatePosition(&positions[i], &weights); // static score at the extreme weights
+
+            if (score > worst) { worst = score; }
+            if (-score > worst) { worst = -score; }
+        }
+    }
+
+    snprintf(detail, sizeof(detail), "largest score %d of %d positions", worst, count);
+    return Report("bounds", worst <= EVAL_SCORE_LIMIT, detail);
+}
+
+// method to check that EvaluateBatch and the search evaluation agree on the features they share
+static int CheckBatch(const GameState* positions, int count)
+{
+    EvalWeights materialWeights = { { EVAL_MAN_VALUE, EVAL_KING_VALUE, 0, 0, EVAL_ADVANCE_VALUE, 0, 0 } }; // the part "materialScore" covers
+    PositionBatch batch; // every position
+    FeatureBatch features; // batch evaluator results
+    int differences = 0; // positions where the two evaluators disagree
+    int i = 0; // loop iterator for the positions
+    char detail[64]; // result line
+
+    if (!InitPositionBatch(&batch, count)) { return Report("batch", 0, "out of memory"); }
+    if (!InitFeatureBatch(&features, count))
+    {
+        FreePositionBatch(&batch);
+        return Report("batch", 0, "out of memory");
+    }
+    for (i = 0; i < count; i++) { AddToPositionBatch(&batch, &positions[i]); }
+    EvaluateBatch(&batch, &features);
+
+    for (i = 0; i < count; i++)
+    {
+        int kept[EVAL_TERMS]; // features of the search evaluation
+
+        EvalFeatures(&positions[i], kept);
+        if (features.material[i] != EVAL_MAN_VALUE * kept[EVAL_TERM_MEN] + EVAL_KING_VALUE * kept[EVAL_TERM_KINGS]
+            || features.kings[i] != kept[EVAL_TERM_KINGS] || features.mobility[i] != kept[EVAL_TERM_MOBILITY]
+            || features.advancement[i] != EVAL_ADVANCE_VALUE * kept[EVAL_TERM_TEMPO]
+            || features.materialScore[i] != EvaluatePosition(&positions[i], &materialWeights))
+        {
+            differences++;
+        }
+    }
+    FreePositionBatch(&batch);
+    FreeFeatureBatch(&features);
+
+    snprintf(detail, sizeof(detail), "%d of %d positions differ (%s backend)", differences, count, EvalBatchBackend());
+    return Report("batch", differences == 0, detail);
+}
+
+// method to check that searches with extreme weights only report static scores or real wins
+// a score between EVAL_SCORE_LIMIT and the win scores would be a position taken for a tablebase win
+static int CheckSearch(const GameState* positions, int count)
+{
+    EvalWeights weights; // every weight at the limit
+    SearchLimits limits; // fixed depth, one thread, no table
+    SearchResult result; // search answer
+    int worst = 0; // largest score that is not a win (either sign)
+    int searched = 0; // positions searched
+    int term = 0; // loop iterator for the weights
+    int i = 0; // loop iterator for the positions
+    char detail[64]; // result line
+
+    for (term = 0; term < EVAL_TERMS; term++) { weights.values[term] = EVAL_WEIGHT_LIMIT; }
+    limits.maxDepth = EVALCHECK_SEARCH_DEPTH;
+    limits.timeLimitMs = 0;
+    limits.nodeLimit = 0ull;
+    limits.verbose = 0;
+    limits.table = NULL;
+    limits.threads = 1;
+    limits.tablebase = NULL;
+    limits.stop = NULL;
+    limits.progress = NULL;
+    limits.progressContext = NULL;
+    limits.weights = &weights;
+
+    for (i = 0; i < count; i += (count + EVALCHECK_SEARCHES - 1) / EVALCHECK_SEARCHES)
+    {
+        int score = 0; // size of the search score
+
+        SearchBestMove(&positions[i], &limits, &result);
+        score = (result.score < 0) ? -result.score : result.score;
+        if (score < SEARCH_WIN_SCORE - SEARCH_MAX_PLY && score > worst) { worst = score; }
+        searched++;
+    }
+
+    snprintf(detail, sizeof(detail), "largest score %d of %d searches, depth %d", worst, searched, EVALCHECK_SEARCH_DEPTH);
+    return Report("search", worst <= EVAL_SCORE_LIMIT, detail);
+}
+
+// method for running the evaluation checks (entry point)
+int main(int argc, char* argv[])
+{
+    int count = EVALCHECK_DEFAULT_POSITIONS; // random positions to check
+    GameState* positions = NULL; // the random positions
+    int failed = 0; // checks that failed
+
+    if (argc > 1) { count = atoi(argv[1]); }
+    if (argc > 2 || count < 1)
+    {
+        printf("Usage: ./evalcheck [positions]\n");
+        return 1;
+    }
+
+    positions = (GameState*)malloc((size_t)count * sizeof(GameState));
+    if (positions == NULL)
+    {
+        printf("Not enough memory for %d positions.\n", count);
+        return 1;
+    }
+    StatsDumpOnExit(); // instrumented builds print the game core counters at exit
+    MakePositions(positions, count);
+
+    failed += CheckWeightFiles();
+    failed += CheckBounds(positions, count);
+    failed += CheckBatch(positions, count);
+    failed += CheckSearch(positions, count);
+
+    free(positions);
+    printf("\n%d check(s) failed\n", failed);
+    return (failed == 0) ? 0 : 1;
+}
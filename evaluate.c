@@ -0,0 +1,206 @@
+// [evaluate.c] file
+
+#include <stdio.h> // for reading and writing weight files
+#include <stdlib.h> // for strtol
+#include <string.h> // for strcmp / strchr
+
+#include "evaluate.h" // declare "evaluate" methods
+#include "evalbatch.h" // material and advancement values, shared with the batch evaluator
+#include "movetables.h" // generated feature tables and runaway cones
+#include "bitoperations.h" // PopCount64 / PopLowestBit64 for the bitboard features
+
+// every square except column 0, pieces here may step "left" (col - 1)
+#define NOT_COL_0 0xFEFEFEFEFEFEFEFEull
+
+// every square except column 7, pieces here may step "right" (col + 1)
+#define NOT_COL_7 0x7F7F7F7F7F7F7F7Full
+
+// longest line read from a weight file
+#define WEIGHT_LINE_MAX 128
+
+// names of the features in weight files, in EVAL_TERM_* order
+static const char* termNames[EVAL_TERMS] = { "man", "king", "back_rank", "center", "tempo", "mobility", "runaway" };
+
+// the weights the search uses when none are given
+const EvalWeights defaultEvalWeights =
+{
+    {
+        EVAL_MAN_VALUE, // man
+        EVAL_KING_VALUE, // king
+        6, // back_rank
+        4, // center
+        EVAL_ADVANCE_VALUE, // tempo
+        1, // mobility
+        30 // runaway
+    }
+};
+
+// method to count the empty squares each side could step to, Red minus Black
+static int Mobility(const GameState* game)
+{
+    unsigned long long empty = darkSquareMask & ~(game->player1_men | game->player1_kings | game->player2_men | game->player2_kings); // free dark squares
+    unsigned long long redDown = game->player1_men | game->player1_kings; // Red pieces moving down (forward for Red men)
+    unsigned long long blackUp = game->player2_men | game->player2_kings; // Black pieces moving up (forward for Black men)
+    unsigned long long redSteps = 0ull; // squares a Red piece can step to
+    unsigned long long blackSteps = 0ull; // squares a Black piece can step to
+
+    // Down-Right (+9) / Down-Left (+7) / Up-Right (-7) / Up-Left (-9), kings use all four
+    redSteps = (((redDown & NOT_COL_7) << 9) | ((redDown & NOT_COL_0) << 7)
+        | ((game->player1_kings & NOT_COL_7) >> 7) | ((game->player1_kings & NOT_COL_0) >> 9)) & empty;
+    blackSteps = (((blackUp & NOT_COL_7) >> 7) | ((blackUp & NOT_COL_0) >> 9)
+        | ((game->player2_kings & NOT_COL_7) << 9) | ((game->player2_kings & NOT_COL_0) << 7)) & empty;
+    return PopCount64(redSteps) - PopCount64(blackSteps);
+}
+
+// method to count the men with no opposing piece in front of them, Red minus Black
+static int Runaways(const GameState* game)
+{
+    unsigned long long red = game->player1_men | game->player1_kings; // every Red piece
+    unsigned long long black = game->player2_men | game->player2_kings; // every Black piece
+    unsigned long long men = game->player1_men; // Red men left to check
+    int runaways = 0; // Red minus Black runaways
+
+    while (men != 0ull)
+    {
+        int square = PopLowestBit64(&men); // next Red man (cleared from "men")
+        if ((runawayConeMask[1][square] & black) == 0ull) { runaways++; }
+    }
+
+    men = game->player2_men;
+    while (men != 0ull)
+    {
+        int square = PopLowestBit64(&men); // next Black man (cleared from "men")
+        if ((runawayConeMask[2][square] & red) == 0ull) { runaways--; }
+    }
+    return runaways;
+}
+
+// Features //
+
+// work out "eval_terms" of "game" from its bitboards
+void ComputeEvalTerms(GameState* game)
+{
+    const unsigned long long* boards[4] = { &game->player1_men, &game->player1_kings, &game->player2_men, &game->player2_kings }; // pieces in Zobrist type order
+    int type = 0; // loop iterator for the piece types
+    int term = 0; // loop iterator for the features
+
+    for (term = 0; term < EVAL_SQUARE_TERMS; term++) { game->eval_terms[term] = 0; }
+    for (type = 0; type < 4; type++)
+    {
+        unsigned long long pieces = *boards[type]; // pieces of this type left to add
+
+        while (pieces != 0ull)
+        {
+            int square = PopLowestBit64(&pieces); // next piece (cleared from "pieces")
+
+            for (term = 0; term < EVAL_SQUARE_TERMS; term++) { game->eval_terms[term] += evalSquareTerms[type][square][term]; }
+        }
+    }
+}
+
+// fill "features" (EVAL_TERMS values, Red minus Black) for "game"
+void EvalFeatures(const GameState* game, int features[EVAL_TERMS])
+{
+    int term = 0; // loop iterator for the kept features
+
+    for (term = 0; term < EVAL_SQUARE_TERMS; term++) { features[term] = game->eval_terms[term]; }
+    features[EVAL_TERM_MOBILITY] = Mobility(game);
+    features[EVAL_TERM_RUNAWAY] = Runaways(game);
+}
+
+// score "game" with "weights", from the point of view of the player to move
+int EvaluatePosition(const GameState* game, const EvalWeights* weights)
+{
+    const int* values = weights->values; // weight of each feature
+    int score = 0; // Red minus Black
+    int term = 0; // loop iterator for the kept features
+
+    for (term = 0; term < EVAL_SQUARE_TERMS; term++) { score += values[term] * game->eval_terms[term]; }
+
+    // qualifier: the bitboard features are only worked out when they count
+    if (values[EVAL_TERM_MOBILITY] != 0) { score += values[EVAL_TERM_MOBILITY] * Mobility(game); }
+    if (values[EVAL_TERM_RUNAWAY] != 0) { score += values[EVAL_TERM_RUNAWAY] * Runaways(game); }
+
+    // qualifier: no weights may reach the tablebase and win scores of the search
+    if (score > EVAL_SCORE_LIMIT) { score = EVAL_SCORE_LIMIT; }
+    else if (score < -EVAL_SCORE_LIMIT) { score = -EVAL_SCORE_LIMIT; }
+
+    // qualifier: flip the sign so the score is for the player to move
+    if (IsRedPlayer1Turn(game)) { return score; }
+    return -score;
+}
+
+// Weight Files //
+
+// name of feature / weight "term" in weight files
+const char* EvalTermName(int term)
+{
+    if (term < 0 || term >= EVAL_TERMS) { return "unknown"; }
+    return termNames[term];
+}
+
+// read the weights of "filename" into "weights", starting from the defaults
+int LoadEvalWeights(const char* filename, EvalWeights* weights, int* errorLine)
+{
+    FILE* file = fopen(filename, "r"); // weight file
+    EvalWeights read = defaultEvalWeights; // weights being read
+    char line[WEIGHT_LINE_MAX]; // current line
+    int lineNumber = 0; // line counter
+
+    *errorLine = 0;
+    if (file == NULL) { return 0; }
+
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        char name[WEIGHT_LINE_MAX]; // weight name of the line
+        char number[WEIGHT_LINE_MAX]; // weight value of the line, as text
+        char extra = '\0'; // anything after the value
+        char* end = NULL; // first character strtol did not use
+        long value = 0; // weight value of the line
+        int fields = 0; // fields read by sscanf
+        int term = 0; // loop iterator for the weight names
+        char* comment = strchr(line, '#'); // start of a comment, if any
+
+        lineNumber++;
+        if (comment != NULL) { *comment = '\0'; }
+
+        // qualifier: blank and comment lines are skipped, others hold exactly "name value"
+        // the value is read with strtol, which (unlike "%d") stops at the range of a long instead of overflowing
+        fields = sscanf(line, "%127s %127s %c", name, number, &extra);
+        if (fields <= 0) { continue; }
+        if (fields == 2) { value = strtol(number, &end, 10); }
+        if (fields != 2 || end == number || *end != '\0')
+        {
+            *errorLine = lineNumber;
+            fclose(file);
+            return 0;
+        }
+
+        for (term = 0; term < EVAL_TERMS; term++)
+        {
+            if (strcmp(name, termNames[term]) == 0) { break; }
+        }
+
+        // qualifier: an unknown name is an error, it is most likely a typing mistake,
+        // and so is a weight so large that a single feature would swamp every other
+        if (term == EVAL_TERMS || value > EVAL_WEIGHT_LIMIT || value < -EVAL_WEIGHT_LIMIT)
+        {
+            *errorLine = lineNumber;
+            fclose(file);
+            return 0;
+        }
+        read.values[term] = (int)value;
+    }
+
+    fclose(file);
+    *weights = read;
+    return 1;
+}
+
+// write "weights" to "file" in the weight file format
+void WriteEvalWeights(FILE* file, const EvalWeights* weights)
+{
+    int term = 0; // loop iterator for the weights
+
+    for (term = 0; term < EVAL_TERMS; term++) { fprintf(file, "%s %d\n", termNames[term], weights->values[term]); }
+}
@@ -0,0 +1,101 @@
+// [evaluate.h] header file
+// function declarations for "evaluate.c"
+// implemented in "search.c" / "movegen.c" / "selfplay.c" / "engine.c"
+
+#ifndef EVALUATE_H
+#define EVALUATE_H
+
+#include <stdio.h> // for FILE (WriteEvalWeights)
+
+#include "game.h" // implement GameState structure and the EVAL_TERM_* features kept in it
+
+// { Phase 4 - Position Evaluation } //
+// static score of a position for the search, a weighted sum of features
+
+/*
+    Features, all Red minus Black:
+
+        men / kings   pieces of each kind (material)
+        back_rank     men still on their own back row, guarding it against promotion
+        center        pieces (men and kings) on the 4 center squares (rows 3-4, columns 2-5)
+        tempo         rows advanced by the men, summed (the old "advancement")
+        mobility      empty squares reachable by one simple step (captures ignored)
+        runaway       men with no opposing piece anywhere in front of them on
+                      the way to promotion (see "runawayConeMask")
+
+    The first five only depend on which piece stands on which square, so they
+    are kept in "GameState.eval_terms" and updated by MakeMove / UnmakeMove
+    from the generated "evalSquareTerms" table, the same way as "zobrist_key":
+    a move touches the FROM and TO squares and the captured squares, nothing is
+    counted again. Mobility and runaways depend on the empty squares between
+    pieces and are worked out from the bitboards when a position is scored,
+    only when their weight is not 0.
+
+    The score is the sum of weight * feature, for the player to move. The
+    default weights keep the values of "evalbatch.h" (EVAL_MAN_VALUE,
+    EVAL_KING_VALUE, EVAL_ADVANCE_VALUE) for material and tempo.
+
+    Weight file ("--weights FILE" of "selfplay" and "engine"): one "name value"
+    pair per line with the names above, "#" starts a comment. Names left out
+    keep their default, so a file may change a single weight. Values are
+    limited to EVAL_WEIGHT_LIMIT either way, and the score itself to
+    EVAL_SCORE_LIMIT, so the search can always tell a static score from a
+    tablebase win or a won game:
+
+        # stronger back rank
+        back_rank 12
+
+    "./microbench --filter Evaluate" times the evaluation, with the kept
+    features and counted from scratch.
+*/
+
+// features worked out from the bitboards when a position is scored
+#define EVAL_TERM_MOBILITY 5 // simple-step squares
+#define EVAL_TERM_RUNAWAY 6 // men with a free path to promotion
+#define EVAL_TERMS 7 // number of features (and weights)
+
+// largest weight a weight file may give (either sign), 10 times a man
+#define EVAL_WEIGHT_LIMIT 1000
+
+// largest static score (either sign), well below SEARCH_TB_WIN_SCORE so that no
+// weights can make an ordinary position look like a tablebase win or a won game
+#define EVAL_SCORE_LIMIT 9000
+
+// weight of each feature (EVAL_TERM_*), in points (a man is worth 100 by default)
+typedef struct
+{
+    int values[EVAL_TERMS]; // weight * feature is added to the score
+} EvalWeights;
+
+// the weights the search uses when none are given
+extern const EvalWeights defaultEvalWeights;
+
+// Features //
+
+// work out "eval_terms" of "game" from its bitboards
+// use after changing the bitboards directly, MakeMove / UnmakeMove keep them up to date
+void ComputeEvalTerms(GameState* game);
+
+// fill "features" (EVAL_TERMS values, Red minus Black) for "game", mobility and runaways included
+void EvalFeatures(const GameState* game, int features[EVAL_TERMS]);
+
+// score "game" with "weights", from the point of view of the player to move
+// uses the "eval_terms" kept in "game", which must be up to date
+// the score is kept within -EVAL_SCORE_LIMIT to EVAL_SCORE_LIMIT
+int EvaluatePosition(const GameState* game, const EvalWeights* weights);
+
+// Weight Files //
+
+// name of feature / weight "term" in weight files ("man", "king", ...)
+const char* EvalTermName(int term);
+
+// read the weights of "filename" into "weights", starting from the defaults
+// a weight beyond EVAL_WEIGHT_LIMIT (either sign) makes its line invalid
+// returns 1 on success, otherwise 0 with "errorLine" set to the first invalid line
+// (0 if the file could not be opened), "weights" is then unchanged
+int LoadEvalWeights(const char* filename, EvalWeights* weights, int* errorLine);
+
+// write "weights" to "file" in the weight file format, one "name value" line each
+void WriteEvalWeights(FILE* file, const EvalWeights* weights);
+
+#endif
@@ -0,0 +1,61 @@
+// [filewalk.c] file
+
+// opendir / stat are POSIX, not part of plain C11
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h> // for reporting unreadable paths
+#include <dirent.h> // for reading directories
+#include <sys/stat.h> // for telling files and directories apart
+
+#include "filewalk.h" // declare "filewalk" methods
+
+// call "visit" for "path", or for every file below it when it is a directory
+int WalkFiles(const char* path, FileVisitor visit, void* context)
+{
+    struct stat info; // file or directory information
+    DIR* directory = NULL; // open directory being listed
+    struct dirent* entry = NULL; // current directory entry
+    int errors = 0; // unreadable paths found
+
+    // qualifier: the path must exist
+    if (stat(path, &info) != 0)
+    {
+        fprintf(stderr, "Could not read: %s\n", path);
+        return 1;
+    }
+
+    // qualifier: a regular file is visited directly
+    if (!S_ISDIR(info.st_mode))
+    {
+        visit(path, context);
+        return 0;
+    }
+
+    // otherwise, walk the directory
+    directory = opendir(path);
+    if (directory == NULL)
+    {
+        fprintf(stderr, "Could not open directory: %s\n", path);
+        return 1;
+    }
+
+    while ((entry = readdir(directory)) != NULL)
+    {
+        char child[WALK_PATH_MAX]; // path of this entry
+        int length = 0; // characters in "child"
+
+        // qualifier: skip ".", ".." and hidden files
+        if (entry->d_name[0] == '.') { continue; }
+
+        length = snprintf(child, sizeof(child), "%s/%s", path, entry->d_name);
+        if (length < 0 || length >= (int)sizeof(child))
+        {
+            fprintf(stderr, "Path too long, skipped: %s/%s\n", path, entry->d_name);
+            errors++;
+            continue;
+        }
+        errors = errors + WalkFiles(child, visit, context);
+    }
+    closedir(directory);
+    return errors;
+}
@@ -0,0 +1,29 @@
+// [filewalk.h] header file
+// function declarations for "filewalk.c"
+// implemented in "analyze.c" / "posdbtool.c"
+
+#ifndef FILEWALK_H
+#define FILEWALK_H
+
+// { Phase 4 - Batch Tools } //
+// shared directory walk for the tools that read many save files
+
+/*
+    WalkFiles visits a single file directly, or every file below a directory
+    including its sub-folders. Names starting with "." (hidden files and the
+    "." / ".." entries) are skipped. Only one directory listing is open per
+    folder level, so walking millions of files uses no extra memory.
+*/
+
+// longest path WalkFiles builds, longer paths are reported and skipped
+#define WALK_PATH_MAX 4096
+
+// called once for every file found, "context" is passed through unchanged
+typedef void (*FileVisitor)(const char* path, void* context);
+
+// call "visit" for "path", or for every file below it when it is a directory
+// problems (missing path, unreadable directory, path too long) are printed to stderr
+// returns the number of paths that could not be read
+int WalkFiles(const char* path, FileVisitor visit, void* context);
+
+#endif
@@ -23,6 +23,14 @@
     move/capture logic, turn management, and win conditions 
 */
 
+// piece-square evaluation features kept in GameState, Red minus Black (see "evaluate.h")
+#define EVAL_TERM_MEN 0 // men
+#define EVAL_TERM_KINGS 1 // kings
+#define EVAL_TERM_BACK_RANK 2 // men still guarding their own back row
+#define EVAL_TERM_CENTER 3 // pieces on the 4 center squares
+#define EVAL_TERM_TEMPO 4 // rows advanced by the men, summed
+#define EVAL_SQUARE_TERMS 5 // number of features kept in GameState
+
 // "Approach 2: More Detailed" - structure to track the current game state //
 typedef struct 
 {
@@ -37,12 +45,20 @@ typedef struct
     // present whose current turn by either 1 or 2 
     // Player 1 Red = 1 OR Player 2 Black = 2
     int current_turn; 
+
+    // 64-bit Zobrist key of the position (pieces and current_turn), see "zobrist.h"
+    // set by SetBoard / LoadGame and kept up to date by MakeMove / UnmakeMove
+    unsigned long long zobrist_key;
+
+    // evaluation features that only depend on which piece stands where (EVAL_TERM_*)
+    // set together with "zobrist_key" (ComputeEvalTerms) and kept up to date by MakeMove / UnmakeMove
+    int eval_terms[EVAL_SQUARE_TERMS];
 } GameState; // structure used for all gameplay operations
 
 // Initialize Board and Display //
 
 // initialize the board when new game, pieces assume starting positions,
-// "current_turn" set to 1 (Player 1 Red) at the start
+// "current_turn" set to 1 (Player 1 Red) at the start, "zobrist_key" and "eval_terms" computed
 void SetBoard(GameState* game);
 
 // print an ASCII representation of the board
@@ -73,9 +89,17 @@ int PieceBelongToPlayer(const GameState* game, int position);
 
 // Player Move and Turn Functions //
 
+// record of an applied move, defined in "movegen.h"
+struct MoveRecord;
+
 // attempts to read a move or capture, for "FROM" to "TO" position
+// a multi-jump capture is entered with its final landing square as "TO"
+// captures are mandatory, a simple step is rejected while any capture exists
+// so is a FROM / TO pair matching two capture chains (see FindMovesBetween in "movegen.h")
+// on success the move is applied and the turn passes to the other player,
+// nothing is printed, "record" (may be NULL) receives the captures and promotion to report
 // return 1 if valid move and proceed with the action, otherwise 0
-int TryMove(GameState* game, int fromPosition, int toPosition);
+int TryMove(GameState* game, int fromPosition, int toPosition, struct MoveRecord* record);
 
 // check which player’s turn it currently is
 // returns 1 if Player 1’s turn
@@ -98,4 +122,12 @@ int CheckLegalMoves(const GameState* game);
 // return 0 if no winner yet
 int CheckWinner(const GameState* game);
 
+// Position Checks //
+
+// check that a position (for example one read from a file) could occur in a game:
+// pieces only on dark squares, one piece per square, at most 12 pieces per player,
+// no man on its own promotion row, and "current_turn" 1 or 2
+// returns NULL when it could, otherwise a short description of the first problem found
+const char* PositionProblem(const GameState* game);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,671 @@
+// [gamerecord.c] file
+
+#include <stdio.h> // for reading and writing PDN files
+#include <stdlib.h> // for realloc / free / strtol
+#include <string.h> // for strcmp / strlen / memset
+
+#include "gamerecord.h" // declare "gamerecord", "game" and "movegen" variables/methods
+#include "board32.h" // 32-square sets and the 1-32 square numbers
+#include "bitoperations.h" // PopLowestBit64 / PopCount64 for the captured squares
+#include "zobrist.h" // position key updates of undone moves
+#include "movetables.h" // evaluation features of a piece on a square, for undone moves
+#include "evaluate.h" // ComputeEvalTerms for FEN positions
+
+// moves a new record has room for, doubled whenever it is full
+#define RECORD_START_MOVES 128
+
+// longest PDN token (a move, a result, a move number) and tag value read
+#define PDN_TOKEN_MAX 128
+
+// a PDN movetext line is wrapped before this many characters
+#define PDN_LINE_WIDTH 79
+
+// Packed Moves //
+
+// method to expand the captured squares of "packed" into a bitboard, and its captured kings into "kings"
+static unsigned long long UnpackCaptured(const PackedMove* packed, unsigned long long* kings)
+{
+    unsigned long long captured = ExpandBoard(packed->captured); // captured squares (0-63)
+    unsigned long long left = captured; // captured squares not looked at yet
+    unsigned int flag = 1u; // bit of the current captured square in "packed->kings"
+
+    *kings = 0ull;
+    while (left != 0ull)
+    {
+        int square = PopLowestBit64(&left); // next captured square, in increasing order
+
+        if ((packed->kings & flag) != 0u) { *kings |= (1ull << square); }
+        flag <<= 1;
+    }
+    return captured;
+}
+
+// method to build the Move that "packed" describes (no capture path, only FROM, TO and the captured squares)
+static void UnpackMove(const PackedMove* packed, Move* move, unsigned long long* kings)
+{
+    memset(move, 0, sizeof(*move));
+    move->from = packed->from;
+    move->to = packed->to;
+    move->captured = UnpackCaptured(packed, kings);
+    move->jumps = PopCount64(move->captured);
+}
+
+// pack the move described by "record" (filled by MakeMove)
+void PackMove(const MoveRecord* record, PackedMove* packed)
+{
+    unsigned long long left = record->move.captured; // captured squares not looked at yet
+    unsigned int flag = 1u; // bit of the current captured square
+
+    packed->captured = CompressBoard(record->move.captured);
+    packed->kings = 0u;
+    packed->from = (unsigned char)record->move.from;
+    packed->to = (unsigned char)record->move.to;
+
+    while (left != 0ull)
+    {
+        int square = PopLowestBit64(&left); // next captured square, in increasing order
+
+        if ((record->capturedKings & (1ull << square)) != 0ull) { packed->kings |= (unsigned short)flag; }
+        flag <<= 1;
+    }
+    if (record->movedKing) { packed->kings |= PACKED_MOVED_KING; }
+    if (record->promoted) { packed->kings |= PACKED_PROMOTED; }
+}
+
+// method to add the evaluation features of a piece of Zobrist "type" on "square" to "terms", times "sign" (1 or -1)
+static void AddPieceTerms(int* terms, int type, int square, int sign)
+{
+    const signed char* features = evalSquareTerms[type][square]; // features of the piece
+    int term = 0; // loop iterator for the features
+
+    for (term = 0; term < EVAL_SQUARE_TERMS; term++) { terms[term] += sign * features[term]; }
+}
+
+// play "packed" on "game", which must be the position it was recorded in
+void RedoPackedMove(GameState* game, const PackedMove* packed)
+{
+    Move move; // FROM, TO and captured squares
+    unsigned long long kings = 0ull; // captured kings, MakeMove finds them on the board itself
+
+    UnpackMove(packed, &move, &kings);
+    ApplyMove(game, &move);
+}
+
+// take "packed" back on "game", which must be the position right after it
+void UndoPackedMove(GameState* game, const PackedMove* packed)
+{
+    MoveRecord record; // what MakeMove would have recorded
+    unsigned long long captured = 0ull; // captured squares left to hash
+    int player = 3 - game->current_turn; // player who made the move
+    int menType = (player == 1) ? ZOBRIST_P2_MEN : ZOBRIST_P1_MEN; // Zobrist type of the captured men
+    int kingsType = (player == 1) ? ZOBRIST_P2_KINGS : ZOBRIST_P1_KINGS; // Zobrist type of the captured kings
+    int moverType = (player == 1) ? ZOBRIST_P1_MEN : ZOBRIST_P2_MEN; // Zobrist type of the piece before the move
+    int landType = moverType; // Zobrist type of the piece after the move
+    unsigned long long key = game->zobrist_key ^ zobristTurn; // key, the same XORs as MakeMove undo themselves
+    int* terms = record.previousTerms; // features before the move, MakeMove's updates taken back
+
+    UnpackMove(packed, &record.move, &record.capturedKings);
+    record.player = player;
+    record.movedKing = (packed->kings & PACKED_MOVED_KING) != 0u;
+    record.promoted = (packed->kings & PACKED_PROMOTED) != 0u;
+    memcpy(terms, game->eval_terms, sizeof(record.previousTerms));
+
+    // qualifier: a king stays a king, a promoted man lands as a king
+    if (record.movedKing) { moverType++; }
+    if (record.movedKing || record.promoted) { landType++; }
+    key = key ^ zobristPieces[moverType][record.move.from] ^ zobristPieces[landType][record.move.to];
+    AddPieceTerms(terms, moverType, record.move.from, 1);
+    AddPieceTerms(terms, landType, record.move.to, -1);
+
+    // every captured piece comes back, as a man or a king
+    captured = record.move.captured;
+    while (captured != 0ull)
+    {
+        int square = PopLowestBit64(&captured); // next captured square (cleared from "captured")
+        int type = ((record.capturedKings & (1ull << square)) != 0ull) ? kingsType : menType; // Zobrist type of the captured piece
+
+        key = key ^ zobristPieces[type][square];
+        AddPieceTerms(terms, type, square, 1);
+    }
+
+    record.previousKey = key;
+    UnmakeMove(game, &record);
+}
+
+// Records //
+
+// start an empty record from "start"
+void InitGameRecord(GameRecord* record, const GameState* start)
+{
+    record->moves = NULL;
+    record->capacity = 0;
+    ResetGameRecord(record, start);
+}
+
+// drop every move and start again from "start", the memory is kept
+void ResetGameRecord(GameRecord* record, const GameState* start)
+{
+    record->start = *start;
+    record->count = 0;
+    record->ply = 0;
+    record->result = RECORD_RESULT_UNKNOWN;
+}
+
+// release the memory of a record
+void FreeGameRecord(GameRecord* record)
+{
+    free(record->moves);
+    record->moves = NULL;
+    record->capacity = 0;
+    record->count = 0;
+    record->ply = 0;
+}
+
+// add the move described by "move" at the current ply, dropping the moves that could still be redone
+int AddRecordMove(GameRecord* record, const MoveRecord* move)
+{
+    // qualifier: grow the move list when it is full
+    if (record->ply == record->capacity)
+    {
+        int capacity = (record->capacity == 0) ? RECORD_START_MOVES : record->capacity * 2; // new room
+        PackedMove* moves = (PackedMove*)realloc(record->moves, (size_t)capacity * sizeof(PackedMove)); // grown list
+
+        if (moves == NULL) { return 0; }
+        record->moves = moves;
+        record->capacity = capacity;
+    }
+
+    PackMove(move, &record->moves[record->ply]);
+    record->ply++;
+    record->count = record->ply;
+    record->result = RECORD_RESULT_UNKNOWN;
+    return 1;
+}
+
+// take the last applied move back on "game"
+int UndoRecordMove(GameRecord* record, GameState* game)
+{
+    if (record->ply == 0) { return 0; }
+    record->ply--;
+    UndoPackedMove(game, &record->moves[record->ply]);
+    return 1;
+}
+
+// play the next recorded move again on "game"
+int RedoRecordMove(GameRecord* record, GameState* game)
+{
+    if (record->ply == record->count) { return 0; }
+    RedoPackedMove(game, &record->moves[record->ply]);
+    record->ply++;
+    return 1;
+}
+
+// bring "game" to ply "ply", from the current ply or from the start, whichever is closer
+int GoToRecordPly(GameRecord* record, GameState* game, int ply)
+{
+    int distance = (ply > record->ply) ? ply - record->ply : record->ply - ply; // steps from the current ply
+
+    if (ply < 0 || ply > record->count) { return 0; }
+
+    // qualifier: replaying from the start is shorter when the target is near the beginning
+    if (ply < distance)
+    {
+        ReplayRecord(record, ply, game);
+        record->ply = ply;
+        return 1;
+    }
+
+    while (record->ply > ply) { UndoRecordMove(record, game); }
+    while (record->ply < ply) { RedoRecordMove(record, game); }
+    return 1;
+}
+
+// write the position after the first "ply" moves into "game", replaying from the start
+void ReplayRecord(const GameRecord* record, int ply, GameState* game)
+{
+    int i = 0; // loop iterator for the moves
+
+    if (ply < 0) { ply = 0; }
+    if (ply > record->count) { ply = record->count; }
+
+    *game = record->start;
+    for (i = 0; i < ply; i++) { RedoPackedMove(game, &record->moves[i]); }
+}
+
+// PDN Writing //
+
+// method to find the legal move of "game" that "packed" describes, with its full capture path
+// returns 1 and fills "move" if it is legal, otherwise 0
+static int FindPackedMove(const GameState* game, const PackedMove* packed, Move* move)
+{
+    MoveList list; // legal moves of "game"
+    unsigned long long kings = 0ull; // unused, the captured squares are enough
+    unsigned long long captured = UnpackCaptured(packed, &kings); // captured squares
+    int i = 0; // loop iterator for the legal moves
+
+    GenerateMoves(game, &list);
+    for (i = 0; i < list.count; i++)
+    {
+        if (list.moves[i].from == packed->from && list.moves[i].to == packed->to && list.moves[i].captured == captured)
+        {
+            *move = list.moves[i];
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// method to write a move with the 1-32 square numbers into "buffer" ("9-13" or "18x11x4")
+static void PdnMoveText(const Move* move, char* buffer, size_t size)
+{
+    int length = 0; // characters written so far
+    int i = 0; // loop iterator for the capture path
+
+    if (move->jumps == 0)
+    {
+        snprintf(buffer, size, "%d-%d", IndexToSquare(move->from), IndexToSquare(move->to));
+        return;
+    }
+
+    length = snprintf(buffer, size, "%d", IndexToSquare(move->from));
+    for (i = 0; i < move->jumps && length > 0 && (size_t)length < size; i++)
+    {
+        length = length + snprintf(buffer + length, size - (size_t)length, "x%d", IndexToSquare(move->path[i]));
+    }
+}
+
+// method to write the pieces of one side as a FEN list ("W18,21,K32") to "file"
+static int WriteFenSide(FILE* file, char side, unsigned long long men, unsigned long long kings)
+{
+    int first = 1; // flagger cleared after the first square
+    int square = 0; // loop iterator for the 32 squares
+
+    if (fprintf(file, "%c", side) < 0) { return 0; }
+    for (square = 1; square <= BOARD32_SQUARES; square++)
+    {
+        unsigned long long mask = 1ull << SquareToIndex(square); // bit of the square
+
+        if (((men | kings) & mask) == 0ull) { continue; }
+        if (fprintf(file, "%s%s%d", first ? "" : ",", ((kings & mask) != 0ull) ? "K" : "", square) < 0) { return 0; }
+        first = 0;
+    }
+    return 1;
+}
+
+// write the [FEN] tag of "game" to "file"
+int WriteFenTag(FILE* file, const GameState* game)
+{
+    int written = 1; // flagger cleared if any write fails
+
+    if (fprintf(file, "[FEN \"%c:", (game->current_turn == 1) ? 'B' : 'W') < 0) { written = 0; }
+    if (!WriteFenSide(file, 'W', game->player2_men, game->player2_kings)) { written = 0; }
+    if (fprintf(file, ":") < 0) { written = 0; }
+    if (!WriteFenSide(file, 'B', game->player1_men, game->player1_kings)) { written = 0; }
+    if (fprintf(file, "\"]\n") < 0) { written = 0; }
+    return written;
+}
+
+// write the game in "record" as one PDN game to "file"
+int WritePdnGame(FILE* file, const GameRecord* record)
+{
+    static const char* results[] = { "*", "1-0", "0-1", "1/2-1/2" }; // PDN text of each RECORD_RESULT_*
+    GameState game = record->start; // position of the move being written
+    GameState setup; // SetBoard position, the [FEN] tag is left out when the game starts there
+    int result = record->result; // result written
+    int column = 0; // characters on the current movetext line
+    int written = 1; // flagger cleared if any write fails
+    int i = 0; // loop iterator for the moves
+
+    SetBoard(&setup);
+
+    // qualifier: an unknown result is taken from the final position when the game is over
+    if (result == RECORD_RESULT_UNKNOWN)
+    {
+        ReplayRecord(record, record->count, &game);
+        result = CheckWinner(&game);
+        if (result == 0 && !CheckLegalMoves(&game)) { result = 3 - game.current_turn; }
+        game = record->start;
+    }
+
+    if (fprintf(file, "[Event \"Bit Board Checkers\"]\n[Black \"Player 1 (Red)\"]\n[White \"Player 2 (Black)\"]\n"
+        "[Result \"%s\"]\n", results[result]) < 0) { written = 0; }
+    if (game.player1_men != setup.player1_men || game.player1_kings != setup.player1_kings
+        || game.player2_men != setup.player2_men || game.player2_kings != setup.player2_kings
+        || game.current_turn != setup.current_turn)
+    {
+        if (!WriteFenTag(file, &game)) { written = 0; }
+    }
+    if (fprintf(file, "\n") < 0) { written = 0; }
+
+    for (i = 0; i < record->count && written; i++)
+    {
+        Move move; // legal move with its capture path
+        char text[PDN_TOKEN_MAX]; // move number and move
+        int length = 0; // characters in "text"
+        char moveText[PDN_TOKEN_MAX]; // move alone
+
+        if (!FindPackedMove(&game, &record->moves[i], &move)) { return 0; }
+        PdnMoveText(&move, moveText, sizeof(moveText));
+
+        // qualifier: Red's moves carry the move number, a game that starts with Black's move uses "1..."
+        if (game.current_turn == 1) { length = snprintf(text, sizeof(text), "%d. %s", (i + (record->start.current_turn == 2)) / 2 + 1, moveText); }
+        else if (i == 0) { length = snprintf(text, sizeof(text), "1... %s", moveText); }
+        else { length = snprintf(text, sizeof(text), "%s", moveText); }
+
+        // qualifier: wrap the line before it gets too long
+        if (column > 0 && column + 1 + length > PDN_LINE_WIDTH)
+        {
+            if (fprintf(file, "\n") < 0) { written = 0; }
+            column = 0;
+        }
+        if (fprintf(file, "%s%s", (column > 0) ? " " : "", text) < 0) { written = 0; }
+        column = column + ((column > 0) ? 1 : 0) + length;
+
+        RedoPackedMove(&game, &record->moves[i]);
+    }
+
+    if (fprintf(file, "%s%s\n\n", (column > 0) ? " " : "", results[result]) < 0) { written = 0; }
+    return written;
+}
+
+// PDN Reading //
+
+// method to read the next character of "file", counting lines
+static int NextChar(FILE* file, int* line)
+{
+    int c = fgetc(file); // character read
+    if (c == '\n') { (*line)++; }
+    return c;
+}
+
+// method to skip everything up to and including "close", nested "open" / "close" pairs included
+static void SkipBlock(FILE* file, int* line, int open, int close)
+{
+    int depth = 1; // blocks still open
+    int c = 0; // character read
+
+    while (depth > 0 && (c = NextChar(file, line)) != EOF)
+    {
+        if (c == open) { depth++; }
+        else if (c == close) { depth--; }
+    }
+}
+
+// method to read a [Name "value"] tag after its "[" into "name" and "value" (PDN_TOKEN_MAX characters each)
+static void ReadTag(FILE* file, int* line, char* name, char* value)
+{
+    int length = 0; // characters stored
+    int c = NextChar(file, line); // character read
+
+    while (c == ' ' || c == '\t') { c = NextChar(file, line); }
+    while (c != EOF && c != ' ' && c != '\t' && c != '"' && c != ']')
+    {
+        if (length < PDN_TOKEN_MAX - 1) { name[length++] = (char)c; }
+        c = NextChar(file, line);
+    }
+    name[length] = '\0';
+
+    length = 0;
+    while (c != EOF && c != '"' && c != ']') { c = NextChar(file, line); }
+    if (c == '"')
+    {
+        c = NextChar(file, line);
+        while (c != EOF && c != '"')
+        {
+            if (length < PDN_TOKEN_MAX - 1) { value[length++] = (char)c; }
+            c = NextChar(file, line);
+        }
+    }
+    value[length] = '\0';
+
+    while (c != EOF && c != ']') { c = NextChar(file, line); }
+}
+
+// method to read one FEN side list ("W18,21,K32" or "B1-12") into "men" / "kings"
+// returns a pointer after the list, or NULL if it is invalid
+static const char* ReadFenSide(const char* text, unsigned long long* men, unsigned long long* kings)
+{
+    text++; // side letter, checked by the caller
+
+    while (*text != '\0' && *text != ':' && *text != '.' && *text != '"')
+    {
+        int king = 0; // flagger for a "K" prefix
+        long first = 0; // first square of the item
+        long last = 0; // last square of a range, "first" otherwise
+        char* end = NULL; // character after a number
+        long square = 0; // loop iterator for a range
+
+        if (*text == ',' || *text == ' ') { text++; continue; }
+        if (*text == 'K') { king = 1; text++; }
+
+        first = strtol(text, &end, 10);
+        if (end == text) { return NULL; }
+        last = first;
+        text = end;
+        if (*text == '-')
+        {
+            last = strtol(text + 1, &end, 10);
+            if (end == text + 1) { return NULL; }
+            text = end;
+        }
+        if (first < 1 || last > BOARD32_SQUARES || first > last) { return NULL; }
+
+        for (square = first; square <= last; square++)
+        {
+            if (king) { *kings |= 1ull << SquareToIndex((int)square); }
+            else { *men |= 1ull << SquareToIndex((int)square); }
+        }
+    }
+    return text;
+}
+
+// read a FEN tag value ("B:W18,21,K32:B1,2,3") into "game"
+int ReadFen(const char* text, GameState* game)
+{
+    GameState read; // position being built
+
+    memset(&read, 0, sizeof(read));
+    if (*text == 'B') { read.current_turn = 1; }
+    else if (*text == 'W') { read.current_turn = 2; }
+    else { return 0; }
+    text++;
+
+    while (*text == ':')
+    {
+        text++;
+        if (*text == 'W') { text = ReadFenSide(text, &read.player2_men, &read.player2_kings); }
+        else if (*text == 'B') { text = ReadFenSide(text, &read.player1_men, &read.player1_kings); }
+        else { return 0; }
+        if (text == NULL) { return 0; }
+    }
+    if (*text != '\0' && *text != '.') { return 0; }
+
+    read.zobrist_key = ComputeZobristKey(&read);
+    ComputeEvalTerms(&read);
+    if (PositionProblem(&read) != NULL) { return 0; }
+    *game = read;
+    return 1;
+}
+
+// method to find the legal move of "game" written with 1-32 square numbers ("9-13", "18x11", "18x11x4")
+// returns 1 and fills "move" if exactly one legal move matches, otherwise 0
+static int FindPdnMove(const GameState* game, const char* text, Move* move)
+{
+    int squares[MAX_JUMPS + 1]; // board indexes written in the move
+    int count = 0; // entries in "squares"
+    MoveList list; // legal moves of "game"
+    int matches = 0; // legal moves that fit the text
+    int i = 0; // loop iterator for the legal moves
+
+    // read every square number, separated by "-", "x" or ":"
+    while (*text != '\0')
+    {
+        char* end = NULL; // character after the number
+        long square = strtol(text, &end, 10); // square number (1-32)
+
+        if (end == text || square < 1 || square > BOARD32_SQUARES || count == MAX_JUMPS + 1) { return 0; }
+        squares[count++] = SquareToIndex((int)square);
+        text = end;
+        if (*text == '-' || *text == 'x' || *text == ':') { text++; }
+        else if (*text != '\0') { return 0; }
+    }
+    if (count < 2) { return 0; }
+
+    GenerateMoves(game, &list);
+    for (i = 0; i < list.count; i++)
+    {
+        const Move* legal = &list.moves[i]; // candidate move
+        int step = 0; // loop iterator for the written landing squares
+
+        if (legal->from != squares[0] || legal->to != squares[count - 1]) { continue; }
+
+        // qualifier: a full capture path must match every landing square
+        if (count > 2)
+        {
+            if (legal->jumps != count - 1) { continue; }
+            for (step = 1; step < count - 1; step++)
+            {
+                if (legal->path[step - 1] != squares[step]) { break; }
+            }
+            if (step < count - 1) { continue; }
+        }
+        *move = *legal;
+        matches++;
+    }
+    return matches == 1;
+}
+
+// method to read a result token ("1-0", "0-1", "1/2-1/2", "*", or the draughts "2-0" / "0-2" / "1-1")
+// returns its RECORD_RESULT_* number, or -1 when "token" is not a result
+static int ResultToken(const char* token)
+{
+    if (strcmp(token, "1-0") == 0 || strcmp(token, "2-0") == 0) { return RECORD_RESULT_RED; }
+    if (strcmp(token, "0-1") == 0 || strcmp(token, "0-2") == 0) { return RECORD_RESULT_BLACK; }
+    if (strcmp(token, "1/2-1/2") == 0 || strcmp(token, "1-1") == 0) { return RECORD_RESULT_DRAW; }
+    if (strcmp(token, "*") == 0) { return RECORD_RESULT_UNKNOWN; }
+    return -1;
+}
+
+// read the next PDN game of "file" into "record"
+int ReadPdnGame(FILE* file, GameRecord* record, int* line, const char** problem)
+{
+    GameState game; // position after the moves read so far
+    char token[PDN_TOKEN_MAX]; // current token
+    int started = 0; // flagger set once a tag or move of this game was read
+    int moves = 0; // flagger set once a move of this game was read
+    int c = 0; // character read
+
+    *problem = NULL;
+    SetBoard(&game);
+    ResetGameRecord(record, &game);
+
+    while ((c = NextChar(file, line)) != EOF)
+    {
+        int length = 0; // characters in "token"
+        int result = -1; // result token number
+        const char* text = token; // token without its move number
+        Move move; // move read
+        MoveRecord played; // move as played, for the record
+
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n') { continue; }
+        if (c == '{') { SkipBlock(file, line, '{', '}'); continue; }
+        if (c == '(') { SkipBlock(file, line, '(', ')'); continue; }
+        if (c == ';') { while (c != EOF && c != '\n') { c = NextChar(file, line); } continue; }
+
+        if (c == '[')
+        {
+            char value[PDN_TOKEN_MAX]; // tag value
+
+            // qualifier: a tag after the moves starts the next game, which had no result token
+            if (moves)
+            {
+                ungetc(c, file);
+                return 1;
+            }
+            ReadTag(file, line, token, value);
+            started = 1;
+            if (strcmp(token, "Result") == 0 && ResultToken(value) >= 0) { record->result = ResultToken(value); }
+            else if (strcmp(token, "FEN") == 0)
+            {
+                if (!ReadFen(value, &game))
+                {
+                    *problem = "invalid FEN tag";
+                    return 0;
+                }
+                ResetGameRecord(record, &game);
+            }
+            continue;
+        }
+
+        // read the token up to whitespace or the start of a comment, tag or variation
+        while (c != EOF && c != ' ' && c != '\t' && c != '\r' && c != '\n' && c != '{' && c != '(' && c != '[' && c != ';')
+        {
+            if (length < PDN_TOKEN_MAX - 1) { token[length++] = (char)c; }
+            c = fgetc(file);
+        }
+        if (c != EOF) { ungetc(c, file); }
+        token[length] = '\0';
+        started = 1;
+
+        // qualifier: a result ends the game
+        result = ResultToken(token);
+        if (result >= 0)
+        {
+            record->result = result;
+            return 1;
+        }
+
+        // qualifier: annotations ("$3") are skipped, move numbers ("12." / "12...") may be joined to the move
+        if (token[0] == '$') { continue; }
+        while (*text >= '0' && *text <= '9') { text++; }
+        if (*text == '.') { while (*text == '.') { text++; } }
+        else { text = token; }
+        length = (int)strlen(text);
+        while (length > 0 && (text[length - 1] == '!' || text[length - 1] == '?')) { length--; }
+        if (length == 0) { continue; }
+        memmove(token, text, (size_t)length);
+        token[length] = '\0';
+
+        if (!FindPdnMove(&game, token, &move))
+        {
+            *problem = "illegal or ambiguous move";
+            return 0;
+        }
+        MakeMove(&game, &move, &played);
+        if (!AddRecordMove(record, &played))
+        {
+            *problem = "out of memory";
+            return 0;
+        }
+        moves = 1;
+    }
+
+    // qualifier: a game without a result token still counts at the end of the file
+    return started;
+}
+
+// write "record" as a PDN file "filename", printing nothing
+int SavePdnFile(const char* filename, const GameRecord* record)
+{
+    FILE* file = fopen(filename, "w"); // PDN file
+    int written = 0; // flagger set if the game was written
+
+    if (file == NULL) { return 0; }
+    written = WritePdnGame(file, record);
+    if (fclose(file) != 0) { written = 0; }
+    return written;
+}
+
+// read the first game of the PDN file "filename" into "record", printing nothing
+int LoadPdnFile(const char* filename, GameRecord* record)
+{
+    FILE* file = fopen(filename, "r"); // PDN file
+    const char* problem = NULL; // why the game could not be read
+    int line = 1; // line counter
+    int read = 0; // flagger set if a game was read
+
+    if (file == NULL) { return 0; }
+    read = ReadPdnGame(file, record, &line, &problem);
+    fclose(file);
+    return read;
+}
@@ -0,0 +1,157 @@
+// [gamerecord.h] header file
+// function declarations for "gamerecord.c"
+// implemented in "recordtool.c" / "main.c"
+
+#ifndef GAMERECORD_H
+#define GAMERECORD_H
+
+#include <stdio.h> // for FILE (PDN reader and writer)
+
+#include "game.h" // implement GameState structure
+#include "movegen.h" // implement Move / MoveRecord structures
+
+// { Phase 4 - Game Records } //
+// keeps the moves of a game next to the GameState snapshot, with undo / redo,
+// replay to any ply, and PDN (Portable Draughts Notation) files
+
+/*
+    Every move is stored in 8 bytes (PackedMove):
+
+        bytes 0-3   captured squares, as a 32-square set (see "board32.h")
+        bytes 4-5   bits 0-11: which captured pieces were kings, one bit per
+                    captured square in increasing square order
+                    bit 14: the moving piece was a king
+                    bit 15: the move promoted a man
+        byte  6     FROM square (0-63)
+        byte  7     TO square (0-63)
+
+    That is everything MakeMove and UnmakeMove change, so a move is redone
+    or undone without generating any moves, and the position key is updated
+    with the same XORs MakeMove uses. Undo and redo are O(1); going to any
+    ply walks from the current ply or from the start, whichever is closer.
+
+    The record holds the moves up to "count"; "ply" of them are applied to
+    the game. Undo moves "ply" back and keeps the later moves for redo, a
+    new move after an undo drops them.
+
+    PDN files use the square numbers 1-32. Red moves first from squares
+    1-12, the side published games call Black ("B"), so Red is written as
+    [Black] and Black as [White]:
+
+        [Event "Bit Board Checkers"]
+        [Black "Player 1 (Red)"]
+        [White "Player 2 (Black)"]
+        [Result "1-0"]
+        [FEN "B:W18,21,K32:B1,2,3"]     (only when the game did not start from SetBoard)
+        1. 9-13 22-18 2. 11-15 18x11 3. 8x15 ... 1-0
+
+    "1-0" is a Red win, "0-1" a Black win, "1/2-1/2" a draw, "*" unknown.
+    The reader skips comments in {braces}, (variations), move numbers,
+    "!" / "?" marks and $ annotations. A capture may be written with its
+    first and last square only ("18x11") when no other capture shares them.
+*/
+
+// result of a recorded game, written as the PDN result
+#define RECORD_RESULT_UNKNOWN 0 // game not finished ("*")
+#define RECORD_RESULT_RED 1 // Player 1 (Red) won ("1-0")
+#define RECORD_RESULT_BLACK 2 // Player 2 (Black) won ("0-1")
+#define RECORD_RESULT_DRAW 3 // draw ("1/2-1/2")
+
+// flags in "PackedMove.kings"
+#define PACKED_CAPTURED_KINGS 0x0FFFu // one bit per captured square
+#define PACKED_MOVED_KING 0x4000u // the moving piece was a king
+#define PACKED_PROMOTED 0x8000u // the move promoted a man
+
+// one move of a recorded game, 8 bytes
+typedef struct
+{
+    unsigned int captured; // captured squares, 32-square set
+    unsigned short kings; // captured kings and the PACKED_* flags
+    unsigned char from; // FROM square (0-63)
+    unsigned char to; // TO square (0-63)
+} PackedMove;
+
+// moves of one game from its start position
+typedef struct
+{
+    GameState start; // position before the first move
+    PackedMove* moves; // every recorded move
+    int count; // moves in "moves"
+    int capacity; // room in "moves"
+    int ply; // moves currently applied to the game (0 - count), later moves can be redone
+    int result; // RECORD_RESULT_*, from a PDN file or set by the caller
+} GameRecord;
+
+// Packed Moves //
+
+// pack the move described by "record" (filled by MakeMove)
+void PackMove(const MoveRecord* record, PackedMove* packed);
+
+// play "packed" on "game", which must be the position it was recorded in
+void RedoPackedMove(GameState* game, const PackedMove* packed);
+
+// take "packed" back on "game", which must be the position right after it
+void UndoPackedMove(GameState* game, const PackedMove* packed);
+
+// Records //
+
+// start an empty record from "start"
+void InitGameRecord(GameRecord* record, const GameState* start);
+
+// drop every move and start again from "start", the memory is kept
+void ResetGameRecord(GameRecord* record, const GameState* start);
+
+// release the memory of a record
+void FreeGameRecord(GameRecord* record);
+
+// add the move described by "move" (just played by MakeMove / TryMove) at the current ply
+// moves that could still be redone are dropped first
+// returns 1 on success, 0 if memory ran out (the move is then not recorded)
+int AddRecordMove(GameRecord* record, const MoveRecord* move);
+
+// take the last applied move back on "game"
+// returns 1 if a move was undone, 0 if "game" is already at the start
+int UndoRecordMove(GameRecord* record, GameState* game);
+
+// play the next recorded move again on "game"
+// returns 1 if a move was redone, 0 if there is no later move
+int RedoRecordMove(GameRecord* record, GameState* game);
+
+// bring "game" to ply "ply" (0 - count), from the current ply or from the start, whichever is closer
+// returns 1 on success, 0 if "ply" is outside 0 - count ("game" is then unchanged)
+int GoToRecordPly(GameRecord* record, GameState* game, int ply);
+
+// write the position after the first "ply" moves into "game", replaying from the start
+// "ply" is clamped to 0 - count, the record itself is not changed
+void ReplayRecord(const GameRecord* record, int ply, GameState* game);
+
+// PDN Files //
+
+// write the game in "record" as one PDN game (tags and moves) to "file"
+// the result is "record->result", or worked out from the final position when it is unknown
+// returns 1 on success, 0 if a recorded move is not legal in its position or a write failed
+int WritePdnGame(FILE* file, const GameRecord* record);
+
+// read the next PDN game of "file" into "record" (its previous moves are dropped)
+// "line" counts the lines read, it gives the line of a problem when 0 is returned
+// returns 1 if a game was read, 0 at the end of the file or on an illegal move or bad FEN tag
+// ("line" is then set and "problem" points to a short description, NULL at the end of the file)
+int ReadPdnGame(FILE* file, GameRecord* record, int* line, const char** problem);
+
+// write "record" as a PDN file "filename", printing nothing
+// returns 1 on success, 0 if the file could not be written
+int SavePdnFile(const char* filename, const GameRecord* record);
+
+// read the first game of the PDN file "filename" into "record", printing nothing
+// returns 1 on success, 0 if the file could not be opened or held no valid game
+int LoadPdnFile(const char* filename, GameRecord* record);
+
+// write the [FEN "..."] tag line of "game" to "file", also used by the self-play game records
+// returns 1 on success, 0 if a write failed
+int WriteFenTag(FILE* file, const GameState* game);
+
+// read a FEN tag value ("B:W18,21,K32:B1,2,3", without the quotes) into "game"
+// returns 1 on success, 0 if the value is not a valid position ("game" is then unchanged)
+int ReadFen(const char* text, GameState* game);
+
+#endif
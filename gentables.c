@@ -0,0 +1,235 @@
+// [gentables.c] file
+// build step: writes the move and evaluation lookup tables in "movetables.c"
+
+/*
+    Run by the Makefile before the game is compiled:
+
+        ./gentables movetables.c
+
+    Every table declared in "movetables.h" is worked out here once, with the
+    row / column arithmetic the move code used to repeat on every call, and
+    written out as constant C arrays. The game itself only indexes them.
+
+    Directions follow "movegen.c":
+        0 Down-Right (+9), 1 Down-Left (+7)   forward for Player 1 (Red)
+        2 Up-Right (-7),   3 Up-Left (-9)     forward for Player 2 (Black)
+*/
+
+#include <stdio.h> // for writing the generated file
+
+#include "game.h" // EVAL_TERM_* order of the evaluation features
+
+// row and column change of one diagonal step in each direction
+static const int rowStep[4] = { 1, 1, -1, -1 };
+static const int colStep[4] = { 1, -1, 1, -1 };
+
+// method to find the square "steps" diagonal steps from "square" in "direction"
+// returns the index (0-63), or -1 if the path leaves the board
+static int Walk(int square, int direction, int steps)
+{
+    int row = square / 8 + rowStep[direction] * steps; // row after the steps
+    int col = square % 8 + colStep[direction] * steps; // column after the steps
+
+    // qualifier: the path has to stay on the 8 x 8 board
+    if (row < 0 || row > 7 || col < 0 || col > 7) { return -1; }
+    return row * 8 + col;
+}
+
+// method to check if "square" is a playable dark square ("#"), where (row + col) is odd
+static int IsDark(int square)
+{
+    return ((square / 8 + square % 8) % 2) == 1;
+}
+
+// method to turn a square (or -1) into a single bit mask (or 0)
+static unsigned long long SquareMask(int square)
+{
+    if (square < 0) { return 0ull; }
+    return 1ull << square;
+}
+
+// method to write one [64][4] table of square indexes
+// "steps" is 1 for neighbors and 2 for jump landing squares
+static void WriteSquareTable(FILE* out, const char* name, int steps)
+{
+    int square = 0; // loop iterator for the 64 squares
+
+    fprintf(out, "const signed char %s[64][4] =\n{\n", name);
+    for (square = 0; square < 64; square++)
+    {
+        int d = 0; // loop iterator for the 4 directions
+
+        fprintf(out, "    {");
+        for (d = 0; d < 4; d++)
+        {
+            // qualifier: light squares never hold a piece, leave them empty
+            int target = IsDark(square) ? Walk(square, d, steps) : -1;
+            fprintf(out, " %3d%s", target, (d < 3) ? "," : " ");
+        }
+        fprintf(out, "}%s // square %d\n", (square < 63) ? "," : "", square);
+    }
+    fprintf(out, "};\n\n");
+}
+
+// method to write one [64][4] table of bit masks
+// "steps" picks the square the mask holds, "needLanding" keeps it only when the jump lands on the board
+static void WriteMaskTable(FILE* out, const char* name, int steps, int needLanding)
+{
+    int square = 0; // loop iterator for the 64 squares
+
+    fprintf(out, "const unsigned long long %s[64][4] =\n{\n", name);
+    for (square = 0; square < 64; square++)
+    {
+        int d = 0; // loop iterator for the 4 directions
+
+        fprintf(out, "    {");
+        for (d = 0; d < 4; d++)
+        {
+            unsigned long long mask = 0ull; // bit of the target square
+
+            // qualifier: light squares never hold a piece, and a jump needs a landing square
+            if (IsDark(square) && (!needLanding || Walk(square, d, 2) >= 0)) { mask = SquareMask(Walk(square, d, steps)); }
+            fprintf(out, " 0x%016llXull%s", mask, (d < 3) ? "," : " ");
+        }
+        fprintf(out, "}%s // square %d\n", (square < 63) ? "," : "", square);
+    }
+    fprintf(out, "};\n\n");
+}
+
+// method to write the evaluation features of every piece type on every square
+// types in Zobrist order (Red men, Red kings, Black men, Black kings), Black pieces count negative
+static void WriteEvalTermTable(FILE* out)
+{
+    int type = 0; // loop iterator for the piece types
+
+    fprintf(out, "const signed char evalSquareTerms[4][64][EVAL_SQUARE_TERMS] =\n{\n");
+    for (type = 0; type < 4; type++)
+    {
+        int red = (type < 2); // flagger for the Red piece types
+        int king = (type % 2 == 1); // flagger for the king piece types
+        int sign = red ? 1 : -1; // Red minus Black
+        int square = 0; // loop iterator for the 64 squares
+
+        fprintf(out, "    {\n");
+        for (square = 0; square < 64; square++)
+        {
+            int row = square / 8; // row of the square
+            int col = square % 8; // column of the square
+            int terms[EVAL_SQUARE_TERMS] = { 0 }; // features of a piece on this square
+            int term = 0; // loop iterator for the features
+
+            // qualifier: light squares never hold a piece, leave them empty
+            if (IsDark(square))
+            {
+                terms[EVAL_TERM_MEN] = king ? 0 : sign;
+                terms[EVAL_TERM_KINGS] = king ? sign : 0;
+
+                // Red's back row is row 0 and Black's is row 7, men there stop the other side promoting
+                if (!king && row == (red ? 0 : 7)) { terms[EVAL_TERM_BACK_RANK] = sign; }
+
+                // the center: rows 3 - 4, columns 2 - 5
+                if (row >= 3 && row <= 4 && col >= 2 && col <= 5) { terms[EVAL_TERM_CENTER] = sign; }
+
+                // Red men advance "down" (towards row 7), Black men advance "up" (towards row 0)
+                if (!king) { terms[EVAL_TERM_TEMPO] = sign * (red ? row : 7 - row); }
+            }
+
+            fprintf(out, "        {");
+            for (term = 0; term < EVAL_SQUARE_TERMS; term++)
+            {
+                fprintf(out, " %2d%s", terms[term], (term < EVAL_SQUARE_TERMS - 1) ? "," : " ");
+            }
+            fprintf(out, "}%s // square %d\n", (square < 63) ? "," : "", square);
+        }
+        fprintf(out, "    }%s\n", (type < 3) ? "," : "");
+    }
+    fprintf(out, "};\n\n");
+}
+
+// method to write the runaway cones of a man of each player on each square
+// the cone holds every dark square up to the promotion row within as many columns as rows away
+static void WriteConeTable(FILE* out)
+{
+    int player = 0; // loop iterator for the players, [0] stays empty
+
+    fprintf(out, "const unsigned long long runawayConeMask[3][64] =\n{\n");
+    for (player = 0; player < 3; player++)
+    {
+        int square = 0; // loop iterator for the 64 squares
+
+        fprintf(out, "    {\n");
+        for (square = 0; square < 64; square++)
+        {
+            unsigned long long cone = 0ull; // squares in front of the man
+            int target = 0; // loop iterator for the squares in front
+
+            for (target = 0; target < 64; target++)
+            {
+                // rows ahead: down for Red, up for Black
+                int ahead = (player == 1) ? target / 8 - square / 8 : square / 8 - target / 8;
+                int sideways = target % 8 - square % 8; // columns away
+
+                if (sideways < 0) { sideways = -sideways; }
+                if (player != 0 && IsDark(square) && IsDark(target) && ahead > 0 && sideways <= ahead) { cone = cone | SquareMask(target); }
+            }
+            fprintf(out, "        0x%016llXull%s // square %d\n", cone, (square < 63) ? "," : "", square);
+        }
+        fprintf(out, "    }%s\n", (player < 2) ? "," : "");
+    }
+    fprintf(out, "};\n\n");
+}
+
+// method for writing the generated file (entry point)
+int main(int argc, char* argv[])
+{
+    FILE* out = NULL; // generated source file
+    unsigned long long dark = 0ull; // every dark square
+    unsigned long long row0 = 0ull; // Black's promotion row
+    unsigned long long row7 = 0ull; // Red's promotion row
+    int square = 0; // loop iterator for the 64 squares
+
+    // qualifier: the output file name is required
+    if (argc != 2)
+    {
+        fprintf(stderr, "Usage: %s <output.c>\n", argv[0]);
+        return 1;
+    }
+
+    out = fopen(argv[1], "w");
+    if (out == NULL)
+    {
+        fprintf(stderr, "Could not write \"%s\".\n", argv[1]);
+        return 1;
+    }
+
+    for (square = 0; square < 64; square++)
+    {
+        if (IsDark(square)) { dark = dark | SquareMask(square); }
+        if (square / 8 == 0) { row0 = row0 | SquareMask(square); }
+        if (square / 8 == 7) { row7 = row7 | SquareMask(square); }
+    }
+
+    fprintf(out, "// [movetables.c] file\n");
+    fprintf(out, "// generated by \"gentables.c\" during the build, do not edit\n\n");
+    fprintf(out, "#include \"movetables.h\" // declare the lookup tables\n\n");
+    fprintf(out, "const unsigned long long darkSquareMask = 0x%016llXull;\n\n", dark);
+    fprintf(out, "const unsigned long long promotionRowMask[3] = { 0x%016llXull, 0x%016llXull, 0x%016llXull };\n\n",
+        0ull, row7, row0);
+
+    WriteSquareTable(out, "neighborSquare", 1);
+    WriteMaskTable(out, "neighborMask", 1, 0);
+    WriteSquareTable(out, "jumpLandingSquare", 2);
+    WriteMaskTable(out, "jumpLandingMask", 2, 0);
+    WriteMaskTable(out, "jumpOverMask", 1, 1);
+    WriteEvalTermTable(out);
+    WriteConeTable(out);
+
+    // qualifier: report a failed write instead of leaving a broken table behind
+    if (ferror(out) || fclose(out) != 0)
+    {
+        fprintf(stderr, "Could not write \"%s\".\n", argv[1]);
+        remove(argv[1]);
+        return 1;
+    }
+    return 0;
+}
@@ -30,28 +30,54 @@ After the initial setup, there is no further need to access or configure MSYS2 M
 */
 
 #include <stdio.h> // for printing and reading files
+#include <stdlib.h> // for atoi (command line options)
 #include <string.h> // string functions for input handling
 #include <stdint.h> // for uint32_t (bitboard pieces)
+#include <time.h> // for time (seed of the book move choice)
 
 #include "bitoperations.h" // bit manipulation functions (Phase 1 - Test Functions)
 #include "game.h" // GameState structure and game functions
+#include "movegen.h" // legal move generation
 #include "consoleUI.h" // console UI functions
 #include "saveload.h" // save/load functions
-
-// method for switching turns between players using "current_turn" flagger
-static void SwitchTurn(GameState* game) 
+#include "search.h" // computer opponent search
+#include "analyze.h" // batch analysis of save files
+#include "posdbtool.h" // save file / position database converters
+#include "tbgen.h" // endgame tablebase generator and lookup
+#include "tablebase.h" // endgame tablebase for the computer opponent
+#include "booktool.h" // opening book builder and lookup
+#include "book.h" // opening book for the computer opponent
+#include "gamerecord.h" // move history with undo / redo and PDN files
+#include "recordtool.h" // replay of PDN game files
+#include "engine.h" // line protocol for GUIs and test harnesses
+#include "scriptplay.h" // scripted moves without the menu
+#include "render.h" // buffered boards and the ANSI in-place board
+#include "stats.h" // game core counters of instrumented builds ("make STATS=1")
+
+// time the computer opponent may think about each move, in milliseconds
+#define COMPUTER_TIME_MS 100
+
+// size of the computer opponent's transposition table, in MB
+#define COMPUTER_TABLE_MB 16
+
+// board kept at the top of the terminal by "--ansi", NULL when boards are printed in the scrolling text
+static RenderScreen* ansiScreen = NULL;
+
+// method to print the board of "game"
+// with "--ansi" only the squares changed since the last board are redrawn in place
+static void ShowBoard(const GameState* game)
 {
-    // qualifier: if current turn is Player 1 (Red) then switch to Player 2 (Black)
-    if (game->current_turn == 1) 
-    {
-        game->current_turn = 2;
-    }
+    char frame[RENDER_ANSI_SIZE]; // ANSI codes of the changed squares
+    RenderBuffer buffer; // frame being built
 
-    // otherwise, switch to Player 1 (Red), if current turn is Player 2 (Black)
-    else 
+    if (ansiScreen == NULL)
     {
-        game->current_turn = 1;
+        PrintBoardPretty(game);
+        return;
     }
+    RenderInit(&buffer, frame, sizeof(frame));
+    RenderBoardAnsi(&buffer, ansiScreen, game);
+    RenderPrint(&buffer, stdout);
 }
 
 // Bit Operations Demo (Phase 1 - Test Functions) menu and options
@@ -320,20 +346,475 @@ static int ValidateFromMovement(const GameState* game, int fromPosition)
     return 1; // piece belongs to current player
 }
 
+// method to validate the "toPosition" entered by user for moving a piece
+static int ValidateToMovement(const GameState* game, int fromPosition, int toPosition) 
+{
+    // qualifier: if toPosition is not a valid dark square, print error and return 0
+    if (!IsValidDarkSquare(toPosition)) 
+    {
+        printf("That is not a playable \"#\" dark square! Try another spot.\n");
+        return 0;
+    }
+
+    // qualifier: TO can only be the same square as FROM for a king's capture chain that
+    // ends where it started, so it is accepted only when such a capture is generated
+    if (toPosition == fromPosition) 
+    {
+        MoveList list; // every legal move for the player to move
+        int i = 0; // loop iterator for the generated moves
+
+        GenerateMoves(game, &list);
+        for (i = 0; i < list.count; i++)
+        {
+            if (list.moves[i].from == fromPosition && list.moves[i].to == toPosition) { return 1; }
+        }
+        printf("FROM and TO cannot be the same square! Try another spot.\n");
+        return 0;
+    }
+
+    // qualifier: TO must be an unoccupied square to move onto
+    // if not, print error and return 0
+    // otherwise, return 1 for valid TO position
+    if (IsOccupiedSpace(game, toPosition)) 
+    {
+        printf("That square is already occupied! Try another spot.\n");
+        return 0; // square taken
+    }
+    return 1; // empty dark square
+}
+
+// method to let the player pick one of the capture chains in "paths", which all share FROM and TO
+// plays the chosen chain into "record", returns 1 if a chain was played, 0 if cancelled
+static int PlayChosenPath(GameState* game, const MoveList* paths, MoveRecord* record)
+{
+    char text[64]; // one chain as text
+    int choice = 0; // chain number entered by the player
+    int i = 0; // loop iterator for the chains
+
+    printf("%d captures go from %d to %d, over different pieces:\n", paths->count, paths->moves[0].from, paths->moves[0].to);
+    for (i = 0; i < paths->count; i++) { printf("  %d. %s\n", i + 1, MoveToText(&paths->moves[i], text, (int)sizeof(text))); }
+
+    printf("Enter capture number (1-%d, -1 to cancel): ", paths->count);
+    if (!UserInt(&choice) || choice < 1 || choice > paths->count) { return 0; }
+
+    MakeMove(game, &paths->moves[choice - 1], record); // play the chain, passing the turn
+    return 1;
+}
+
+// method to check if the game ended after a move and announce the winner
+// the game ends when a player has no pieces left or the player to move has no legal moves
+// returns 1 if the game is over, otherwise 0
+static int AnnounceGameOver(const GameState* game) 
+{
+    int win = CheckWinner(game); // win assigns the result of CheckWinner
+
+    // check if a player has won by capturing every opposing piece
+    if (win == 1 || win == 2) 
+    {
+        PrintPlayerText(win); // print the winning player
+        printf(" wins!\n\n");
+        return 1;
+    }
+
+    // check if the next player (now to move) has any legal moves available 
+    if (!CheckLegalMoves(game)) 
+    {
+        // identify loser, the side now to move
+        int loser = game->current_turn;
+        int winner = 0; 
+
+        // if the loser is player 1, then the winner is player 2
+        if (loser == 1) { winner = 2; }
+
+        // otherwise, the loser is player 2, so the winner is player 1
+        else { winner = 1; }
+
+        PrintPlayerText(loser); // print the losing player
+        printf(" has no legal moves. ");
+        PrintPlayerText(winner); // print the winning player
+        printf(" wins!\n\n");
+        return 1;
+    }
+    return 0; // game continues
+}
+
+// method to prompt for a new game or exit after the game ended
+// "history" starts again from the new board
+// returns 1 if a new game was started, 0 if the user chose to exit
+static int PromptPlayAgain(GameState* game, GameRecord* history) 
+{
+    int playAgain = 0; // initialize play again choice
+
+    printf("Would you like to play again (New Game - Reset Board) [Enter 1]?\n");
+    printf("Or Exit [Enter 2]?\n\n");
+    printf("Enter Option: ");
+
+    // get user input for play again option
+    if (!UserInt(&playAgain)) { playAgain = 2; }
+    printf("\n");
+
+    // handle play again or exit
+    if (playAgain == 1) 
+    {
+        SetBoard(game); // reset the board and game state
+        ResetGameRecord(history, game); // forget the moves of the finished game
+        ShowBoard(game); // print the new board
+        return 1;
+    }
+
+    // if user chooses to exit
+    printf("Goodbye!\n");
+    return 0;
+}
+
+// method for the splitmix64 random number generator, advances "state" and returns the next number
+// only used to vary the computer opponent's book moves, the search itself is not random
+static unsigned long long NextRandom(unsigned long long* state)
+{
+    unsigned long long mixed = 0ull; // number being scrambled
+
+    *state = *state + 0x9E3779B97F4A7C15ull;
+    mixed = *state;
+    mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ull;
+    mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBull;
+    return mixed ^ (mixed >> 31);
+}
+
+// method for the computer opponent to search and play a move for the player to move
+// plays a book move straight away when the position is in the opening book,
+// otherwise searches within COMPUTER_TIME_MS, then prints the move, its captures and the new board
+// "table" keeps search results between moves (NULL if it could not be allocated)
+// "threads" search threads share the time budget (set with "--threads N")
+// "tablebase" answers endgames with few pieces (set with "--tablebase DIR", NULL without one)
+// "book" answers the opening (set with "--book FILE", NULL without one), "random" varies its choice
+// the played move is added to "history"
+static void ComputerMove(GameState* game, TranspositionTable* table, int threads, const Tablebase* tablebase,
+    const OpeningBook* book, unsigned long long* random, GameRecord* history) 
+{
+    SearchLimits limits; // time budget for the search
+    SearchResult result; // best move and principal variation
+    MoveRecord record; // captures and promotion of the played move
+    BookMove bookMove; // move chosen from the opening book
+    char text[512]; // principal variation as text
+
+    // qualifier: a book move needs no search
+    if (book != NULL && ChooseBookMove(book, game, NextRandom(random), &bookMove))
+    {
+        printf("[Computer] book move %s (%u wins, %u draws, %u losses)\n", MoveToText(&bookMove.move, text, (int)sizeof(text)),
+            bookMove.wins, bookMove.draws, bookMove.losses);
+
+        MakeMove(game, &bookMove.move, &record); // play the move, passing the turn back
+        AddRecordMove(history, &record);
+        PrintMoveResult(&record);
+        PrintMoveText(record.player, record.move.from, record.move.to);
+        ShowBoard(game);
+        return;
+    }
+
+    limits.maxDepth = 0; // no depth limit, the time budget decides
+    limits.timeLimitMs = COMPUTER_TIME_MS;
+    limits.nodeLimit = 0ull;
+    limits.verbose = 0;
+    limits.table = table;
+    limits.threads = threads;
+    limits.tablebase = tablebase;
+    limits.stop = NULL;
+    limits.progress = NULL;
+    limits.progressContext = NULL;
+    limits.weights = NULL;
+
+    // qualifier: nothing to play if the computer has no legal move
+    if (!SearchBestMove(game, &limits, &result)) { return; }
+
+    printf("[Computer] searched depth %d, score %d, line: %s\n", result.depth, result.score, 
+        PrincipalVariationText(&result, text, (int)sizeof(text)));
+
+    MakeMove(game, &result.bestMove, &record); // play the move, passing the turn back
+    AddRecordMove(history, &record);
+    PrintMoveResult(&record);
+    PrintMoveText(record.player, record.move.from, record.move.to);
+    ShowBoard(game);
+}
+
+// method to build the name of the move history file saved next to "filename" ("<filename>.pdn")
+// returns 1 on success, 0 if the name does not fit into "buffer"
+static int HistoryFileName(const char* filename, char* buffer, size_t size)
+{
+    int length = snprintf(buffer, size, "%s.pdn", filename); // characters needed
+    return length > 0 && (size_t)length < size;
+}
+
+// method to save the moves of "history" up to the current position next to the save file "filename"
+// moves that could still be redone are left out, so the PDN file ends at the saved position
+static void SaveHistory(const char* filename, const GameRecord* history)
+{
+    char pdnName[300]; // "<filename>.pdn"
+    GameRecord played = *history; // same moves, without the redo tail
+
+    played.count = history->ply;
+    if (!HistoryFileName(filename, pdnName, sizeof(pdnName)) || !SavePdnFile(pdnName, &played))
+    {
+        printf("Could not save the move history.\n");
+        return;
+    }
+    printf("Move history saved to \"%s\" (%d moves).\n", pdnName, played.count);
+}
+
+// method to restore "history" after the save file "filename" was loaded into "game"
+// the moves are kept only if the PDN file next to it replays to exactly the loaded position,
+// otherwise the history starts again at the loaded position
+static void LoadHistory(const char* filename, const GameState* game, GameRecord* history)
+{
+    char pdnName[300]; // "<filename>.pdn"
+    GameState replayed; // position at the end of the PDN file
+
+    if (HistoryFileName(filename, pdnName, sizeof(pdnName)) && LoadPdnFile(pdnName, history))
+    {
+        ReplayRecord(history, history->count, &replayed);
+        if (replayed.player1_men == game->player1_men && replayed.player1_kings == game->player1_kings
+            && replayed.player2_men == game->player2_men && replayed.player2_kings == game->player2_kings
+            && replayed.current_turn == game->current_turn)
+        {
+            printf("Move history loaded from \"%s\" (%d moves).\n", pdnName, history->count);
+            return;
+        }
+        printf("The move history in \"%s\" does not match the save file, it was not loaded.\n", pdnName);
+    }
+    ResetGameRecord(history, game);
+}
+
+// method to undo ("direction" -1) or redo ("direction" 1) a move of "history" on "game"
+// against the computer, it keeps going until it is the human player's turn again
+static void StepHistory(GameState* game, GameRecord* history, int computerPlayer, int direction)
+{
+    int stepped = 0; // moves undone or redone
+
+    // qualifier: step once, then past the computer's moves
+    do
+    {
+        if (direction < 0 && !UndoRecordMove(history, game)) { break; }
+        if (direction > 0 && !RedoRecordMove(history, game)) { break; }
+        stepped++;
+    } while (computerPlayer == game->current_turn);
+
+    if (stepped == 0)
+    {
+        if (direction < 0) { printf("No move to undo.\n"); }
+        else { printf("No move to redo.\n"); }
+        return;
+    }
+
+    printf("%s %d move(s), now at move %d of %d.\n", (direction < 0) ? "Undid" : "Redid", stepped, history->ply, history->count);
+    ShowBoard(game);
+    if (direction > 0) { AnnounceGameOver(game); }
+}
+
+// method to list the moves of "history" and bring "game" to the move the user chooses
+static void GoToHistoryPly(GameState* game, GameRecord* history)
+{
+    GameState position = history->start; // position before each listed move
+    int ply = 0; // loop iterator for the moves, then the chosen move
+
+    printf("[Move History] (0 = start position, * = current position)\n");
+    printf("%s   0. start\n", (history->ply == 0) ? "*" : " ");
+    for (ply = 0; ply < history->count; ply++)
+    {
+        const PackedMove* move = &history->moves[ply]; // recorded move
+
+        printf("%s %3d. ", (history->ply == ply + 1) ? "*" : " ", ply + 1);
+        PrintPlayerText(position.current_turn);
+        printf(" %d%c%d\n", move->from, (move->captured != 0u) ? 'x' : '-', move->to);
+        RedoPackedMove(&position, move);
+    }
+
+    printf("\nEnter move number to go to (0-%d, -1 to cancel): ", history->count);
+    if (!UserInt(&ply) || ply == -1)
+    {
+        printf("Cancelled. Returning to main menu.\n");
+        return;
+    }
+    if (!GoToRecordPly(history, game, ply))
+    {
+        printf("There is no move %d.\n", ply);
+        return;
+    }
+    ShowBoard(game);
+}
+
 // method for running the entire program (entry point), including everything together
-int main(void) 
+// optional argument "--threads N" lets the computer opponent search on N threads
+// optional arguments "--tablebase DIR" / "--tbcache MB" let it look endgames up in a tablebase made by "tbgen"
+// optional argument "--book FILE" lets it play the opening from a book made by "bookbuild"
+// "analyze <dir|files...>" analyzes save files without starting the game (see "analyze.h")
+// "pack" / "unpack" / "dbinfo" / "dbscore" convert, inspect and score binary position databases (see "posdbtool.h")
+// "tbgen" / "tbprobe" build and look up the endgame tablebase (see "tbgen.h")
+// "bookbuild" / "bookprobe" build and look up the opening book (see "booktool.h")
+// "replay" replays PDN game files (see "recordtool.h")
+// "engine" answers a line protocol on stdin / stdout instead of showing the menu (see "engine.h")
+// "batch" plays scripted moves and prints only the results (see "scriptplay.h")
+int main(int argc, char* argv[]) 
 {
     GameState game; // holds all game state information
     int mainRunning = 1; // flag to control main game loop
+    int computerPlayer = 0; // player controlled by the computer, 1 or 2 (0 when two humans play)
+    TranspositionTable tableMemory; // transposition table for the computer opponent
+    TranspositionTable* computerTable = NULL; // points to "tableMemory" once allocated
+    int computerThreads = 1; // search threads for the computer opponent
+    const char* tablebaseFolder = NULL; // folder of the endgame tablebase, NULL for none
+    int tablebaseCacheMb = TB_DEFAULT_CACHE_MB; // block cache of the tablebase, in MB
+    Tablebase tablebase; // endgame tablebase for the computer opponent
+    Tablebase* computerTablebase = NULL; // points to "tablebase" once opened
+    const char* bookFile = NULL; // opening book file, NULL for none
+    OpeningBook book; // opening book for the computer opponent
+    OpeningBook* computerBook = NULL; // points to "book" once opened
+    GameRecord history; // moves of the current game, for undo / redo and the PDN file
+    RenderScreen screen; // terminal board of "--ansi"
+    unsigned long long bookRandom = (unsigned long long)time(NULL); // state of the book move choice
+    int argument = 0; // loop iterator for the command line arguments
+
+    StatsDumpOnExit(); // instrumented builds print the game core counters at exit, for every command
+
+    // qualifier: "analyze" runs the batch analysis of save files instead of the game
+    if (argc >= 2 && strcmp(argv[1], "analyze") == 0) { return RunAnalyze(argc - 2, argv + 2); }
+
+    // qualifier: converters between save files and the binary position database
+    if (argc >= 2 && strcmp(argv[1], "pack") == 0) { return RunPack(argc - 2, argv + 2); }
+    if (argc >= 2 && strcmp(argv[1], "unpack") == 0) { return RunUnpack(argc - 2, argv + 2); }
+    if (argc >= 2 && strcmp(argv[1], "dbinfo") == 0) { return RunDbInfo(argc - 2, argv + 2); }
+    if (argc >= 2 && strcmp(argv[1], "dbscore") == 0) { return RunDbScore(argc - 2, argv + 2); }
+
+    // qualifier: endgame tablebase generator and lookup
+    if (argc >= 2 && strcmp(argv[1], "tbgen") == 0) { return RunTbGen(argc - 2, argv + 2); }
+    if (argc >= 2 && strcmp(argv[1], "tbprobe") == 0) { return RunTbProbe(argc - 2, argv + 2); }
+
+    // qualifier: opening book builder and lookup
+    if (argc >= 2 && strcmp(argv[1], "bookbuild") == 0) { return RunBookBuild(argc - 2, argv + 2); }
+    if (argc >= 2 && strcmp(argv[1], "bookprobe") == 0) { return RunBookProbe(argc - 2, argv + 2); }
+
+    // qualifier: replay of PDN game files
+    if (argc >= 2 && strcmp(argv[1], "replay") == 0) { return RunReplay(argc - 2, argv + 2); }
+
+    // qualifier: engine protocol for GUIs and test harnesses
+    if (argc >= 2 && strcmp(argv[1], "engine") == 0) { return RunEngine(argc - 2, argv + 2); }
+
+    // qualifier: scripted moves from files or a pipe, no menu and no boards
+    if (argc >= 2 && strcmp(argv[1], "batch") == 0) { return RunBatchPlay(argc - 2, argv + 2); }
+
+    // read the command line options
+    for (argument = 1; argument < argc; argument++)
+    {
+        // qualifier: "--threads N" with N between 1 and SEARCH_MAX_THREADS
+        if (strcmp(argv[argument], "--threads") == 0 && argument + 1 < argc)
+        {
+            computerThreads = atoi(argv[argument + 1]);
+            argument++;
+            if (computerThreads < 1 || computerThreads > SEARCH_MAX_THREADS)
+            {
+                printf("Threads must be between 1 and %d.\n", SEARCH_MAX_THREADS);
+                return 1;
+            }
+        }
+        // qualifier: "--tablebase DIR" folder written by "tbgen"
+        else if (strcmp(argv[argument], "--tablebase") == 0 && argument + 1 < argc)
+        {
+            tablebaseFolder = argv[argument + 1];
+            argument++;
+        }
+        // qualifier: "--tbcache MB" size of the tablebase block cache
+        else if (strcmp(argv[argument], "--tbcache") == 0 && argument + 1 < argc)
+        {
+            tablebaseCacheMb = atoi(argv[argument + 1]);
+            argument++;
+            if (tablebaseCacheMb < 0)
+            {
+                printf("The tablebase cache cannot be negative.\n");
+                return 1;
+            }
+        }
+        // qualifier: "--ansi" keeps the board at the top of the terminal, redrawing changed squares only
+        else if (strcmp(argv[argument], "--ansi") == 0)
+        {
+            RenderScreenInit(&screen);
+            ansiScreen = &screen;
+        }
+        // qualifier: "--book FILE" written by "bookbuild"
+        else if (strcmp(argv[argument], "--book") == 0 && argument + 1 < argc)
+        {
+            bookFile = argv[argument + 1];
+            argument++;
+        }
+        // otherwise, unknown option
+        else
+        {
+            printf("Usage: %s [--threads N] [--tablebase DIR] [--tbcache MB] [--book FILE] [--ansi]\n", argv[0]);
+            printf("       %s analyze [--format csv|jsonl] [--output FILE] [--depth D] [--jobs N] <dir|files...>\n", argv[0]);
+            printf("       %s pack <database> <dir|files...>\n", argv[0]);
+            printf("       %s unpack <database> <folder>\n", argv[0]);
+            printf("       %s dbinfo <database>\n", argv[0]);
+            printf("       %s dbscore [--check] [--output FILE] <database>\n", argv[0]);
+            printf("       %s tbgen [--pieces N] [--jobs N] [--cache MB] <folder>\n", argv[0]);
+            printf("       %s tbprobe <folder> <savefiles...>\n", argv[0]);
+            printf("       %s bookbuild [--plies N] [--min-games N] <book> <dir|files...>\n", argv[0]);
+            printf("       %s bookprobe <book> [savefiles...]\n", argv[0]);
+            printf("       %s replay [--check] <dir|files...>\n", argv[0]);
+            printf("       %s engine [--threads N] [--hash MB] [--tablebase DIR] [--tbcache MB] [--weights FILE] [--book FILE]\n", argv[0]);
+            printf("       %s batch [--moves] [--start FILE] [files... | -]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // qualifier: the computer opponent still works without a table if memory is short
+    if (TTInit(&tableMemory, COMPUTER_TABLE_MB)) { computerTable = &tableMemory; }
+
+    // qualifier: the tablebase is optional, the computer opponent searches normally without it
+    if (tablebaseFolder != NULL)
+    {
+        if (OpenTablebase(tablebaseFolder, (size_t)tablebaseCacheMb, &tablebase) > 0)
+        {
+            computerTablebase = &tablebase;
+            printf("Tablebase: %d slices, up to %d pieces.\n", tablebase.sliceCount, tablebase.maxPieces);
+        }
+        else
+        {
+            printf("No tablebase files found in: %s\n", tablebaseFolder);
+            CloseTablebase(&tablebase);
+        }
+    }
+
+    // qualifier: the book is optional, the computer opponent searches every move without it
+    if (bookFile != NULL)
+    {
+        if (OpenBook(bookFile, &book))
+        {
+            computerBook = &book;
+            printf("Opening book: %llu moves.\n", book.count);
+        }
+        else { printf("Could not open the opening book: %s\n", bookFile); }
+    }
 
     SetBoard(&game); // initialize/refresh the board for a new game
+    InitGameRecord(&history, &game); // no moves played yet
     PrintTitle(); // print game title
-    PrintBoardPretty(&game); // print the intial board
+    ShowBoard(&game); // print the intial board
 
     // main menu and game loop, continues until user chooses to exit
     while (mainRunning) 
     {
         int choice = 0; // initialize user menu choice
+
+        // qualifier: the computer opponent moves whenever it is its turn and the game is not over
+        if (computerPlayer == game.current_turn && CheckWinner(&game) == 0 && CheckLegalMoves(&game)) 
+        {
+            ComputerMove(&game, computerTable, computerThreads, computerTablebase, computerBook, &bookRandom, &history);
+
+            // qualifier: stop the main loop if the game ended and the user chooses to exit
+            if (AnnounceGameOver(&game) && !PromptPlayAgain(&game, &history)) 
+            {
+                mainRunning = 0;
+                continue;
+            }
+        }
+
         DisplayMenu(); // display the main menu
 
         // qualifier: if UserInt invalid menu choice, print error and re-prompt
@@ -350,7 +831,8 @@ int main(void)
         {
             // 1 - Print Board
             case 1:
-                PrintBoardPretty(&game); // print the current game board
+                if (ansiScreen != NULL) { ansiScreen->drawn = 0; } // "--ansi" draws the whole screen again
+                ShowBoard(&game); // print the current game board
                 break;
 
             // 2 - Make A Move
@@ -358,6 +840,9 @@ int main(void)
             {
                 int fromPosition = -1; // initialize fromPosition, chosen square index
                 int toPosition = -1; // initialize toPosition, chosen destination index
+                MoveRecord record; // captures and promotion of the move, filled by TryMove
+                MoveList paths; // capture chains from FROM to TO, more than one needs a choice
+                int moved = 0; // flagger set once the move was played
 
                 // qualifier: print whose turn it is based on "current_turn" flagger
                 if (game.current_turn == 1) 
@@ -369,7 +854,7 @@ int main(void)
                     printf("[Player 2 (Black) turn]\n");
                 }
 
-                PrintBoardPretty(&game); // print the current game board during each turn
+                ShowBoard(&game); // print the current game board during each turn
                 PrintReferenceBoard(); // print the reference board for index reference
 
                 printf("Tip: If stuck, enter -1 to cancel and return to the main menu.\n\n");
@@ -423,116 +908,53 @@ int main(void)
                         continue; // reprompt on invalid TO position
                     }
 
-                    // attempt to make the move, once both FROM and TO are valid
-                    if (TryMove(&game, fromPosition, toPosition)) 
+                    // qualifier: two capture chains from FROM to TO, the player picks the path
+                    // TryMove rejects such a move, FROM and TO alone do not say which one is meant
+                    if (FindMovesBetween(&game, fromPosition, toPosition, &paths) > 1) 
                     {
-                        // print which player moved and from/to positions
-                        PrintMoveText(game.current_turn, fromPosition, toPosition);
-
-                        // print the updated board after the move
-                        PrintBoardPretty(&game);
-
-                        // check for a winner based on captured pieces
-                        // if a winner is found, announce and prompt for new game or exit
+                        moved = PlayChosenPath(&game, &paths, &record);
+                        if (!moved) 
                         {
-                            int win = CheckWinner(&game); // win assigns the result of CheckWinner
-
-                            // check if a player has won
-                            if (win == 1 || win == 2) 
-                            {
-                                PrintPlayerText(win); // print the winning player
-                                printf(" wins!\n\n");
-
-                                // prompt for new game or exit
-                                {
-                                    int playAgain = 0; // initialize play again choice
-
-                                    printf("Would you like to play again (New Game - Reset Board) [Enter 1]?\n");
-                                    printf("Or Exit [Enter 2]?\n\n");
-                                    printf("Enter Option: ");
-
-                                    // get user input for play again option
-                                    if (!UserInt(&playAgain)) { playAgain = 2; }
-                                    printf("\n");
-
-                                    // handle play again or exit
-                                    if (playAgain == 1) 
-                                    {
-                                        SetBoard(&game); // reset the board and game state
-                                        PrintBoardPretty(&game); // print the new board
-                                    }
-                                    // if user chooses to exit
-                                    else 
-                                    {
-                                        printf("Goodbye!\n");
-                                        mainRunning = 0; // stop the main loop
-                                    }
-                                }
-                                break;
-                            }
+                            printf("Move cancelled. Returning to main menu.\n");
+                            break; // user cancelled the choice of path
                         }
+                    }
+
+                    // otherwise, attempt to make the move, once both FROM and TO are valid
+                    // a successful move passes the turn to the other player
+                    else { moved = TryMove(&game, fromPosition, toPosition, &record); }
+
+                    if (moved) 
+                    {
+                        AddRecordMove(&history, &record); // keep the move for undo / redo and the PDN file
+
+                        // print any captures / promotion, then which player moved and from/to positions
+                        PrintMoveResult(&record);
+                        PrintMoveText(record.player, fromPosition, toPosition);
 
-                        // check if the next player has any legal moves available
-                        // if blocked, announce the winner and prompt for new game or exit
+                        // print the updated board after the move
+                        ShowBoard(&game);
+
+                        // check for a winner (all pieces captured or next player blocked)
+                        // if the game ended, prompt for new game or exit
+                        if (AnnounceGameOver(&game)) 
                         {
-                            GameState nextState = game; // copy current game state
-                            SwitchTurn(&nextState); // simulate other player's turn
-
-                            // check if the next player has any legal moves available 
-                            if (!CheckLegalMoves(&nextState)) 
-                            {
-
-                                // identify loser, the side to move in nextState
-                                int loser = nextState.current_turn;
-                                int winner = 0; 
-
-                                // if the loser is player 1, then the winner is player 2
-                                if (loser == 1) { winner = 2; }
-                        
-                                // otherwise, the loser is player 2, so the winner is player 1
-                                else { winner = 1; }
-                            
-                                PrintPlayerText(loser); // print the losing player
-                                printf(" has no legal moves. ");
-                                PrintPlayerText(winner); // print the winning player
-                                printf(" wins!\n\n");
-
-                                // prompt for new game or exit
-                                {
-                                    int playAgain = 0; // initialize play again choice
-                                    printf("Would you like to play again (New Game - Reset Board) [Enter 1]?\n");
-                                    printf("Or Exit [Enter 2]?\n\n");
-
-                                    printf("Enter Option: ");
-
-                                    // get user input for play again option
-                                    if (!UserInt(&playAgain)) { playAgain = 2; }
-                                    printf("\n");
-
-                                    // handle play again or exit
-                                    if (playAgain == 1) 
-                                    {
-                                        SetBoard(&game); // reset the board and game state
-                                        PrintBoardPretty(&game); // print the new board
-                                    } 
-                                    // program terminates
-                                    else 
-                                    {
-                                        printf("Goodbye!\n");
-                                        mainRunning = 0; // stop the main loop
-                                    }
-                                }
-                                break;
-                            }
+                            // qualifier: stop the main loop if the user chooses to exit
+                            if (!PromptPlayAgain(&game, &history)) { mainRunning = 0; }
                         }
-
-                        SwitchTurn(&game); // switch to the other player's turn
                         break;
                     } 
                     
                     // if TryMove failed, print error and reprompt for TO position
                     else 
                     {
+                        MoveList legal; // legal moves, used to explain a rejected step
+
+                        // qualifier: remind the player when a capture must be taken
+                        if (GenerateMoves(&game, &legal) > 0 && legal.moves[0].jumps > 0) 
+                        {
+                            printf("A capture is available and must be taken!\n");
+                        }
                         printf("Invalid move. Please try again.\n");
                     }
                 }
@@ -569,7 +991,8 @@ int main(void)
                     break; 
                 }
 
-                SaveGame(filename, &game); // save the game state to the specified file
+                // save the game state, and its moves next to it as "<filename>.pdn"
+                if (SaveGame(filename, &game)) { SaveHistory(filename, &history); }
                 break;
             }
 
@@ -601,10 +1024,11 @@ int main(void)
                 {
                     printf("Load failed. Enter valid file name exactly.\n");
                 }
-                // otherwise, print the loaded board
+                // otherwise, restore the moves that led to it and print the loaded board
                 else 
                 {
-                    PrintBoardPretty(&game);
+                    LoadHistory(filename, &game, &history);
+                    ShowBoard(&game);
                 }
                 break;
             }
@@ -622,20 +1046,74 @@ int main(void)
             // 7 - New Game (Reset Board)   
             case 7:
                 SetBoard(&game); // reset the game board
-                PrintBoardPretty(&game); // print the new game board
+                ResetGameRecord(&history, &game); // forget the moves of the previous game
+                ShowBoard(&game); // print the new game board
                 break;
 
-            // 8 - Quit Game
+            // 8 - Play vs Computer (toggle on/off)
             case 8:
+                // qualifier: turn the computer on, it plays the side not currently to move
+                if (computerPlayer == 0) 
+                {
+                    if (game.current_turn == 1) { computerPlayer = 2; }
+                    else { computerPlayer = 1; }
+
+                    printf("Computer opponent ON. You play ");
+                    PrintPlayerText(3 - computerPlayer);
+                    printf(", the computer plays ");
+                    PrintPlayerText(computerPlayer);
+                    printf(".\n");
+                }
+                // otherwise, turn the computer off and go back to two players
+                else 
+                {
+                    computerPlayer = 0;
+                    printf("Computer opponent OFF. Two-player mode.\n");
+                }
+                break;
+
+            // 9 - Quit Game
+            case 9:
                 mainRunning = 0; // stop the main loop
                 printf("Goodbye!\n");
                 break;
 
+            // 10 - Undo Move
+            case 10:
+                StepHistory(&game, &history, computerPlayer, -1);
+                break;
+
+            // 11 - Redo Move
+            case 11:
+                StepHistory(&game, &history, computerPlayer, 1);
+                break;
+
+            // 12 - Move History (go to a move)
+            case 12:
+                GoToHistoryPly(&game, &history);
+                break;
+
             // unknown option, print error message
             default:
-                printf("Invalid option. Please enter a number from the menu (1-8).\n");
+                printf("Invalid option. Please enter a number from the menu (1-12).\n");
                 break;
         }
     }
+    // release the computer opponent's table, tablebase and book
+    if (computerTable != NULL) { TTFree(computerTable); }
+    if (computerTablebase != NULL) { CloseTablebase(computerTablebase); }
+    if (computerBook != NULL) { CloseBook(computerBook); }
+    FreeGameRecord(&history);
+
+    // qualifier: "--ansi" gives the whole terminal back to scrolling
+    if (ansiScreen != NULL)
+    {
+        char frame[RENDER_ANSI_SIZE]; // ANSI codes that end the board region
+        RenderBuffer buffer; // frame being built
+
+        RenderInit(&buffer, frame, sizeof(frame));
+        RenderAnsiEnd(&buffer, ansiScreen);
+        RenderPrint(&buffer, stdout);
+    }
     return 0; // normal program termination
 }
\ No newline at end of file
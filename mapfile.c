@@ -0,0 +1,131 @@
+// [mapfile.c] file
+
+// mmap / open / fstat are POSIX, not part of plain C11
+#define _POSIX_C_SOURCE 200809L
+
+#include <stddef.h> // for NULL
+
+#ifdef _WIN32
+#include <windows.h> // for CreateFile / CreateFileMapping / MapViewOfFile
+#else
+#include <fcntl.h> // for open
+#include <unistd.h> // for close
+#include <sys/mman.h> // for mmap / munmap
+#include <sys/stat.h> // for fstat (file size)
+#endif
+
+#include "mapfile.h" // declare "mapfile" methods
+
+#ifdef _WIN32
+
+// map the whole file "filename" read-only into "map" (Windows)
+int MapFile(const char* filename, MappedFile* map)
+{
+    HANDLE file = INVALID_HANDLE_VALUE; // open file, closed once the mapping exists
+    LARGE_INTEGER size; // file size in bytes
+
+    map->data = NULL;
+    map->size = 0u;
+    map->handle = NULL;
+
+    file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) { return 0; }
+
+    if (!GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        return 0;
+    }
+
+    // qualifier: an empty file cannot be mapped, but is still a valid (empty) file
+    if (size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return 1;
+    }
+
+    map->handle = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file); // the mapping keeps the file open
+    if (map->handle == NULL) { return 0; }
+
+    map->data = (const unsigned char*)MapViewOfFile((HANDLE)map->handle, FILE_MAP_READ, 0, 0, 0);
+    if (map->data == NULL)
+    {
+        CloseHandle((HANDLE)map->handle);
+        map->handle = NULL;
+        return 0;
+    }
+    map->size = (size_t)size.QuadPart;
+    return 1;
+}
+
+// release a mapping made by MapFile (Windows)
+void UnmapFile(MappedFile* map)
+{
+    if (map->data != NULL) { UnmapViewOfFile((LPCVOID)map->data); }
+    if (map->handle != NULL) { CloseHandle((HANDLE)map->handle); }
+    map->data = NULL;
+    map->size = 0u;
+    map->handle = NULL;
+}
+
+// tell the system that "map" is read in random order (Windows has no such hint, nothing to do)
+void AdviseRandomAccess(const MappedFile* map)
+{
+    (void)map;
+}
+
+#else
+
+// map the whole file "filename" read-only into "map" (POSIX)
+int MapFile(const char* filename, MappedFile* map)
+{
+    struct stat info; // file size
+    void* address = NULL; // start of the mapping
+    int file = -1; // open file descriptor, closed once the mapping exists
+
+    map->data = NULL;
+    map->size = 0u;
+    map->handle = NULL;
+
+    file = open(filename, O_RDONLY);
+    if (file < 0) { return 0; }
+
+    if (fstat(file, &info) != 0)
+    {
+        close(file);
+        return 0;
+    }
+
+    // qualifier: an empty file cannot be mapped, but is still a valid (empty) file
+    if (info.st_size == 0)
+    {
+        close(file);
+        return 1;
+    }
+
+    address = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file); // the mapping keeps the file open
+    if (address == MAP_FAILED) { return 0; }
+
+    map->data = (const unsigned char*)address;
+    map->size = (size_t)info.st_size;
+    return 1;
+}
+
+// release a mapping made by MapFile (POSIX)
+void UnmapFile(MappedFile* map)
+{
+    if (map->data != NULL) { munmap((void*)map->data, map->size); }
+    map->data = NULL;
+    map->size = 0u;
+    map->handle = NULL;
+}
+
+// tell the system that "map" is read in random order (POSIX), so a page fault does not read ahead
+void AdviseRandomAccess(const MappedFile* map)
+{
+    if (map->data != NULL) { posix_madvise((void*)map->data, map->size, POSIX_MADV_RANDOM); }
+}
+
+#endif
@@ -0,0 +1,40 @@
+// [mapfile.h] header file
+// function declarations for "mapfile.c"
+// implemented in "posdb.c" / "tablebase.c"
+
+#ifndef MAPFILE_H
+#define MAPFILE_H
+
+#include <stddef.h> // for size_t (file size)
+
+// { Phase 4 - Memory-Mapped Files } //
+// maps a whole file read-only into memory, so large data files are read
+// straight from the operating system's page cache without copying
+
+/*
+    POSIX systems use mmap, Windows uses CreateFileMapping / MapViewOfFile.
+    Pages are only loaded when they are first touched, so mapping a file of
+    any size is fast and uses memory only for the parts actually read.
+    An empty file maps successfully with "data" NULL and "size" 0.
+*/
+
+// a read-only file mapping
+typedef struct
+{
+    const unsigned char* data; // first byte of the file, NULL for an empty file
+    size_t size; // file size in bytes
+    void* handle; // operating system handle (Windows mapping object), unused on POSIX
+} MappedFile;
+
+// map the whole file "filename" read-only into "map"
+// returns 1 on success, 0 if the file could not be opened or mapped
+int MapFile(const char* filename, MappedFile* map);
+
+// release a mapping made by MapFile
+void UnmapFile(MappedFile* map);
+
+// hint that "map" will be read in random order (small reads all over the file)
+// pages are then loaded one at a time instead of with the usual read-ahead
+void AdviseRandomAccess(const MappedFile* map);
+
+#endif
@@ -0,0 +1,545 @@
+// [microbench.c] file
+// run the microbenchmarks of the bit operations and game helpers here!
+
+/*
+    Times the Phase 1 bit operations, the Phase 2 board helpers and the
+    position evaluation one call at a time, so a slower primitive shows up
+    before it hides inside a bigger benchmark (perft, searchbench).
+    "EvaluatePosition" scores with the features MakeMove keeps up to date,
+    "EvaluateFromScratch" counts them again first (ComputeEvalTerms); the
+    "calls/second" column of the printed table is then evaluations per second.
+
+    Usage:
+        make bench [BENCH_ARGS="..."]
+        ./microbench [--reps N] [--sample-ms MS] [--filter TEXT] [--output FILE]
+                     [--compare FILE] [--threshold PCT]
+
+        --reps N         timed samples per benchmark (default 101)
+        --sample-ms MS   length of one sample (default 2), the number of
+                         calls per sample is doubled until it takes this long
+        --filter TEXT    only run the benchmarks whose name contains TEXT
+        --output FILE    write the results as tab separated lines to FILE
+        --compare FILE   compare the medians with an earlier --output file
+        --threshold PCT  a median more than PCT percent above the earlier
+                         one counts as a regression (default 10)
+
+    Each benchmark is warmed up for BENCH_WARMUP_MS, then timed "reps" times.
+    The time of a sample divided by its calls gives ns per call; the median,
+    the 99th percentile and the fastest sample are reported. "baseline" is
+    the same loop without a call, the cost of reading the inputs.
+
+    Inputs (values, bit positions, squares, positions from random games) are
+    made at run time from a fixed seed, and every result is added into a sum
+    written to a volatile variable, so the compiler can neither fold a call
+    into a constant nor drop it. The output file has one line per benchmark:
+
+        name  median_ns  p99_ns  min_ns  calls_per_sample
+
+    "make bench" writes "bench.tsv". Keep the file of one commit and run the
+    next one with BENCH_ARGS="--compare old.tsv": the exit code is 1 when a
+    benchmark got slower than the threshold allows.
+*/
+
+// clock_gettime (CLOCK_MONOTONIC) is POSIX, not part of plain C11
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h> // for printing and the result files
+#include <stdlib.h> // for atoi / atof / malloc / qsort
+#include <string.h> // for comparing arguments and names
+#include <time.h> // for clock_gettime
+
+#include "bitoperations.h" // Phase 1 bit operations being timed
+#include "game.h" // board helpers being timed
+#include "movegen.h" // GenerateMoves / ApplyMove for the random positions
+#include "evaluate.h" // position evaluation being timed
+#include "stats.h" // game core counters of instrumented builds
+
+// inputs of each kind, a power of 2 so the index is masked instead of divided
+#define BENCH_INPUTS 4096
+#define BENCH_INPUT_MASK (BENCH_INPUTS - 1)
+
+// random game positions used by the board helpers, a power of 2
+#define BENCH_GAMES 64
+
+// defaults of the command line options
+#define BENCH_DEFAULT_REPS 101
+#define BENCH_DEFAULT_SAMPLE_MS 2
+#define BENCH_DEFAULT_THRESHOLD 10.0
+
+// warmup time before the timed samples of each benchmark, in milliseconds
+#define BENCH_WARMUP_MS 50
+
+// most samples "--reps" accepts
+#define BENCH_MAX_REPS 100000
+
+// longest line read from a "--compare" file
+#define BENCH_LINE_MAX 256
+
+// inputs read by the benchmark loops, filled once by MakeInputs
+typedef struct
+{
+    unsigned int values[BENCH_INPUTS]; // random 32-bit values
+    int positions[BENCH_INPUTS]; // bit positions 0-31
+    int squares[BENCH_INPUTS]; // board indexes 0-63
+    int rows[BENCH_INPUTS]; // rows 0-7
+    int cols[BENCH_INPUTS]; // columns 0-7
+    GameState games[BENCH_GAMES]; // positions reached by random moves
+} BenchInputs;
+
+// one benchmark loop, makes "calls" calls and returns the sum of their results
+typedef unsigned long long (*BenchFunction)(unsigned long long calls);
+
+// a named benchmark
+typedef struct
+{
+    const char* name; // name in the output
+    BenchFunction run; // timed loop
+} Benchmark;
+
+// result of one benchmark, in nanoseconds per call
+typedef struct
+{
+    const char* name; // name in the output
+    double median; // median sample
+    double p99; // 99th percentile sample
+    double fastest; // fastest sample
+    unsigned long long calls; // calls per sample
+} BenchResult;
+
+static BenchInputs inputs; // shared by every benchmark
+volatile unsigned long long benchSink = 0ull; // every benchmark sum ends here, so no call can be dropped
+
+// method to read the monotonic clock in nanoseconds
+static unsigned long long NowNs(void)
+{
+    struct timespec now; // current monotonic time
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec * 1000000000ull + (unsigned long long)now.tv_nsec;
+}
+
+// method for the splitmix64 random number generator, advances "state" and returns the next number
+static unsigned long long NextRandom(unsigned long long* state)
+{
+    unsigned long long mixed = 0ull; // number being scrambled
+
+    *state = *state + 0x9E3779B97F4A7C15ull;
+    mixed = *state;
+    mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ull;
+    mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBull;
+    return mixed ^ (mixed >> 31);
+}
+
+// method to fill "inputs" from a fixed seed, the same inputs on every run
+static void MakeInputs(void)
+{
+    unsigned long long random = 2024ull; // random number state
+    int i = 0; // loop iterator for the inputs and games
+
+    for (i = 0; i < BENCH_INPUTS; i++)
+    {
+        unsigned long long value = NextRandom(&random); // random bits for this input
+
+        inputs.values[i] = (unsigned int)value;
+        inputs.positions[i] = (int)((value >> 32) & 31ull);
+        inputs.squares[i] = (int)((value >> 40) & 63ull);
+        inputs.rows[i] = (int)((value >> 48) & 7ull);
+        inputs.cols[i] = (int)((value >> 56) & 7ull);
+    }
+
+    // every game plays i random plies from the start, up to the end of the game
+    for (i = 0; i < BENCH_GAMES; i++)
+    {
+        GameState game; // position being played
+        int ply = 0; // loop iterator for the plies
+
+        SetBoard(&game);
+        for (ply = 0; ply < i; ply++)
+        {
+            MoveList list; // legal moves
+
+            if (GenerateMoves(&game, &list) == 0) { break; }
+            ApplyMove(&game, &list.moves[NextRandom(&random) % (unsigned long long)list.count]);
+        }
+        inputs.games[i] = game;
+    }
+}
+
+// Benchmark Loops //
+
+// method for "baseline", the loop and input reads without a call
+static unsigned long long BenchBaseline(unsigned long long calls)
+{
+    unsigned long long sum = 0ull; // results of every call
+    unsigned long long i = 0ull; // loop iterator for the calls
+
+    for (i = 0ull; i < calls; i++) { sum += inputs.values[i & BENCH_INPUT_MASK] ^ (unsigned int)inputs.positions[i & BENCH_INPUT_MASK]; }
+    return sum;
+}
+
+// method for "SetBit"
+static unsigned long long BenchSetBit(unsigned long long calls)
+{
+    unsigned long long sum = 0ull; // results of every call
+    unsigned long long i = 0ull; // loop iterator for the calls
+
+    for (i = 0ull; i < calls; i++) { sum += SetBit(inputs.values[i & BENCH_INPUT_MASK], inputs.positions[i & BENCH_INPUT_MASK]); }
+    return sum;
+}
+
+// method for "ClearBit"
+static unsigned long long BenchClearBit(unsigned long long calls)
+{
+    unsigned long long sum = 0ull; // results of every call
+    unsigned long long i = 0ull; // loop iterator for the calls
+
+    for (i = 0ull; i < calls; i++) { sum += ClearBit(inputs.values[i & BENCH_INPUT_MASK], inputs.positions[i & BENCH_INPUT_MASK]); }
+    return sum;
+}
+
+// method for "ToggleBit"
+static unsigned long long BenchToggleBit(unsigned long long calls)
+{
+    unsigned long long sum = 0ull; // results of every call
+    unsigned long long i = 0ull; // loop iterator for the calls
+
+    for (i = 0ull; i < calls; i++) { sum += ToggleBit(inputs.values[i & BENCH_INPUT_MASK], inputs.positions[i & BENCH_INPUT_MASK]); }
+    return sum;
+}
+
+// method for "GetBit"
+static unsigned long long BenchGetBit(unsigned long long calls)
+{
+    unsigned long long sum = 0ull; // results of every call
+    unsigned long long i = 0ull; // loop iterator for the calls
+
+    for (i = 0ull; i < calls; i++) { sum += (unsigned long long)GetBit(inputs.values[i & BENCH_INPUT_MASK], inputs.positions[i & BENCH_INPUT_MASK]); }
+    return sum;
+}
+
+// method for "CountBits"
+static unsigned long long BenchCountBits(unsigned long long calls)
+{
+    unsigned long long sum = 0ull; // results of every call
+    unsigned long long i = 0ull; // loop iterator for the calls
+
+    for (i = 0ull; i < calls; i++) { sum += (unsigned long long)CountBits(inputs.values[i & BENCH_INPUT_MASK]); }
+    return sum;
+}
+
+// method for "ShiftLeft"
+static unsigned long long BenchShiftLeft(unsigned long long calls)
+{
+    unsigned long long sum = 0ull; // results of every call
+    unsigned long long i = 0ull; // loop iterator for the calls
+
+    for (i = 0ull; i < calls; i++) { sum += ShiftLeft(inputs.values[i & BENCH_INPUT_MASK], inputs.positions[i & BENCH_INPUT_MASK]); }
+    return sum;
+}
+
+// method for "ShiftRight"
+static unsigned long long BenchShiftRight(unsigned long long calls)
+{
+    unsigned long long sum = 0ull; // results of every call
+    unsigned long long i = 0ull; // loop iterator for the calls
+
+    for (i = 0ull; i < calls; i++) { sum += ShiftRight(inputs.values[i & BENCH_INPUT_MASK], inputs.positions[i & BENCH_INPUT_MASK]); }
+    return sum;
+}
+
+// method for "CreateMask"
+static unsigned long long BenchCreateMask(unsigned long long calls)
+{
+    unsigned long long sum = 0ull; // results of every call
+    unsigned long long i = 0ull; // loop iterator for the calls
+
+    for (i = 0ull; i < calls; i++) { sum += CreateMask(inputs.positions[i & BENCH_INPUT_MASK]); }
+    return sum;
+}
+
+// method for "ConvertRowColToIndex"
+static unsigned long long BenchConvertRowColToIndex(unsigned long long calls)
+{
+    unsigned long long sum = 0ull; // results of every call
+    unsigned long long i = 0ull; // loop iterator for the calls
+
+    for (i = 0ull; i < calls; i++) { sum += (unsigned long long)ConvertRowColToIndex(inputs.rows[i & BENCH_INPUT_MASK], inputs.cols[i & BENCH_INPUT_MASK]); }
+    return sum;
+}
+
+// method for "IsValidDarkSquare"
+static unsigned long long BenchIsValidDarkSquare(unsigned long long calls)
+{
+    unsigned long long sum = 0ull; // results of every call
+    unsigned long long i = 0ull; // loop iterator for the calls
+
+    for (i = 0ull; i < calls; i++) { sum += (unsigned long long)IsValidDarkSquare(inputs.squares[i & BENCH_INPUT_MASK]); }
+    return sum;
+}
+
+// method for "IsOccupiedSpace"
+static unsigned long long BenchIsOccupiedSpace(unsigned long long calls)
+{
+    unsigned long long sum = 0ull; // results of every call
+    unsigned long long i = 0ull; // loop iterator for the calls
+
+    for (i = 0ull; i < calls; i++)
+    {
+        sum += (unsigned long long)IsOccupiedSpace(&inputs.games[i & (BENCH_GAMES - 1)], inputs.squares[i & BENCH_INPUT_MASK]);
+    }
+    return sum;
+}
+
+// method for "PieceBelongToPlayer"
+static unsigned long long BenchPieceBelongToPlayer(unsigned long long calls)
+{
+    unsigned long long sum = 0ull; // results of every call
+    unsigned long long i = 0ull; // loop iterator for the calls
+
+    for (i = 0ull; i < calls; i++)
+    {
+        sum += (unsigned long long)PieceBelongToPlayer(&inputs.games[i & (BENCH_GAMES - 1)], inputs.squares[i & BENCH_INPUT_MASK]);
+    }
+    return sum;
+}
+
+// method for "EvaluatePosition", the default weights on the features kept up to date by MakeMove
+static unsigned long long BenchEvaluatePosition(unsigned long long calls)
+{
+    unsigned long long sum = 0ull; // results of every call
+    unsigned long long i = 0ull; // loop iterator for the calls
+
+    for (i = 0ull; i < calls; i++)
+    {
+        sum += (unsigned long long)EvaluatePosition(&inputs.games[i & (BENCH_GAMES - 1)], &defaultEvalWeights);
+    }
+    return sum;
+}
+
+// method for "EvaluateFromScratch", the same score with every feature counted again from the bitboards
+static unsigned long long BenchEvaluateFromScratch(unsigned long long calls)
+{
+    unsigned long long sum = 0ull; // results of every call
+    unsigned long long i = 0ull; // loop iterator for the calls
+
+    for (i = 0ull; i < calls; i++)
+    {
+        GameState game = inputs.games[i & (BENCH_GAMES - 1)]; // copy whose features are counted again
+
+        ComputeEvalTerms(&game);
+        sum += (unsigned long long)EvaluatePosition(&game, &defaultEvalWeights);
+    }
+    return sum;
+}
+
+// every benchmark, in output order
+static const Benchmark benchmarks[] =
+{
+    { "baseline", BenchBaseline },
+    { "SetBit", BenchSetBit },
+    { "ClearBit", BenchClearBit },
+    { "ToggleBit", BenchToggleBit },
+    { "GetBit", BenchGetBit },
+    { "CountBits", BenchCountBits },
+    { "ShiftLeft", BenchShiftLeft },
+    { "ShiftRight", BenchShiftRight },
+    { "CreateMask", BenchCreateMask },
+    { "ConvertRowColToIndex", BenchConvertRowColToIndex },
+    { "IsValidDarkSquare", BenchIsValidDarkSquare },
+    { "IsOccupiedSpace", BenchIsOccupiedSpace },
+    { "PieceBelongToPlayer", BenchPieceBelongToPlayer },
+    { "EvaluatePosition", BenchEvaluatePosition },
+    { "EvaluateFromScratch", BenchEvaluateFromScratch }
+};
+
+// number of benchmarks
+#define BENCH_COUNT ((int)(sizeof(benchmarks) / sizeof(benchmarks[0])))
+
+// Harness //
+
+// method for qsort, orders samples from fastest to slowest
+static int CompareSamples(const void* a, const void* b)
+{
+    double left = *(const double*)a; // first sample
+    double right = *(const double*)b; // second sample
+    return (left > right) - (left < right);
+}
+
+// method to time "benchmark" with "reps" samples of about "sampleMs" each into "result"
+// "samples" holds "reps" values
+static void RunBenchmark(const Benchmark* benchmark, int reps, int sampleMs, double* samples, BenchResult* result)
+{
+    unsigned long long calls = 1024ull; // calls per sample
+    unsigned long long sampleNs = (unsigned long long)sampleMs * 1000000ull; // target sample length
+    unsigned long long start = 0ull; // clock at the start of a sample or the warmup
+    int i = 0; // loop iterator for the samples
+
+    // calibrate: double the calls until one sample takes long enough
+    while (1)
+    {
+        unsigned long long elapsed = 0ull; // length of this sample
+
+        start = NowNs();
+        benchSink += benchmark->run(calls);
+        elapsed = NowNs() - start;
+        if (elapsed >= sampleNs || calls >= (1ull << 40)) { break; }
+        calls *= 2ull;
+    }
+
+    // warmup: caches, branch predictors and the CPU clock settle before timing
+    start = NowNs();
+    while (NowNs() - start < (unsigned long long)BENCH_WARMUP_MS * 1000000ull) { benchSink += benchmark->run(calls); }
+
+    for (i = 0; i < reps; i++)
+    {
+        unsigned long long begin = NowNs(); // clock at the start of this sample
+
+        benchSink += benchmark->run(calls);
+        samples[i] = (double)(NowNs() - begin) / (double)calls;
+    }
+    qsort(samples, (size_t)reps, sizeof(double), CompareSamples);
+
+    result->name = benchmark->name;
+    result->median = samples[reps / 2];
+    result->p99 = samples[(reps * 99 + 99) / 100 - 1];
+    result->fastest = samples[0];
+    result->calls = calls;
+}
+
+// method to write the results as tab separated lines to "filename", returns 1 on success
+static int WriteResults(const char* filename, const BenchResult* results, int count, int reps)
+{
+    FILE* file = fopen(filename, "w"); // results file
+    int written = 1; // flagger cleared if any write fails
+    int i = 0; // loop iterator for the results
+
+    if (file == NULL) { return 0; }
+    if (fprintf(file, "# microbench reps=%d\nname\tmedian_ns\tp99_ns\tmin_ns\tcalls_per_sample\n", reps) < 0) { written = 0; }
+    for (i = 0; i < count; i++)
+    {
+        if (fprintf(file, "%s\t%.3f\t%.3f\t%.3f\t%llu\n", results[i].name, results[i].median, results[i].p99,
+            results[i].fastest, results[i].calls) < 0) { written = 0; }
+    }
+    if (fclose(file) != 0) { written = 0; }
+    return written;
+}
+
+// method to compare the medians with the results file "filename" written by an earlier run
+// returns the number of regressions (medians more than "threshold" percent slower), -1 if the file cannot be read
+static int CompareResults(const char* filename, const BenchResult* results, int count, double threshold)
+{
+    FILE* file = fopen(filename, "r"); // earlier results file
+    char line[BENCH_LINE_MAX]; // current line
+    int regressions = 0; // slower benchmarks
+    int i = 0; // loop iterator for the results
+
+    if (file == NULL) { return -1; }
+
+    printf("\n%-22s %12s %12s %9s\n", "compared with", "before ns", "now ns", "change");
+    for (i = 0; i < count; i++)
+    {
+        double before = -1.0; // earlier median, -1 if the benchmark is new
+
+        rewind(file);
+        while (fgets(line, sizeof(line), file) != NULL)
+        {
+            char name[BENCH_LINE_MAX]; // benchmark name of the line
+            double median = 0.0; // its median
+
+            if (line[0] == '#') { continue; }
+            if (sscanf(line, "%255s %lf", name, &median) == 2 && strcmp(name, results[i].name) == 0) { before = median; }
+        }
+
+        if (before <= 0.0) { printf("%-22s %12s %12.3f %9s\n", results[i].name, "-", results[i].median, "new"); }
+        else
+        {
+            double change = (results[i].median - before) / before * 100.0; // percent slower (+) or faster (-)
+            int slower = change > threshold; // flagger for a regression
+
+            printf("%-22s %12.3f %12.3f %+8.1f%%%s\n", results[i].name, before, results[i].median, change, slower ? "  SLOWER" : "");
+            regressions += slower;
+        }
+    }
+    fclose(file);
+    return regressions;
+}
+
+// method for running the microbenchmarks (entry point)
+int main(int argc, char* argv[])
+{
+    BenchResult results[BENCH_COUNT]; // result of each benchmark run
+    double* samples = NULL; // per-call times of the current benchmark
+    int reps = BENCH_DEFAULT_REPS; // samples per benchmark
+    int sampleMs = BENCH_DEFAULT_SAMPLE_MS; // length of one sample
+    double threshold = BENCH_DEFAULT_THRESHOLD; // regression threshold in percent
+    const char* filter = NULL; // name filter, NULL for every benchmark
+    const char* outputName = NULL; // results file, NULL for none
+    const char* compareName = NULL; // earlier results file, NULL for none
+    int count = 0; // benchmarks run
+    int regressions = 0; // benchmarks slower than before
+    int i = 0; // loop iterator for arguments and benchmarks
+
+    StatsDumpOnExit(); // instrumented builds print the game core counters at exit
+
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--reps") == 0 && i + 1 < argc) { reps = atoi(argv[++i]); }
+        else if (strcmp(argv[i], "--sample-ms") == 0 && i + 1 < argc) { sampleMs = atoi(argv[++i]); }
+        else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) { filter = argv[++i]; }
+        else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) { outputName = argv[++i]; }
+        else if (strcmp(argv[i], "--compare") == 0 && i + 1 < argc) { compareName = argv[++i]; }
+        else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) { threshold = atof(argv[++i]); }
+        else { reps = 0; break; }
+    }
+
+    // qualifier: every option needs a sensible value
+    if (reps < 1 || reps > BENCH_MAX_REPS || sampleMs < 1 || threshold < 0.0)
+    {
+        printf("Usage: %s [--reps N] [--sample-ms MS] [--filter TEXT] [--output FILE] [--compare FILE] [--threshold PCT]\n", argv[0]);
+        printf("       --reps between 1 and %d, --sample-ms at least 1, --threshold at least 0\n", BENCH_MAX_REPS);
+        return 1;
+    }
+
+    samples = (double*)malloc((size_t)reps * sizeof(double));
+    if (samples == NULL)
+    {
+        printf("Not enough memory.\n");
+        return 1;
+    }
+    MakeInputs();
+
+    printf("%-22s %12s %12s %12s %14s %14s\n", "benchmark", "median ns", "p99 ns", "min ns", "calls/second", "calls/sample");
+    for (i = 0; i < BENCH_COUNT; i++)
+    {
+        // qualifier: "--filter" keeps the matching names only
+        if (filter != NULL && strstr(benchmarks[i].name, filter) == NULL) { continue; }
+
+        RunBenchmark(&benchmarks[i], reps, sampleMs, samples, &results[count]);
+        printf("%-22s %12.3f %12.3f %12.3f %14.0f %14llu\n", results[count].name, results[count].median, results[count].p99,
+            results[count].fastest, (results[count].median > 0.0) ? 1e9 / results[count].median : 0.0, results[count].calls);
+        fflush(stdout);
+        count++;
+    }
+    free(samples);
+
+    if (outputName != NULL)
+    {
+        if (!WriteResults(outputName, results, count, reps))
+        {
+            printf("Could not write the results: %s\n", outputName);
+            return 1;
+        }
+        printf("Results written to %s\n", outputName);
+    }
+
+    if (compareName != NULL)
+    {
+        regressions = CompareResults(compareName, results, count, threshold);
+        if (regressions < 0)
+        {
+            printf("Could not read the earlier results: %s\n", compareName);
+            return 1;
+        }
+        printf("%d benchmark(s) more than %.1f%% slower\n", regressions, threshold);
+    }
+    return (regressions > 0) ? 1 : 0;
+}
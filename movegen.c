@@ -0,0 +1,509 @@
+// [movegen.c] file
+
+// note: every mask below is a 64-bit unsigned literal (ull) so
+// shifting a whole board never runs into sign related issues
+
+#include <stddef.h> // for NULL
+#include <stdio.h> // for snprintf (MoveToText)
+#include <stdlib.h> // for atoi (MoveFromText)
+#include <string.h> // for strcmp / strpbrk (MoveFromText) and memcpy of the features
+
+#include "movegen.h" // declare "movegen" and "game" variables/methods
+#include "zobrist.h" // incremental position key updates
+#include "movetables.h" // generated neighbor / jump tables and row masks
+#include "bitoperations.h" // 64-bit bit scans for walking over set bits
+#include "stats.h" // instrumentation counters (compiled in with GAME_STATS only)
+
+// every square except column 0, pieces here may step "left" (col - 1)
+#define NOT_COL_0 0xFEFEFEFEFEFEFEFEull
+
+// every square except column 7, pieces here may step "right" (col + 1)
+#define NOT_COL_7 0x7F7F7F7F7F7F7F7Full
+
+// diagonal directions as index offsets:
+// Down-Right, Down-Left (forward for Player 1 Red), Up-Right, Up-Left (forward for Player 2 Black)
+static const int directionShift[4] = { 9, 7, -7, -9 };
+
+// squares allowed to step in each direction without wrapping around the board edge
+static const unsigned long long directionMask[4] = { NOT_COL_7, NOT_COL_0, NOT_COL_7, NOT_COL_0 };
+
+// method to add the evaluation features of a piece of Zobrist "type" on "square" to "terms", times "sign" (1 or -1)
+static void UpdateEvalTerms(int* terms, int type, int square, int sign)
+{
+    const signed char* features = evalSquareTerms[type][square]; // features of the piece
+    int term = 0; // loop iterator for the features
+
+    for (term = 0; term < EVAL_SQUARE_TERMS; term++) { terms[term] += sign * features[term]; }
+}
+
+// method to shift a whole bitboard by a signed diagonal offset
+// positive offsets move pieces "down" the board, negative offsets move them "up"
+static unsigned long long ShiftBoard(unsigned long long board, int shift)
+{
+    // qualifier: positive offset shifts left (towards larger indexes)
+    if (shift > 0) { return board << shift; }
+
+    // otherwise, negative offset shifts right (towards smaller indexes)
+    return board >> (-shift);
+}
+
+// working data shared by one capture chain search in ExpandCaptures()
+typedef struct
+{
+    MoveList* list; // list receiving every finished chain
+    unsigned long long opponent; // opponent pieces that can be jumped
+    unsigned long long empty; // squares a jump may land on
+    unsigned long long promotionRow; // far row for the moving side's men
+    int from; // square the chain started from
+    int firstDirection; // first direction the moving piece may use
+    int lastDirection; // last direction the moving piece may use
+    unsigned char path[MAX_JUMPS]; // landing squares of the chain so far
+} CaptureChain;
+
+// method to append a move to "list", unless the list is already full
+// capture chains reaching the same TO over the same pieces are only stored once
+static void AddMove(MoveList* list, int from, int to, unsigned long long captured, int jumps, const unsigned char* path)
+{
+    int i = 0; // loop iterator for duplicate checks and path copying
+
+    // qualifier: never write past the end of the move array
+    if (list->count >= MAX_MOVES) { return; }
+
+    // qualifier: a king can circle the same pieces in two orders, keep only one of them
+    if (jumps > 1)
+    {
+        for (i = 0; i < list->count; i++)
+        {
+            const Move* other = &list->moves[i]; // previously stored move
+            if (other->from == from && other->to == to && other->captured == captured) { return; }
+        }
+    }
+
+    list->moves[list->count].from = from;
+    list->moves[list->count].to = to;
+    list->moves[list->count].captured = captured;
+    list->moves[list->count].jumps = jumps;
+
+    // copy the landing squares of every jump in the chain
+    for (i = 0; i < jumps; i++) { list->moves[list->count].path[i] = path[i]; }
+
+    list->count = list->count + 1;
+}
+
+// method to find every continuation of a capture chain from "square"
+// "captured" holds the pieces already jumped, which cannot be jumped again
+// a chain that cannot continue is stored as a finished move
+// returns 1 if the piece on "square" had at least one more jump, otherwise 0
+static int ExpandCaptures(CaptureChain* chain, int square, int jumps, unsigned long long captured)
+{
+    int found = 0; // flagger for at least one continuation
+    int i = 0; // loop iterator for the allowed directions
+
+    // qualifier: the chain can never be longer than the number of opponent pieces
+    if (jumps >= MAX_JUMPS) { return 0; }
+
+    // try every direction the moving piece may jump in
+    for (i = chain->firstDirection; i <= chain->lastDirection; i++)
+    {
+        unsigned long long jumped = 0ull; // opponent piece being jumped over
+        unsigned long long landing = 0ull; // empty square behind it
+        int to = 0; // landing square of this jump
+
+        // a not yet jumped opponent piece next to the square (0 when no jump fits on the board),
+        // then an empty square behind it, both looked up in the generated tables
+        jumped = jumpOverMask[square][i] & chain->opponent & ~captured;
+        if (jumped == 0ull) { continue; }
+        landing = jumpLandingMask[square][i] & chain->empty;
+
+        // qualifier: skip directions without a capture
+        if (landing == 0ull) { continue; }
+        to = jumpLandingSquare[square][i];
+
+        found = 1;
+        chain->path[jumps] = (unsigned char)to;
+
+        // qualifier: a man reaching the far row is promoted and the move ends there,
+        // otherwise keep jumping and store the chain once it cannot continue
+        if ((landing & chain->promotionRow) != 0ull || !ExpandCaptures(chain, to, jumps + 1, captured | jumped))
+        {
+            AddMove(chain->list, chain->from, to, captured | jumped, jumps + 1, chain->path);
+        }
+    }
+
+    return found;
+}
+
+// method to find every piece that can make at least one capture,
+// for all pieces at once in each direction
+// "firstForward" is the first of the two forward directions for the men (0 Red, 2 Black)
+static unsigned long long FindJumpers(unsigned long long men, unsigned long long kings, unsigned long long opponent,
+    unsigned long long empty, int firstForward)
+{
+    unsigned long long jumpers = 0ull; // pieces with at least one capture
+    int i = 0; // loop iterator for the 4 directions
+
+    for (i = 0; i < 4; i++)
+    {
+        int shift = directionShift[i]; // index offset for one diagonal step
+        unsigned long long movers = kings; // kings may always use this direction
+        unsigned long long landing = 0ull; // landing squares of single jumps
+
+        // qualifier: men may only use the two forward directions
+        if (i == firstForward || i == firstForward + 1) { movers = movers | men; }
+
+        // one step onto an opponent (not on the edge), then one more onto an empty square
+        landing = ShiftBoard(ShiftBoard(movers & directionMask[i], shift) & opponent & directionMask[i], shift) & empty;
+
+        // shift the landing squares back two steps to find the jumping pieces
+        jumpers = jumpers | ShiftBoard(landing, -2 * shift);
+    }
+    return jumpers;
+}
+
+// generate every legal move for the player to move ("current_turn")
+// only full capture chains are generated when any capture exists, otherwise every step
+// fills "list" and returns the number of moves generated (0 if the player is blocked)
+int GenerateMoves(const GameState* game, MoveList* list)
+{
+    unsigned long long men = 0ull; // men of the player to move
+    unsigned long long kings = 0ull; // kings of the player to move
+    unsigned long long opponent = 0ull; // every piece of the other player
+    unsigned long long empty = 0ull; // dark squares with no piece on them
+    unsigned long long promotionRow = 0ull; // far row where men of the player to move promote
+    unsigned long long jumpers = 0ull; // pieces with at least one capture
+    int firstForward = 0; // first of the two forward directions for the player to move
+    int i = 0; // loop iterator for the 4 directions
+
+    list->count = 0; // start from an empty list
+    STAT_ADD(STAT_GENERATE_CALLS, 1);
+
+    // qualifier: pick the pieces and forward directions for whoever is moving
+    // Player 1 (Red) moves "down" (directions 0, 1), Player 2 (Black) moves "up" (directions 2, 3)
+    if (IsRedPlayer1Turn(game))
+    {
+        men = game->player1_men;
+        kings = game->player1_kings;
+        opponent = game->player2_men | game->player2_kings;
+        promotionRow = promotionRowMask[1];
+        firstForward = 0;
+    }
+    else
+    {
+        men = game->player2_men;
+        kings = game->player2_kings;
+        opponent = game->player1_men | game->player1_kings;
+        promotionRow = promotionRowMask[2];
+        firstForward = 2;
+    }
+
+    // every dark square that is not occupied by either player
+    empty = darkSquareMask & ~(men | kings | opponent);
+
+    // find every piece that can capture
+    jumpers = FindJumpers(men, kings, opponent, empty, firstForward);
+
+    // qualifier: captures are mandatory, expand every capture chain and skip simple steps
+    if (jumpers != 0ull)
+    {
+        CaptureChain chain; // shared chain data for every jumping piece
+
+        chain.list = list;
+        chain.opponent = opponent;
+        chain.promotionRow = promotionRow;
+
+        while (jumpers != 0ull)
+        {
+            int from = PopLowestBit64(&jumpers); // square of the next jumping piece (cleared from "jumpers")
+
+            // the jumping piece leaves its square, so a king may pass back through it
+            chain.empty = empty | (1ull << from);
+            chain.from = from;
+
+            // qualifier: kings jump in all 4 directions, men only in their 2 forward directions
+            if ((kings & (1ull << from)) != 0ull)
+            {
+                chain.firstDirection = 0;
+                chain.lastDirection = 3;
+                chain.promotionRow = 0ull; // kings are never promoted again
+            }
+            else
+            {
+                chain.firstDirection = firstForward;
+                chain.lastDirection = firstForward + 1;
+                chain.promotionRow = promotionRow;
+            }
+
+            ExpandCaptures(&chain, from, 0, 0ull);
+        }
+
+        return list->count; // number of capture chains found
+    }
+
+    // otherwise, no captures exist so every simple step is legal
+    for (i = 0; i < 4; i++)
+    {
+        int shift = directionShift[i]; // index offset for one diagonal step
+        unsigned long long movers = kings; // kings may always use this direction
+        unsigned long long steps = 0ull; // landing squares for simple steps
+
+        // qualifier: men may only use the two forward directions
+        if (i == firstForward || i == firstForward + 1) { movers = movers | men; }
+
+        // simple step: one diagonal square onto an empty dark square
+        steps = ShiftBoard(movers & directionMask[i], shift) & empty;
+
+        // serialise every simple step, the FROM square is one step back from the landing square
+        while (steps != 0ull)
+        {
+            int to = PopLowestBit64(&steps); // landing square of this step (cleared from "steps")
+            AddMove(list, to - shift, to, 0ull, 0, NULL);
+        }
+    }
+
+    return list->count; // number of simple steps found
+}
+
+// check if the player to move has at least one capture (captures are then mandatory)
+// returns 1 if a capture exists, otherwise 0
+int HasCapture(const GameState* game)
+{
+    unsigned long long all = game->player1_men | game->player1_kings | game->player2_men | game->player2_kings;
+    unsigned long long empty = darkSquareMask & ~all; // dark squares with no piece on them
+
+    // qualifier: Player 1 (Red) men jump "down" (directions 0, 1), Player 2 (Black) men jump "up" (directions 2, 3)
+    if (IsRedPlayer1Turn(game))
+    {
+        return FindJumpers(game->player1_men, game->player1_kings, game->player2_men | game->player2_kings, empty, 0) != 0ull;
+    }
+    return FindJumpers(game->player2_men, game->player2_kings, game->player1_men | game->player1_kings, empty, 2) != 0ull;
+}
+
+// apply a move produced by GenerateMoves to "game", without printing anything
+// moves the piece, removes every captured piece, promotes a man reaching the far row,
+// and passes the turn to the other player
+void MakeMove(GameState* game, const Move* move, MoveRecord* record)
+{
+    unsigned long long fromMask = (1ull << move->from); // FROM square mask
+    unsigned long long toMask = (1ull << move->to); // TO square mask
+    unsigned long long key = game->zobrist_key; // position key, updated with XORs
+    unsigned long long captured = move->captured; // captured squares left to hash
+    int moverType = 0; // Zobrist piece type of the moving piece before the move
+    int landType = 0; // Zobrist piece type of the moving piece after the move
+    int menType = 0; // Zobrist piece type of the captured men
+    int kingsType = 0; // Zobrist piece type of the captured kings
+
+    record->move = *move;
+    record->player = game->current_turn;
+    record->movedKing = 0;
+    record->promoted = 0;
+    record->previousKey = key;
+    memcpy(record->previousTerms, game->eval_terms, sizeof(record->previousTerms));
+
+    // note: pieces are cleared from FROM before being set on TO, since a king's
+    // capture chain can end on the same square it started from
+
+    // player 1 (Red) moves, Black loses every captured piece
+    if (IsRedPlayer1Turn(game))
+    {
+        moverType = ZOBRIST_P1_MEN;
+        menType = ZOBRIST_P2_MEN;
+        kingsType = ZOBRIST_P2_KINGS;
+
+        // qualifier: move the king, or move the man and promote it on row 7
+        if ((game->player1_kings & fromMask) != 0ull)
+        {
+            game->player1_kings = (game->player1_kings & ~fromMask) | toMask;
+            record->movedKing = 1;
+            moverType = ZOBRIST_P1_KINGS;
+        }
+        else if ((toMask & promotionRowMask[1]) != 0ull)
+        {
+            game->player1_men &= ~fromMask;
+            game->player1_kings |= toMask;
+            record->promoted = 1;
+        }
+        else { game->player1_men = (game->player1_men & ~fromMask) | toMask; }
+
+        record->capturedKings = game->player2_kings & move->captured;
+        game->player2_men &= ~move->captured;
+        game->player2_kings &= ~move->captured;
+        game->current_turn = 2;
+        landType = (record->promoted || record->movedKing) ? ZOBRIST_P1_KINGS : ZOBRIST_P1_MEN;
+    }
+
+    // player 2 (Black) moves, Red loses every captured piece
+    else
+    {
+        moverType = ZOBRIST_P2_MEN;
+        menType = ZOBRIST_P1_MEN;
+        kingsType = ZOBRIST_P1_KINGS;
+
+        // qualifier: move the king, or move the man and promote it on row 0
+        if ((game->player2_kings & fromMask) != 0ull)
+        {
+            game->player2_kings = (game->player2_kings & ~fromMask) | toMask;
+            record->movedKing = 1;
+            moverType = ZOBRIST_P2_KINGS;
+        }
+        else if ((toMask & promotionRowMask[2]) != 0ull)
+        {
+            game->player2_men &= ~fromMask;
+            game->player2_kings |= toMask;
+            record->promoted = 1;
+        }
+        else { game->player2_men = (game->player2_men & ~fromMask) | toMask; }
+
+        record->capturedKings = game->player1_kings & move->captured;
+        game->player1_men &= ~move->captured;
+        game->player1_kings &= ~move->captured;
+        game->current_turn = 1;
+        landType = (record->promoted || record->movedKing) ? ZOBRIST_P2_KINGS : ZOBRIST_P2_MEN;
+    }
+
+    // update the key and the features: the piece leaves FROM and lands on TO (as a king if promoted)
+    key = key ^ zobristPieces[moverType][move->from] ^ zobristPieces[landType][move->to];
+    UpdateEvalTerms(game->eval_terms, moverType, move->from, -1);
+    UpdateEvalTerms(game->eval_terms, landType, move->to, 1);
+
+    // every captured piece leaves the key and the features, as a man or a king
+    while (captured != 0ull)
+    {
+        int square = PopLowestBit64(&captured); // next captured square (cleared from "captured")
+        unsigned long long mask = (1ull << square); // its bitboard mask
+        int type = ((record->capturedKings & mask) != 0ull) ? kingsType : menType; // Zobrist type of the captured piece
+
+        key = key ^ zobristPieces[type][square];
+        UpdateEvalTerms(game->eval_terms, type, square, -1);
+    }
+
+    // the turn passed to the other player
+    game->zobrist_key = key ^ zobristTurn;
+
+    STAT_ADD(STAT_MOVES_MADE, 1);
+    STAT_ADD(STAT_CAPTURES, move->jumps);
+    if (record->promoted) { STAT_ADD(STAT_PROMOTIONS, 1); }
+}
+
+// undo the move described by "record", restoring "game" to the position before MakeMove
+void UnmakeMove(GameState* game, const MoveRecord* record)
+{
+    unsigned long long fromMask = (1ull << record->move.from); // FROM square mask
+    unsigned long long toMask = (1ull << record->move.to); // TO square mask
+    unsigned long long capturedMen = record->move.captured & ~record->capturedKings; // captured men
+
+    // player 1 (Red) made the move, put the piece back and return Black's pieces
+    if (record->player == 1)
+    {
+        // qualifier: a king or a promoted man is taken off the king bitboard
+        if (record->movedKing) { game->player1_kings = (game->player1_kings & ~toMask) | fromMask; }
+        else if (record->promoted)
+        {
+            game->player1_kings &= ~toMask;
+            game->player1_men |= fromMask;
+        }
+        else { game->player1_men = (game->player1_men & ~toMask) | fromMask; }
+
+        game->player2_men |= capturedMen;
+        game->player2_kings |= record->capturedKings;
+    }
+
+    // player 2 (Black) made the move, put the piece back and return Red's pieces
+    else
+    {
+        // qualifier: a king or a promoted man is taken off the king bitboard
+        if (record->movedKing) { game->player2_kings = (game->player2_kings & ~toMask) | fromMask; }
+        else if (record->promoted)
+        {
+            game->player2_kings &= ~toMask;
+            game->player2_men |= fromMask;
+        }
+        else { game->player2_men = (game->player2_men & ~toMask) | fromMask; }
+
+        game->player1_men |= capturedMen;
+        game->player1_kings |= record->capturedKings;
+    }
+
+    game->current_turn = record->player; // the mover is to move again
+    game->zobrist_key = record->previousKey; // and the key is the one before the move
+    memcpy(game->eval_terms, record->previousTerms, sizeof(game->eval_terms)); // as are the features
+}
+
+// apply a move produced by GenerateMoves to "game", same as MakeMove without keeping a record
+void ApplyMove(GameState* game, const Move* move)
+{
+    MoveRecord record; // discarded after the move is applied
+    MakeMove(game, move, &record);
+}
+
+// write a move as text into "buffer" (holds at least "size" characters)
+// "FROM-TO" for a simple step (Example: 21-28) or "FROMxLANDxLAND..." for a capture chain (Example: 28x42)
+// returns "buffer" so it can be passed straight to printf
+char* MoveToText(const Move* move, char* buffer, int size)
+{
+    int length = 0; // characters written so far
+    int i = 0; // loop iterator for the capture path
+
+    // qualifier: simple step
+    if (move->jumps == 0)
+    {
+        snprintf(buffer, (size_t)size, "%d-%d", move->from, move->to);
+        return buffer;
+    }
+
+    // otherwise, write every landing square of the capture chain
+    length = snprintf(buffer, (size_t)size, "%d", move->from);
+    for (i = 0; i < move->jumps && length > 0 && length < size; i++)
+    {
+        length = length + snprintf(buffer + length, (size_t)(size - length), "x%d", move->path[i]);
+    }
+    return buffer;
+}
+
+// find the legal move of "game" written as "text"
+int FindMovesBetween(const GameState* game, int from, int to, MoveList* matches)
+{
+    MoveList list; // legal moves of "game"
+    int i = 0; // loop iterator for the legal moves
+
+    GenerateMoves(game, &list);
+    matches->count = 0;
+    for (i = 0; i < list.count; i++)
+    {
+        if (list.moves[i].from == from && list.moves[i].to == to) { matches->moves[matches->count++] = list.moves[i]; }
+    }
+    return matches->count;
+}
+
+int MoveFromText(const GameState* game, const char* text, Move* move)
+{
+    MoveList list; // legal moves of "game", then the ones with the shorthand's FROM and TO
+    char buffer[64]; // text of one legal move
+    const char* separator = NULL; // "-" or "x" after the FROM square
+    int from = -1; // FROM square of the shorthand
+    int to = -1; // TO square of the shorthand
+    int i = 0; // loop iterator for the legal moves
+
+    GenerateMoves(game, &list);
+
+    // qualifier: the full text of a legal move
+    for (i = 0; i < list.count; i++)
+    {
+        if (strcmp(MoveToText(&list.moves[i], buffer, (int)sizeof(buffer)), text) == 0)
+        {
+            *move = list.moves[i];
+            return 1;
+        }
+    }
+
+    // otherwise, the shorthand "FROM-TO" / "FROMxTO" with the final landing square
+    separator = strpbrk(text, "-x");
+    if (separator == NULL || strpbrk(separator + 1, "-x") != NULL) { return 0; }
+    from = atoi(text);
+    to = atoi(separator + 1);
+    if (separator == text || separator[1] < '0' || separator[1] > '9') { return 0; }
+
+    // qualifier: two capture chains between the same squares need the full path
+    if (FindMovesBetween(game, from, to, &list) != 1) { return 0; }
+    *move = list.moves[0];
+    return 1;
+}
@@ -0,0 +1,108 @@
+// [movegen.h] header file
+// function declarations for "movegen.c"
+// implemented in "game.c" / "main.c"
+
+#ifndef MOVEGEN_H
+#define MOVEGEN_H
+
+#include "game.h" // implement GameState structure
+
+// { Phase 3 - Bitboard Move Generation } //
+// generates every legal step and capture for the player to move
+// using whole-board shift and mask operations instead of a per-square scan
+
+/*
+    The board uses the same 0-63 indexing as "game.c" (index = row * 8 + col)
+    A diagonal step is a shift of the whole bitboard:
+
+        +9 Down-Right   +7 Down-Left    (Player 1 Red men move "down")
+        -7 Up-Right     -9 Up-Left      (Player 2 Black men move "up")
+
+    Column masks stop pieces on the edge columns from wrapping around
+    to the other side of the board when shifted. Kings shift in all 4 directions.
+
+    Each generated move records its FROM and TO squares and a bitboard
+    of the opponent squares it jumps over (0 for a simple step)
+
+    Captures follow the regular checkers rules:
+        - a capture is mandatory, if any piece can jump only captures are generated
+        - a capture continues for as long as the same piece can keep jumping,
+          the whole chain is generated as one move (TO is the final landing square)
+        - a man that lands on the far row is promoted and its move ends there
+*/
+
+// upper bound on the number of moves a single position can generate
+#define MAX_MOVES 128
+
+// upper bound on the number of jumps in one capture chain (every opponent piece)
+#define MAX_JUMPS 12
+
+// one legal move for the player to move
+typedef struct
+{
+    int from; // starting square (0-63)
+    int to; // landing square (0-63)
+    unsigned long long captured; // bitboard of jumped opponent squares, 0ull for a simple step
+    int jumps; // number of pieces jumped, 0 for a simple step
+    unsigned char path[MAX_JUMPS]; // landing square after each jump, path[jumps - 1] == to
+} Move;
+
+// list of moves filled by GenerateMoves
+typedef struct
+{
+    Move moves[MAX_MOVES]; // generated moves, in direction order
+    int count; // number of moves stored in "moves"
+} MoveList;
+
+// generate every legal move for the player to move ("current_turn")
+// only full capture chains are generated when any capture exists, otherwise every step
+// fills "list" and returns the number of moves generated (0 if the player is blocked)
+int GenerateMoves(const GameState* game, MoveList* list);
+
+// check if the player to move has at least one capture, without generating the moves
+// returns 1 if a capture exists (only captures are then legal), otherwise 0
+int HasCapture(const GameState* game);
+
+// record of one applied move, filled by MakeMove and used by UnmakeMove
+// holds everything needed to undo the move and to describe it to the players
+typedef struct MoveRecord
+{
+    Move move; // the move that was applied
+    int player; // player who made the move, 1 for Red or 2 for Black
+    int movedKing; // 1 if the moving piece was already a king, otherwise 0
+    int promoted; // 1 if a man was promoted to KING by this move, otherwise 0
+    unsigned long long capturedKings; // captured squares that held a king (subset of move.captured)
+    unsigned long long previousKey; // "zobrist_key" before the move, restored by UnmakeMove
+    int previousTerms[EVAL_SQUARE_TERMS]; // "eval_terms" before the move, restored by UnmakeMove
+} MoveRecord;
+
+// apply a move produced by GenerateMoves to "game", without printing anything
+// moves the piece, removes every captured piece, promotes a man reaching the far row,
+// and passes the turn to the other player, updating "zobrist_key" with XORs along the way
+// and "eval_terms" with the feature tables of the pieces that moved, left or were promoted
+// "record" receives what happened, so UnmakeMove can undo it and the UI can report it
+void MakeMove(GameState* game, const Move* move, MoveRecord* record);
+
+// undo the move described by "record", restoring "game" to the position before MakeMove
+void UnmakeMove(GameState* game, const MoveRecord* record);
+
+// apply a move produced by GenerateMoves to "game", same as MakeMove without keeping a record
+void ApplyMove(GameState* game, const Move* move);
+
+// write a move as text into "buffer" (holds at least "size" characters)
+// "FROM-TO" for a simple step (Example: 21-28) or "FROMxLANDxLAND..." for a capture chain (Example: 28x42)
+// returns "buffer" so it can be passed straight to printf
+char* MoveToText(const Move* move, char* buffer, int size);
+
+// fill "matches" with every legal move of "game" going from "from" to "to"
+// more than one match means several capture chains share FROM and TO but jump different pieces
+// returns the number of matches (0 if no legal move goes from FROM to TO)
+int FindMovesBetween(const GameState* game, int from, int to, MoveList* matches);
+
+// find the legal move of "game" written as "text" (see MoveToText), the reverse of MoveToText
+// a capture chain may also be written as "FROMxTO" (or "FROM-TO") with its final landing square,
+// as long as only one legal chain goes from FROM to TO (see FindMovesBetween)
+// returns 1 and fills "move" if the move is legal, otherwise 0
+int MoveFromText(const GameState* game, const char* text, Move* move);
+
+#endif
@@ -0,0 +1,55 @@
+// [movetables.h] header file
+// table declarations for "movetables.c" (generated by "gentables.c" during the build)
+// implemented in "movegen.c" / "game.c" / "evaluate.c"
+
+#ifndef MOVETABLES_H
+#define MOVETABLES_H
+
+#include "game.h" // EVAL_SQUARE_TERMS for the evaluation tables
+
+// { Phase 4 - Precomputed Move Tables } //
+// neighbor and jump lookups for every square, worked out once at build time
+
+/*
+    "movetables.c" is not written by hand: the Makefile builds "gentables"
+    and runs it to write the file, so the row / column arithmetic happens
+    once during the build and the move code only indexes the results.
+
+    Tables indexed by [square][direction] use the directions of "movegen.c":
+
+        0 Down-Right (+9), 1 Down-Left (+7)   forward for Player 1 (Red)
+        2 Up-Right (-7),   3 Up-Left (-9)     forward for Player 2 (Black)
+
+    Square tables hold an index (0-63) or TABLE_NO_SQUARE, mask tables hold a
+    single bit or 0, when the step leaves the board or starts on a light square.
+*/
+
+// square table entry for a step that leaves the board
+#define TABLE_NO_SQUARE -1
+
+// all playable dark squares ("#"), where (row + col) is odd
+extern const unsigned long long darkSquareMask;
+
+// promotion row by player: [1] row 7 for Player 1 (Red), [2] row 0 for Player 2 (Black), [0] is empty
+extern const unsigned long long promotionRowMask[3];
+
+// square one diagonal step away
+extern const signed char neighborSquare[64][4];
+extern const unsigned long long neighborMask[64][4];
+
+// landing square of a jump, two diagonal steps away
+extern const signed char jumpLandingSquare[64][4];
+extern const unsigned long long jumpLandingMask[64][4];
+
+// square jumped over, only set when the landing square is on the board
+extern const unsigned long long jumpOverMask[64][4];
+
+// evaluation features (EVAL_TERM_*, "game.h") of a piece standing on a square,
+// by Zobrist piece type (Red men, Red kings, Black men, Black kings), Black pieces count negative
+extern const signed char evalSquareTerms[4][64][EVAL_SQUARE_TERMS];
+
+// dark squares in front of a man, by player like "promotionRowMask": every square up to the
+// promotion row that lies within reach of its path, a man with no opposing piece there is a runaway
+extern const unsigned long long runawayConeMask[3][64];
+
+#endif
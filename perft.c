@@ -0,0 +1,183 @@
+// [perft.c] file
+// run the perft (performance test) benchmark here!
+
+/*
+    Perft counts every leaf position of the game tree up to a fixed depth.
+    The counts only depend on the rules, so they check the move generator
+    for correctness, and the time taken measures move generation speed.
+
+    Usage:
+        ./perft <depth> [savefile] [--divide]
+
+        <depth>     search depth in plies (1-20)
+        [savefile]  optional 5-line save file (same format as LoadGame),
+                    otherwise the starting position from SetBoard is used
+        [--divide]  print the node count under each root move at <depth>
+
+    Without "--divide", every depth from 1 to <depth> is counted and
+    reported with its time and nodes per second. From the starting position
+    each count is compared against the known-good perft results.
+*/
+
+#include <stdio.h> // for printing
+#include <stdlib.h> // for parsing the depth argument
+#include <string.h> // for comparing arguments
+#include <time.h> // for timespec_get (wall clock timing)
+
+#include "game.h" // GameState structure and game functions
+#include "movegen.h" // GenerateMoves / ApplyMove
+#include "saveload.h" // LoadGame for starting from a save file
+#include "stats.h" // game core counters of instrumented builds
+
+// deepest depth accepted on the command line
+#define PERFT_MAX_DEPTH 20
+
+// known-good perft counts from the starting position, indexed by depth (1-12)
+static const unsigned long long knownCounts[13] =
+{
+    1ull, 7ull, 49ull, 302ull, 1469ull, 7361ull, 36768ull, 179740ull,
+    845931ull, 3963680ull, 18391564ull, 85242128ull, 388617999ull
+};
+
+// method to read the wall clock in seconds
+static double WallSeconds(void)
+{
+    struct timespec now; // current wall clock time
+    timespec_get(&now, TIME_UTC);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+// method to count every leaf position "depth" plies below "game"
+// leaf moves are counted straight from the move list (bulk counting)
+// "game" is changed by MakeMove and restored by UnmakeMove before returning
+static unsigned long long Perft(GameState* game, int depth)
+{
+    MoveList list; // every legal move in this position
+    unsigned long long nodes = 0ull; // leaf count below this position
+    int i = 0; // loop iterator for the moves
+
+    GenerateMoves(game, &list);
+
+    // qualifier: one ply left, every generated move is a leaf
+    if (depth <= 1) { return (unsigned long long)list.count; }
+
+    // otherwise, make each move, count below it, then unmake it
+    for (i = 0; i < list.count; i++)
+    {
+        MoveRecord record; // undo information for this move
+        MakeMove(game, &list.moves[i], &record);
+        nodes = nodes + Perft(game, depth - 1);
+        UnmakeMove(game, &record);
+    }
+    return nodes;
+}
+
+// method to print the node count below every root move at "depth"
+static void Divide(const GameState* game, int depth)
+{
+    MoveList list; // every legal root move
+    unsigned long long total = 0ull; // sum over all root moves
+    double start = WallSeconds(); // time when counting started
+    double elapsed = 0.0; // time taken for every root move
+    int i = 0; // loop iterator for the root moves
+
+    GenerateMoves(game, &list);
+
+    for (i = 0; i < list.count; i++)
+    {
+        GameState next = *game; // copy of the root to apply the move on
+        unsigned long long nodes = 1ull; // a depth 1 root move is one leaf
+        char text[64]; // move in "FROM-TO" / "FROMxLAND" notation
+
+        ApplyMove(&next, &list.moves[i]);
+
+        // qualifier: count below the move only when more plies remain
+        if (depth > 1) { nodes = Perft(&next, depth - 1); }
+
+        printf("%s: %llu\n", MoveToText(&list.moves[i], text, (int)sizeof(text)), nodes);
+        total = total + nodes;
+    }
+
+    elapsed = WallSeconds() - start;
+    printf("\nMoves: %d\n", list.count);
+    printf("Nodes: %llu\n", total);
+    printf("Time:  %.3f s\n", elapsed);
+}
+
+// method for running the perft benchmark (entry point)
+int main(int argc, char* argv[])
+{
+    GameState game; // root position
+    int depth = 0; // deepest depth to count
+    int divide = 0; // flagger for "--divide" mode
+    int fromStart = 1; // flagger for starting from SetBoard (known counts apply)
+    const char* filename = NULL; // optional save file
+    int i = 0; // loop iterator for arguments and depths
+
+    StatsDumpOnExit(); // instrumented builds print the game core counters at exit
+
+    // qualifier: the depth argument is required
+    if (argc < 2)
+    {
+        printf("Usage: %s <depth> [savefile] [--divide]\n", argv[0]);
+        return 1;
+    }
+
+    depth = atoi(argv[1]);
+
+    // qualifier: keep the depth inside a sensible range
+    if (depth < 1 || depth > PERFT_MAX_DEPTH)
+    {
+        printf("Depth must be between 1 and %d.\n", PERFT_MAX_DEPTH);
+        return 1;
+    }
+
+    // remaining arguments are the divide flag and an optional save file
+    for (i = 2; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--divide") == 0) { divide = 1; }
+        else { filename = argv[i]; }
+    }
+
+    SetBoard(&game); // start from the initial position by default
+
+    // qualifier: load the save file if one was given
+    if (filename != NULL)
+    {
+        if (!LoadGame(filename, &game)) { return 1; }
+        fromStart = 0; // known counts only apply to the starting position
+    }
+
+    PrintBoardPretty(&game);
+
+    // qualifier: divide mode prints one count per root move
+    if (divide)
+    {
+        Divide(&game, depth);
+        return 0;
+    }
+
+    // otherwise, count every depth up to "depth" and report the speed
+    printf("depth %15s %10s %15s\n", "nodes", "seconds", "nodes/second");
+    for (i = 1; i <= depth; i++)
+    {
+        double start = WallSeconds(); // time when this depth started
+        unsigned long long nodes = Perft(&game, i); // leaf count for this depth
+        double elapsed = WallSeconds() - start; // time taken for this depth
+        double rate = 0.0; // nodes per second
+
+        // qualifier: avoid dividing by zero on very small depths
+        if (elapsed > 0.0) { rate = (double)nodes / elapsed; }
+
+        printf("%5d %15llu %10.3f %15.0f", i, nodes, elapsed, rate);
+
+        // qualifier: from the starting position, compare against the known counts
+        if (fromStart && i <= 12)
+        {
+            if (nodes == knownCounts[i]) { printf("  ok"); }
+            else { printf("  MISMATCH (expected %llu)", knownCounts[i]); }
+        }
+        printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,130 @@
+// [posdb.c] file
+
+#include <string.h> // for comparing the header magic
+
+#include "posdb.h" // declare "posdb", "game" and "mapfile" variables/methods
+#include "board32.h" // 32-square layout used by the records
+
+// first 8 bytes of every database file
+static const unsigned char posdbMagic[8] = { 'B', 'B', 'C', 'K', 'P', 'O', 'S', '1' };
+
+// size of the writer's file buffer, records are written in large blocks
+#define WRITER_BUFFER_BYTES (1u << 20)
+
+// method to write a 32-bit number as 4 little-endian bytes
+static void Write32(unsigned char* bytes, unsigned int value)
+{
+    bytes[0] = (unsigned char)(value & 0xFFu);
+    bytes[1] = (unsigned char)((value >> 8) & 0xFFu);
+    bytes[2] = (unsigned char)((value >> 16) & 0xFFu);
+    bytes[3] = (unsigned char)((value >> 24) & 0xFFu);
+}
+
+// method to read 4 little-endian bytes as a 32-bit number
+static unsigned int Read32(const unsigned char* bytes)
+{
+    return (unsigned int)bytes[0] | ((unsigned int)bytes[1] << 8)
+        | ((unsigned int)bytes[2] << 16) | ((unsigned int)bytes[3] << 24);
+}
+
+// pack "game" into the POSDB_RECORD_BYTES bytes at "record"
+void PackPosition(const GameState* game, unsigned char* record)
+{
+    PackedBoard packed; // 32-square layout of "game"
+
+    PackBoard(game, &packed);
+    Write32(record, packed.red);
+    Write32(record + 4, packed.black);
+    Write32(record + 8, packed.kings);
+    record[12] = (unsigned char)packed.turn;
+}
+
+// unpack the record at "record" into "game"
+int UnpackPosition(const unsigned char* record, GameState* game)
+{
+    PackedBoard packed; // record fields in the 32-square layout
+
+    packed.red = Read32(record);
+    packed.black = Read32(record + 4);
+    packed.kings = Read32(record + 8);
+    packed.turn = record[12];
+    return UnpackBoard(&packed, game);
+}
+
+// create (or overwrite) the database "filename" and write its header
+int OpenPositionWriter(const char* filename, PositionWriter* writer)
+{
+    unsigned char header[POSDB_HEADER_BYTES] = { 0 }; // magic, record size, reserved
+
+    writer->count = 0ull;
+    writer->failed = 0;
+    writer->file = fopen(filename, "wb");
+    if (writer->file == NULL) { return 0; }
+
+    // large buffer, millions of small records are written in big blocks
+    setvbuf(writer->file, NULL, _IOFBF, WRITER_BUFFER_BYTES);
+
+    memcpy(header, posdbMagic, sizeof(posdbMagic));
+    Write32(header + 8, POSDB_RECORD_BYTES);
+    if (fwrite(header, 1u, sizeof(header), writer->file) != sizeof(header)) { writer->failed = 1; }
+    return 1;
+}
+
+// append "game" as one record
+int WritePosition(PositionWriter* writer, const GameState* game)
+{
+    unsigned char record[POSDB_RECORD_BYTES]; // packed position
+
+    PackPosition(game, record);
+    if (fwrite(record, 1u, sizeof(record), writer->file) != sizeof(record))
+    {
+        writer->failed = 1;
+        return 0;
+    }
+    writer->count++;
+    return 1;
+}
+
+// flush and close the database
+int ClosePositionWriter(PositionWriter* writer)
+{
+    if (fclose(writer->file) != 0) { writer->failed = 1; }
+    writer->file = NULL;
+    return !writer->failed;
+}
+
+// map the database "filename" and check its header
+int OpenPositionDatabase(const char* filename, PositionDatabase* database)
+{
+    database->records = NULL;
+    database->count = 0ull;
+
+    if (!MapFile(filename, &database->map)) { return 0; }
+
+    // qualifier: the header must be complete and match this format
+    if (database->map.size < POSDB_HEADER_BYTES || memcmp(database->map.data, posdbMagic, sizeof(posdbMagic)) != 0
+        || Read32(database->map.data + 8) != POSDB_RECORD_BYTES
+        || (database->map.size - POSDB_HEADER_BYTES) % POSDB_RECORD_BYTES != 0u)
+    {
+        UnmapFile(&database->map);
+        return 0;
+    }
+
+    database->records = database->map.data + POSDB_HEADER_BYTES;
+    database->count = (unsigned long long)((database->map.size - POSDB_HEADER_BYTES) / POSDB_RECORD_BYTES);
+    return 1;
+}
+
+// pointer to record "index" inside the mapping, no copy is made
+const unsigned char* PositionRecord(const PositionDatabase* database, unsigned long long index)
+{
+    return database->records + (size_t)index * POSDB_RECORD_BYTES;
+}
+
+// release the mapping of a database opened by OpenPositionDatabase
+void ClosePositionDatabase(PositionDatabase* database)
+{
+    UnmapFile(&database->map);
+    database->records = NULL;
+    database->count = 0ull;
+}
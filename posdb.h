@@ -0,0 +1,94 @@
+// [posdb.h] header file
+// function declarations for "posdb.c"
+// implemented in "posdbtool.c"
+
+#ifndef POSDB_H
+#define POSDB_H
+
+#include <stdio.h> // for FILE (database writer)
+
+#include "game.h" // implement GameState structure
+#include "mapfile.h" // implement MappedFile structure
+
+// { Phase 4 - Binary Position Database } //
+// stores millions of positions in a compact fixed-size binary format,
+// the text save files (SaveGame / LoadGame) keep working unchanged
+
+/*
+    Only the 32 dark squares can hold a piece, so each record stores the
+    32-square layout from "board32.h": bit (n - 1) is square n in the
+    standard checkers numbering (square 1 is index 1, square 32 is index 62).
+
+    File layout, every number little-endian:
+
+        header, POSDB_HEADER_BYTES (16) bytes:
+            bytes 0-7    magic text "BBCKPOS1"
+            bytes 8-11   record size (POSDB_RECORD_BYTES)
+            bytes 12-15  reserved (0)
+
+        records, POSDB_RECORD_BYTES (13) bytes each, back to back:
+            bytes 0-3    PackedBoard "red"    (Red pieces, men and kings)
+            bytes 4-7    PackedBoard "black"  (Black pieces, men and kings)
+            bytes 8-11   PackedBoard "kings"  (kings of either player)
+            byte  12     PackedBoard "turn"   (1 Red, 2 Black)
+
+    A text save file is about 60 bytes, a record is 13. The record count
+    follows from the file size, so files can simply be appended to.
+
+    The reader maps the file (see "mapfile.h") and hands out pointers to
+    the records inside the mapping; nothing is copied or parsed until a
+    record is unpacked.
+*/
+
+// size of the file header and of one record, in bytes
+#define POSDB_HEADER_BYTES 16
+#define POSDB_RECORD_BYTES 13
+
+// pack "game" into the POSDB_RECORD_BYTES bytes at "record"
+void PackPosition(const GameState* game, unsigned char* record);
+
+// unpack the record at "record" into "game" (bitboards, "current_turn" and "zobrist_key")
+// returns 1 on success, 0 if the record is invalid (Red and Black on one square,
+// a king on an empty square, or a turn other than 1 / 2), "game" is then unchanged
+int UnpackPosition(const unsigned char* record, GameState* game);
+
+// writes a new database file, records are buffered
+typedef struct
+{
+    FILE* file; // open database file
+    unsigned long long count; // records written so far
+    int failed; // flagger set if any write failed
+} PositionWriter;
+
+// create (or overwrite) the database "filename" and write its header
+// returns 1 on success, 0 if the file could not be created
+int OpenPositionWriter(const char* filename, PositionWriter* writer);
+
+// append "game" as one record
+// returns 1 on success, 0 if the write failed
+int WritePosition(PositionWriter* writer, const GameState* game);
+
+// flush and close the database
+// returns 1 if every record was written, 0 if any write failed
+int ClosePositionWriter(PositionWriter* writer);
+
+// a database opened for reading, the records stay inside the file mapping
+typedef struct
+{
+    MappedFile map; // whole file, mapped read-only
+    const unsigned char* records; // first record (inside "map")
+    unsigned long long count; // number of records
+} PositionDatabase;
+
+// map the database "filename" and check its header
+// returns 1 on success, 0 if the file is missing, has no valid header,
+// or ends with a partial record
+int OpenPositionDatabase(const char* filename, PositionDatabase* database);
+
+// pointer to record "index" (0 to count - 1) inside the mapping, no copy is made
+const unsigned char* PositionRecord(const PositionDatabase* database, unsigned long long index);
+
+// release the mapping of a database opened by OpenPositionDatabase
+void ClosePositionDatabase(PositionDatabase* database);
+
+#endif
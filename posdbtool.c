@@ -0,0 +1,407 @@
+// [posdbtool.c] file
+
+#include <stdio.h> // for printing and naming files
+#include <stdlib.h> // for malloc / free of the record numbers
+#include <string.h> // for comparing arguments
+#include <time.h> // for timespec_get (read speed)
+
+#include "posdbtool.h" // declare "posdbtool" methods
+#include "bitoperations.h" // PopCount64 for the piece counts
+#include "evalbatch.h" // batch evaluation for "dbscore"
+#include "evaluate.h" // search score of every record for "dbscore --output"
+#include "filewalk.h" // WalkFiles for directories of save files
+#include "game.h" // GameState and PositionProblem
+#include "posdb.h" // binary records and the mapped database
+#include "saveload.h" // ReadGameFile / WriteGameFile
+
+// records evaluated together by "dbscore", bounds the memory used for any database size
+#define DBSCORE_CHUNK 65536
+
+// state shared by the "pack" file visitor
+typedef struct
+{
+    PositionWriter writer; // database being written
+    unsigned long long skipped; // files that were unreadable or held impossible positions
+} PackRun;
+
+// method to read the wall clock in seconds
+static double WallSeconds(void)
+{
+    struct timespec now; // current wall clock time
+    timespec_get(&now, TIME_UTC);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+// method to pack one save file found by WalkFiles, "context" is the PackRun
+static void PackFile(const char* path, void* context)
+{
+    PackRun* run = (PackRun*)context; // database and counters
+    GameState game; // position read from the file
+    int errorLine = 0; // first invalid line of the file
+    const char* problem = NULL; // why the position is impossible
+
+    // qualifier: unreadable files are reported and skipped
+    if (!ReadGameFile(path, &game, &errorLine))
+    {
+        if (errorLine == 0) { fprintf(stderr, "Could not open save file, skipped: %s\n", path); }
+        else { fprintf(stderr, "Invalid save file (line %d), skipped: %s\n", errorLine, path); }
+        run->skipped++;
+        return;
+    }
+
+    // qualifier: an impossible position would not survive the 32-square record
+    problem = PositionProblem(&game);
+    if (problem != NULL)
+    {
+        fprintf(stderr, "Impossible position (%s), skipped: %s\n", problem, path);
+        run->skipped++;
+        return;
+    }
+
+    WritePosition(&run->writer, &game);
+}
+
+// run the "pack" command
+int RunPack(int argc, char* argv[])
+{
+    PackRun run; // database and counters
+    int errors = 0; // unreadable paths
+    int closed = 0; // flagger for every record reaching the disk
+    int i = 0; // loop iterator for the paths
+
+    // qualifier: a database and at least one path are required
+    if (argc < 2)
+    {
+        printf("Usage: bitboardcheckers pack <database> <dir|files...>\n");
+        return 1;
+    }
+
+    run.skipped = 0ull;
+    if (!OpenPositionWriter(argv[0], &run.writer))
+    {
+        printf("Could not open file for writing: %s\n", argv[0]);
+        return 1;
+    }
+
+    for (i = 1; i < argc; i++) { errors = errors + WalkFiles(argv[i], PackFile, &run); }
+
+    closed = ClosePositionWriter(&run.writer);
+    if (!closed) { printf("Could not write every record to: %s\n", argv[0]); }
+
+    printf("Packed %llu positions into \"%s\" (%llu files skipped, %d paths unreadable).\n",
+        run.writer.count, argv[0], run.skipped, errors);
+    return (closed && run.skipped == 0ull && errors == 0) ? 0 : 1;
+}
+
+// run the "unpack" command
+int RunUnpack(int argc, char* argv[])
+{
+    PositionDatabase database; // mapped database
+    unsigned long long index = 0ull; // loop iterator for the records
+    unsigned long long written = 0ull; // save files written
+    unsigned long long failed = 0ull; // invalid records and failed writes
+
+    // qualifier: a database and an output folder are required
+    if (argc != 2)
+    {
+        printf("Usage: bitboardcheckers unpack <database> <folder>\n");
+        return 1;
+    }
+
+    if (!OpenPositionDatabase(argv[0], &database))
+    {
+        printf("Could not open position database: %s\n", argv[0]);
+        return 1;
+    }
+
+    for (index = 0ull; index < database.count; index++)
+    {
+        GameState game; // unpacked record
+        char filename[4096]; // save file for this record
+
+        // qualifier: invalid records are reported and skipped
+        if (!UnpackPosition(PositionRecord(&database, index), &game))
+        {
+            fprintf(stderr, "Invalid record %llu, skipped.\n", index + 1ull);
+            failed++;
+            continue;
+        }
+
+        snprintf(filename, sizeof(filename), "%s/position_%08llu", argv[1], index + 1ull);
+        if (!WriteGameFile(filename, &game))
+        {
+            fprintf(stderr, "Could not open file for writing: %s\n", filename);
+            failed++;
+            continue;
+        }
+        written++;
+    }
+
+    ClosePositionDatabase(&database);
+    printf("Unpacked %llu positions into \"%s\" (%llu failed).\n", written, argv[1], failed);
+    return (failed == 0ull) ? 0 : 1;
+}
+
+// run the "dbinfo" command
+int RunDbInfo(int argc, char* argv[])
+{
+    PositionDatabase database; // mapped database
+    unsigned long long index = 0ull; // loop iterator for the records
+    unsigned long long invalid = 0ull; // records that do not unpack
+    unsigned long long redToMove = 0ull; // records with Red to move
+    unsigned long long pieces[25] = { 0ull }; // records by total piece count (0-24)
+    unsigned long long check = 0ull; // XOR of every position key, keeps the read loop from being skipped
+    double start = 0.0; // time when reading started
+    double elapsed = 0.0; // time taken to read every record
+    int total = 0; // loop iterator for the piece counts
+
+    // qualifier: exactly one database is required
+    if (argc != 1)
+    {
+        printf("Usage: bitboardcheckers dbinfo <database>\n");
+        return 1;
+    }
+
+    if (!OpenPositionDatabase(argv[0], &database))
+    {
+        printf("Could not open position database: %s\n", argv[0]);
+        return 1;
+    }
+
+    start = WallSeconds();
+    for (index = 0ull; index < database.count; index++)
+    {
+        GameState game; // unpacked record
+        unsigned long long board = 0ull; // every piece, for counting
+        int count = 0; // pieces in this record
+
+        // qualifier: count records that do not unpack
+        if (!UnpackPosition(PositionRecord(&database, index), &game))
+        {
+            invalid++;
+            continue;
+        }
+
+        if (game.current_turn == 1) { redToMove++; }
+        board = game.player1_men | game.player1_kings | game.player2_men | game.player2_kings;
+        count = PopCount64(board);
+        pieces[count]++;
+        check = check ^ game.zobrist_key;
+    }
+    elapsed = WallSeconds() - start;
+
+    printf("Database:        %s\n", argv[0]);
+    printf("Records:         %llu (%llu bytes each, %llu bytes total)\n", database.count,
+        (unsigned long long)POSDB_RECORD_BYTES, (unsigned long long)database.map.size);
+    printf("Invalid records: %llu\n", invalid);
+    printf("Red to move:     %llu\n", redToMove);
+    printf("Black to move:   %llu\n", database.count - invalid - redToMove);
+    printf("Pieces on board:\n");
+    for (total = 0; total <= 24; total++)
+    {
+        if (pieces[total] > 0ull) { printf("  %2d pieces: %llu\n", total, pieces[total]); }
+    }
+    printf("Read time:       %.3f s", elapsed);
+    if (elapsed > 0.0) { printf(" (%.0f records/second)", (double)database.count / elapsed); }
+    printf("\nKey checksum:    %016llx\n", check);
+
+    ClosePositionDatabase(&database);
+    return (invalid == 0ull) ? 0 : 1;
+}
+
+// method to count the positions where two feature batches disagree on any feature
+static int CountDifferences(const FeatureBatch* a, const FeatureBatch* b, int count)
+{
+    int differences = 0; // positions with at least one different feature
+    int i = 0; // loop iterator for the positions
+
+    for (i = 0; i < count; i++)
+    {
+        if (a->material[i] != b->material[i] || a->kings[i] != b->kings[i] || a->mobility[i] != b->mobility[i]
+            || a->advancement[i] != b->advancement[i] || a->materialScore[i] != b->materialScore[i])
+        {
+            differences++;
+        }
+    }
+    return differences;
+}
+
+// run the "dbscore" command
+int RunDbScore(int argc, char* argv[])
+{
+    const char* databaseName = NULL; // database to score
+    const char* outputName = NULL; // CSV file for the features, NULL for none
+    const char* weightsName = NULL; // "--weights" file for the search score, NULL for the defaults
+    EvalWeights weights = defaultEvalWeights; // weights of the search score column
+    int check = 0; // flagger for "--check", compare against the scalar backend
+    PositionDatabase database; // mapped database
+    PositionBatch batch; // one chunk of unpacked records
+    FeatureBatch features; // features of the chunk from EvaluateBatch
+    FeatureBatch reference; // features of the chunk from EvaluateBatchScalar ("--check")
+    unsigned long long* numbers = NULL; // record number of each position in the chunk
+    int* evals = NULL; // search score of each position in the chunk ("--output")
+    FILE* output = NULL; // open CSV file
+    unsigned long long index = 0ull; // next record to unpack
+    unsigned long long scored = 0ull; // positions evaluated
+    unsigned long long invalid = 0ull; // records that do not unpack
+    unsigned long long differences = 0ull; // positions where the backends disagree
+    double materialSum = 0.0; // for the average material
+    double mobilitySum = 0.0; // for the average mobility
+    double batchSeconds = 0.0; // time spent in EvaluateBatch
+    double scalarSeconds = 0.0; // time spent in EvaluateBatchScalar
+    int ready = 0; // flagger for every buffer being allocated
+    int failed = 0; // flagger for a CSV file that could not be written
+    int i = 0; // loop iterator for arguments and positions
+
+    // read the options, the one other argument is the database
+    for (i = 0; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) { outputName = argv[++i]; }
+        else if (strcmp(argv[i], "--weights") == 0 && i + 1 < argc) { weightsName = argv[++i]; }
+        else if (strcmp(argv[i], "--check") == 0) { check = 1; }
+        else if (databaseName == NULL) { databaseName = argv[i]; }
+        else { databaseName = NULL; break; }
+    }
+
+    // qualifier: exactly one database is required
+    if (databaseName == NULL)
+    {
+        printf("Usage: bitboardcheckers dbscore [--check] [--output FILE] [--weights FILE] <database>\n");
+        return 1;
+    }
+    if (weightsName != NULL)
+    {
+        int errorLine = 0; // first invalid line of the weight file
+
+        if (!LoadEvalWeights(weightsName, &weights, &errorLine))
+        {
+            if (errorLine > 0) { printf("Invalid weight in %s, line %d.\n", weightsName, errorLine); }
+            else { printf("Could not read weight file %s.\n", weightsName); }
+            return 1;
+        }
+    }
+
+    if (!OpenPositionDatabase(databaseName, &database))
+    {
+        printf("Could not open position database: %s\n", databaseName);
+        return 1;
+    }
+
+    // every buffer is sized for one chunk, the reference only with "--check"
+    ready = InitPositionBatch(&batch, DBSCORE_CHUNK);
+    ready = InitFeatureBatch(&features, DBSCORE_CHUNK) && ready;
+    ready = (!check || InitFeatureBatch(&reference, DBSCORE_CHUNK)) && ready;
+    numbers = (unsigned long long*)malloc(DBSCORE_CHUNK * sizeof(unsigned long long));
+    evals = (int*)malloc(DBSCORE_CHUNK * sizeof(int));
+    if (!ready || numbers == NULL || evals == NULL)
+    {
+        printf("Out of memory.\n");
+        FreePositionBatch(&batch);
+        FreeFeatureBatch(&features);
+        if (check) { FreeFeatureBatch(&reference); }
+        free(numbers);
+        free(evals);
+        ClosePositionDatabase(&database);
+        return 1;
+    }
+
+    if (outputName != NULL)
+    {
+        output = fopen(outputName, "w");
+        if (output == NULL)
+        {
+            printf("Could not open file for writing: %s\n", outputName);
+            failed = 1;
+        }
+        else { fprintf(output, "record,turn,material,kings,mobility,advancement,material_score,eval\n"); }
+    }
+
+    while (index < database.count && !failed)
+    {
+        double start = 0.0; // time when a backend started
+
+        // unpack the next chunk, skipping invalid records
+        batch.count = 0;
+        while (batch.count < DBSCORE_CHUNK && index < database.count)
+        {
+            GameState game; // unpacked record
+
+            if (UnpackPosition(PositionRecord(&database, index), &game))
+            {
+                // qualifier: the search score is only worked out for the CSV rows, it is not timed
+                if (output != NULL)
+                {
+                    ComputeEvalTerms(&game);
+                    evals[batch.count] = EvaluatePosition(&game, &weights);
+                }
+                numbers[batch.count] = index + 1ull;
+                AddToPositionBatch(&batch, &game);
+            }
+            else { invalid++; }
+            index++;
+        }
+
+        start = WallSeconds();
+        EvaluateBatch(&batch, &features);
+        batchSeconds = batchSeconds + (WallSeconds() - start);
+
+        // qualifier: "--check" scores the chunk again one position at a time and compares
+        if (check)
+        {
+            start = WallSeconds();
+            EvaluateBatchScalar(&batch, &reference);
+            scalarSeconds = scalarSeconds + (WallSeconds() - start);
+            differences = differences + (unsigned long long)CountDifferences(&features, &reference, batch.count);
+        }
+
+        for (i = 0; i < batch.count; i++)
+        {
+            materialSum = materialSum + features.material[i];
+            mobilitySum = mobilitySum + features.mobility[i];
+            if (output != NULL)
+            {
+                fprintf(output, "%llu,%d,%d,%d,%d,%d,%d,%d\n", numbers[i], batch.turn[i], features.material[i],
+                    features.kings[i], features.mobility[i], features.advancement[i], features.materialScore[i], evals[i]);
+            }
+        }
+        scored = scored + (unsigned long long)batch.count;
+    }
+
+    printf("Database:        %s\n", databaseName);
+    printf("Positions:       %llu (%llu invalid records skipped)\n", scored, invalid);
+    printf("Backend:         %s\n", EvalBatchBackend());
+    printf("Evaluate time:   %.3f s", batchSeconds);
+    if (batchSeconds > 0.0) { printf(" (%.0f positions/second)", (double)scored / batchSeconds); }
+    printf("\n");
+    if (check)
+    {
+        printf("Scalar time:     %.3f s", scalarSeconds);
+        if (scalarSeconds > 0.0) { printf(" (%.0f positions/second)", (double)scored / scalarSeconds); }
+        printf("\nScalar check:    %llu positions differ\n", differences);
+    }
+    if (scored > 0ull)
+    {
+        printf("Average material (Red - Black): %+.1f\n", materialSum / (double)scored);
+        printf("Average mobility (Red - Black): %+.2f\n", mobilitySum / (double)scored);
+    }
+
+    // qualifier: report a CSV file that could not be written completely
+    if (output != NULL)
+    {
+        int writeError = ferror(output); // flagger for a failed row
+
+        if (fclose(output) != 0 || writeError)
+        {
+            printf("Could not write every row to: %s\n", outputName);
+            failed = 1;
+        }
+    }
+
+    FreePositionBatch(&batch);
+    FreeFeatureBatch(&features);
+    if (check) { FreeFeatureBatch(&reference); }
+    free(numbers);
+    free(evals);
+    ClosePositionDatabase(&database);
+    return (!failed && invalid == 0ull && differences == 0ull) ? 0 : 1;
+}
@@ -0,0 +1,53 @@
+// [posdbtool.h] header file
+// function declarations for "posdbtool.c"
+// implemented in "main.c"
+
+#ifndef POSDBTOOL_H
+#define POSDBTOOL_H
+
+// { Phase 4 - Binary Position Database } //
+// command line converters between text save files and a position database
+
+/*
+    Usage:
+        ./bitboardcheckers pack <database> <dir|files...>
+            read every 5-line save file (folders include their sub-folders)
+            and write them as records into a new <database>
+            unreadable files and impossible positions are reported and skipped
+
+        ./bitboardcheckers unpack <database> <folder>
+            write every record of <database> as a 5-line save file into the
+            existing <folder>, named "position_00000001", "position_00000002", ...
+
+        ./bitboardcheckers dbinfo <database>
+            read every record straight from the mapped file and print the
+            record count, invalid records, side to move, piece counts and
+            how many records per second were unpacked
+
+        ./bitboardcheckers dbscore [--check] [--output FILE] [--weights FILE] <database>
+            evaluate every record with the batch evaluator (see "evalbatch.h")
+            and print the backend used and the positions scored per second
+            --output FILE   write "record,turn,material,kings,mobility,advancement,material_score,eval"
+                            rows, "eval" is the score the search uses (see "evaluate.h")
+            --weights FILE  weights of the "eval" column (default: the built-in weights)
+            --check         also evaluate one position at a time and count the
+                            positions where the two results differ (should be 0)
+*/
+
+// run the "pack" command, "argc" / "argv" are the arguments after "pack"
+// returns 0 on success, 1 on a usage error or if any file was skipped
+int RunPack(int argc, char* argv[]);
+
+// run the "unpack" command, "argc" / "argv" are the arguments after "unpack"
+// returns 0 on success, 1 on a usage error or if any file could not be written
+int RunUnpack(int argc, char* argv[]);
+
+// run the "dbinfo" command, "argc" / "argv" are the arguments after "dbinfo"
+// returns 0 on success, 1 on a usage error or if the database has invalid records
+int RunDbInfo(int argc, char* argv[]);
+
+// run the "dbscore" command, "argc" / "argv" are the arguments after "dbscore"
+// returns 0 on success, 1 on a usage or write error, invalid records or a failed "--check"
+int RunDbScore(int argc, char* argv[]);
+
+#endif
@@ -0,0 +1,182 @@
+// [recordtool.c] file
+
+#include <stdio.h> // for printing and reading PDN files
+#include <string.h> // for comparing arguments and moves
+#include <time.h> // for timespec_get (replay time)
+
+#include "recordtool.h" // declare "recordtool" methods
+#include "gamerecord.h" // game records and PDN files
+#include "filewalk.h" // WalkFiles for directories of PDN files
+#include "game.h" // GameState structure
+#include "zobrist.h" // ComputeZobristKey for "--check"
+#include "evaluate.h" // ComputeEvalTerms for "--check"
+
+// state shared by the "replay" file visitor
+typedef struct
+{
+    GameRecord record; // game being replayed, its memory is reused for every game
+    GameRecord copy; // game read back from its PDN text ("--check")
+    int check; // flagger set by "--check"
+    unsigned long long games; // games replayed
+    unsigned long long plies; // moves replayed
+    double seconds; // time spent replaying, reading the files is not counted
+    unsigned long long illegal; // games with an illegal move or bad FEN tag
+    unsigned long long failed; // games that failed a check
+    int unreadable; // files that could not be opened
+} ReplayRun;
+
+// method to read the wall clock in seconds
+static double WallSeconds(void)
+{
+    struct timespec now; // current wall clock time
+    timespec_get(&now, TIME_UTC);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+// method to check that two positions hold the same pieces, turn and key
+static int SamePosition(const GameState* a, const GameState* b)
+{
+    return a->player1_men == b->player1_men && a->player1_kings == b->player1_kings
+        && a->player2_men == b->player2_men && a->player2_kings == b->player2_kings
+        && a->current_turn == b->current_turn && a->zobrist_key == b->zobrist_key;
+}
+
+// method to check that the evaluation features kept in "game" match the ones counted from its bitboards
+static int SameEvalTerms(const GameState* game)
+{
+    GameState counted = *game; // copy whose features are counted again
+
+    ComputeEvalTerms(&counted);
+    return memcmp(counted.eval_terms, game->eval_terms, sizeof(counted.eval_terms)) == 0;
+}
+
+// method to verify one game for "--check", returns a short description of the first problem, NULL if none
+static const char* CheckRecord(ReplayRun* run)
+{
+    GameRecord* record = &run->record; // game read from the file
+    GameState game = record->start; // position while walking the game
+    FILE* text = NULL; // PDN text of the game, written and read back
+    const char* problem = NULL; // problem reported by the PDN reader
+    int line = 1; // line counter of the PDN reader
+    int ply = 0; // loop iterator for the moves
+
+    // every key and feature kept by MakeMove must match the ones computed from scratch
+    record->ply = 0;
+    while (RedoRecordMove(record, &game))
+    {
+        if (game.zobrist_key != ComputeZobristKey(&game)) { return "position key differs after a move"; }
+        if (!SameEvalTerms(&game)) { return "evaluation features differ after a move"; }
+    }
+
+    // undoing every move must return to the start, with the keys and features restored on the way
+    while (UndoRecordMove(record, &game))
+    {
+        if (game.zobrist_key != ComputeZobristKey(&game)) { return "position key differs after an undo"; }
+        if (!SameEvalTerms(&game)) { return "evaluation features differ after an undo"; }
+    }
+    if (!SamePosition(&game, &record->start)) { return "undo did not return to the start position"; }
+
+    // the game written to PDN must read back with the same start and moves
+    text = tmpfile();
+    if (text == NULL) { return "could not open a temporary file"; }
+    if (!WritePdnGame(text, record))
+    {
+        fclose(text);
+        return "could not write the game as PDN";
+    }
+    rewind(text);
+    if (!ReadPdnGame(text, &run->copy, &line, &problem))
+    {
+        fclose(text);
+        return "the written PDN game could not be read back";
+    }
+    fclose(text);
+
+    if (!SamePosition(&run->copy.start, &record->start) || run->copy.count != record->count) { return "PDN round trip changed the game"; }
+    for (ply = 0; ply < record->count; ply++)
+    {
+        if (memcmp(&run->copy.moves[ply], &record->moves[ply], sizeof(PackedMove)) != 0) { return "PDN round trip changed a move"; }
+    }
+    return NULL;
+}
+
+// method to replay every game of one PDN file found by WalkFiles, "context" is the ReplayRun
+static void ReplayFile(const char* path, void* context)
+{
+    ReplayRun* run = (ReplayRun*)context; // records and counters
+    const char* problem = NULL; // why a game could not be read
+    int line = 1; // line counter of the PDN reader
+    FILE* file = fopen(path, "r"); // PDN file
+
+    if (file == NULL)
+    {
+        fprintf(stderr, "Could not open PDN file, skipped: %s\n", path);
+        run->unreadable++;
+        return;
+    }
+
+    while (ReadPdnGame(file, &run->record, &line, &problem))
+    {
+        GameState game; // position while replaying
+        double start = WallSeconds(); // wall clock before the replay
+        const char* failure = NULL; // check problem of the game
+
+        ReplayRecord(&run->record, run->record.count, &game);
+        run->seconds += WallSeconds() - start;
+        run->games++;
+        run->plies += (unsigned long long)run->record.count;
+
+        if (run->check && (failure = CheckRecord(run)) != NULL)
+        {
+            fprintf(stderr, "%s: game %llu: %s\n", path, run->games, failure);
+            run->failed++;
+        }
+    }
+
+    // qualifier: the reader stops at an illegal move, the rest of the file is skipped
+    if (problem != NULL)
+    {
+        fprintf(stderr, "%s:%d: %s, rest of the file skipped\n", path, line, problem);
+        run->illegal++;
+    }
+    fclose(file);
+}
+
+// run the "replay" command
+int RunReplay(int argc, char* argv[])
+{
+    ReplayRun run; // records and counters
+    GameState start; // placeholder start of the empty records
+    int argument = 0; // first path argument
+    int i = 0; // loop iterator for the paths
+
+    memset(&run, 0, sizeof(run));
+    if (argument < argc && strcmp(argv[argument], "--check") == 0)
+    {
+        run.check = 1;
+        argument++;
+    }
+
+    // qualifier: at least one PDN file or folder is required
+    if (argument >= argc)
+    {
+        printf("Usage: bitboardcheckers replay [--check] <dir|files...>\n");
+        return 1;
+    }
+
+    SetBoard(&start);
+    InitGameRecord(&run.record, &start);
+    InitGameRecord(&run.copy, &start);
+
+    for (i = argument; i < argc; i++) { run.unreadable += WalkFiles(argv[i], ReplayFile, &run); }
+
+    printf("Games: %llu replayed, %llu plies", run.games, run.plies);
+    if (run.seconds > 0.0) { printf(", %.0f positions/s", (double)run.plies / run.seconds); }
+    printf("\n");
+    if (run.check) { printf("Checked: %llu games passed, %llu failed\n", run.games - run.failed, run.failed); }
+    if (run.illegal > 0ull) { printf("Files with an illegal move or bad FEN tag: %llu\n", run.illegal); }
+
+    FreeGameRecord(&run.record);
+    FreeGameRecord(&run.copy);
+    return (run.unreadable == 0 && run.illegal == 0ull && run.failed == 0ull) ? 0 : 1;
+}
@@ -0,0 +1,33 @@
+// [recordtool.h] header file
+// function declarations for "recordtool.c"
+// implemented in "main.c"
+
+#ifndef RECORDTOOL_H
+#define RECORDTOOL_H
+
+// { Phase 4 - Game Records } //
+// command line replay of PDN game files (see "gamerecord.h")
+
+/*
+    Usage:
+        ./bitboardcheckers replay [--check] <dir|files...>
+            read every PDN game (folders include their sub-folders), replay
+            each one from its start to its last move and print the games,
+            plies and positions replayed per second
+
+            --check   also verify every game: the position key and the
+                      evaluation features after each move and each undo
+                      match the ones computed from scratch, undoing
+                      every move returns to the start position, and the
+                      game written back to PDN reads in with the same moves
+
+    A game with an illegal move or a bad FEN tag is reported with its file
+    and line, the rest of that file is skipped.
+*/
+
+// run the "replay" command, "argc" / "argv" are the arguments after "replay"
+// returns 0 on success, 1 on a usage error, if a file could not be read,
+// held an illegal move, or failed a check
+int RunReplay(int argc, char* argv[]);
+
+#endif
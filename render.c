@@ -0,0 +1,238 @@
+// [render.c] file
+
+// write / fileno are POSIX, not part of plain C11
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h> // for fflush / fileno
+#include <string.h> // for memcpy / strlen
+
+#ifdef _WIN32
+#include <io.h> // for _write / _fileno
+#else
+#include <unistd.h> // for write
+#endif
+
+#include "render.h" // declare "render" methods
+
+// method to append one character, dropped (and "truncated" set) when the buffer is full
+static void RenderChar(RenderBuffer* buffer, char character)
+{
+    if (buffer->length < buffer->capacity) { buffer->data[buffer->length++] = character; }
+    else { buffer->truncated = 1; }
+}
+
+// method to append a number of 0-99, padded to "width" 2 with a space when asked
+static void RenderSmallNumber(RenderBuffer* buffer, int number, int width)
+{
+    if (number >= 10) { RenderChar(buffer, (char)('0' + number / 10)); }
+    else if (width == 2) { RenderChar(buffer, ' '); }
+    RenderChar(buffer, (char)('0' + number % 10));
+}
+
+// method to find the character shown on square "index" of "game"
+// kings, men, then "#" for an empty dark square and "_" for a light square
+static char SquareChar(const GameState* game, int index)
+{
+    unsigned long long mask = 1ull << index; // bit of the square
+
+    if ((game->player1_kings & mask) != 0ull) { return 'R'; }
+    if ((game->player1_men & mask) != 0ull) { return 'r'; }
+    if ((game->player2_kings & mask) != 0ull) { return 'B'; }
+    if ((game->player2_men & mask) != 0ull) { return 'b'; }
+    return (((index / 8) + (index % 8)) % 2 == 1) ? '#' : '_';
+}
+
+// method to append the ANSI code that moves the cursor to "line" / "column" (both from 1)
+static void RenderCursor(RenderBuffer* buffer, int line, int column)
+{
+    RenderText(buffer, "\x1b[");
+    RenderSmallNumber(buffer, line, 1);
+    RenderChar(buffer, ';');
+    RenderSmallNumber(buffer, column, 1);
+    RenderChar(buffer, 'H');
+}
+
+// Buffers //
+
+// start an empty frame in "data" ("capacity" bytes)
+void RenderInit(RenderBuffer* buffer, char* data, size_t capacity)
+{
+    buffer->data = data;
+    buffer->capacity = capacity;
+    buffer->length = 0;
+    buffer->truncated = 0;
+}
+
+// empty "buffer" again, keeping its memory
+void RenderReset(RenderBuffer* buffer)
+{
+    buffer->length = 0;
+    buffer->truncated = 0;
+}
+
+// append "text" to the frame
+void RenderText(RenderBuffer* buffer, const char* text)
+{
+    size_t length = strlen(text); // characters to append
+    size_t room = buffer->capacity - buffer->length; // characters that still fit
+
+    if (length > room)
+    {
+        length = room;
+        buffer->truncated = 1;
+    }
+    memcpy(buffer->data + buffer->length, text, length);
+    buffer->length += length;
+}
+
+// send the frame to file descriptor "descriptor" with write
+int RenderWrite(RenderBuffer* buffer, int descriptor)
+{
+    size_t total = buffer->length; // characters of the frame
+    size_t sent = 0; // characters written so far
+
+    // qualifier: the system may write less than asked (pipes, signals), the rest is sent again
+    while (sent < total)
+    {
+#ifdef _WIN32
+        int written = _write(descriptor, buffer->data + sent, (unsigned int)(total - sent)); // characters written by this call
+#else
+        long written = (long)write(descriptor, buffer->data + sent, total - sent); // characters written by this call
+#endif
+        if (written <= 0) { break; }
+        sent += (size_t)written;
+    }
+
+    RenderReset(buffer);
+    return (sent == total) ? 1 : 0;
+}
+
+// flush "file", then send the frame to its descriptor with RenderWrite
+int RenderPrint(RenderBuffer* buffer, FILE* file)
+{
+    fflush(file);
+#ifdef _WIN32
+    return RenderWrite(buffer, _fileno(file));
+#else
+    return RenderWrite(buffer, fileno(file));
+#endif
+}
+
+// Boards //
+
+// append the ASCII board of "game", the text PrintBoardPretty prints
+void RenderBoard(RenderBuffer* buffer, const GameState* game)
+{
+    int row = 0; // loop iterator for the rows, top (0) to bottom (7)
+    int col = 0; // loop iterator for the columns, left (0) to right (7)
+
+    // column header for board coordinates
+    RenderText(buffer, "\n    0 1 2 3 4 5 6 7 \n");
+
+    for (row = 0; row < 8; row++)
+    {
+        // row index at the start of each line
+        RenderChar(buffer, (char)('0' + row));
+        RenderText(buffer, " | ");
+
+        // one character and a space per square
+        for (col = 0; col < 8; col++)
+        {
+            RenderChar(buffer, SquareChar(game, row * 8 + col));
+            RenderChar(buffer, ' ');
+        }
+        RenderText(buffer, "|\n");
+    }
+
+    // blank line after the board for readability
+    RenderChar(buffer, '\n');
+}
+
+// append the numbered reference board, the text PrintReferenceBoard prints
+void RenderReferenceBoard(RenderBuffer* buffer)
+{
+    int row = 0; // loop iterator for the rows
+    int col = 0; // loop iterator for the columns
+
+    RenderText(buffer, "===============================\n");
+    RenderText(buffer, "{Bit Board Checkers Reference}\n");
+    RenderText(buffer, "Use this board to refer to your positions\n\n");
+    RenderText(buffer, "\tColumns 0 - 7 \n");
+
+    for (row = 0; row < 8; row++)
+    {
+        RenderText(buffer, "Row ");
+        RenderChar(buffer, (char)('0' + row));
+        RenderText(buffer, ": ");
+
+        // indexes formatted to width 2, separated by a space after column 0
+        for (col = 0; col < 8; col++)
+        {
+            if (col > 0) { RenderChar(buffer, ' '); }
+            RenderSmallNumber(buffer, row * 8 + col, 2);
+        }
+        RenderChar(buffer, '\n');
+    }
+    RenderText(buffer, "===============================\n\n");
+}
+
+// ANSI Mode //
+
+// start "screen" with nothing drawn
+void RenderScreenInit(RenderScreen* screen)
+{
+    memset(screen->cells, 0, sizeof(screen->cells));
+    screen->drawn = 0;
+}
+
+// append the ANSI codes that bring the terminal from the last frame of "screen" to "game"
+void RenderBoardAnsi(RenderBuffer* buffer, RenderScreen* screen, const GameState* game)
+{
+    int index = 0; // loop iterator for the squares
+    int changed = 0; // squares rewritten so far
+
+    // qualifier: the first frame clears the screen and draws everything
+    if (!screen->drawn)
+    {
+        RenderText(buffer, "\x1b[2J\x1b[H");
+        RenderBoard(buffer, game);
+
+        // scrolling is limited to the lines below the board, which moves the cursor home
+        RenderText(buffer, "\x1b[");
+        RenderSmallNumber(buffer, RENDER_ANSI_SCROLL_LINE, 1);
+        RenderChar(buffer, 'r');
+        RenderCursor(buffer, RENDER_ANSI_SCROLL_LINE, 1);
+
+        for (index = 0; index < 64; index++) { screen->cells[index] = SquareChar(game, index); }
+        screen->drawn = 1;
+        return;
+    }
+
+    for (index = 0; index < 64; index++)
+    {
+        char cell = SquareChar(game, index); // character the square should show
+
+        if (cell == screen->cells[index]) { continue; }
+
+        // qualifier: the cursor is saved before the first change and restored after the last
+        if (changed == 0) { RenderText(buffer, "\x1b" "7"); }
+
+        // board row "r" is terminal line r + 3 (blank line, header), column "c" starts at 5 + 2c
+        RenderCursor(buffer, index / 8 + 3, (index % 8) * 2 + 5);
+        RenderChar(buffer, cell);
+        screen->cells[index] = cell;
+        changed++;
+    }
+    if (changed > 0) { RenderText(buffer, "\x1b" "8"); }
+}
+
+// append the codes that give the whole terminal back to scrolling
+void RenderAnsiEnd(RenderBuffer* buffer, RenderScreen* screen)
+{
+    // qualifier: nothing to undo until the board was drawn
+    if (!screen->drawn) { return; }
+
+    // resetting the scroll region moves the cursor home, so it is saved around it
+    RenderText(buffer, "\x1b" "7" "\x1b[r" "\x1b" "8");
+    screen->drawn = 0;
+}
@@ -0,0 +1,106 @@
+// [render.h] header file
+// function declarations for "render.c"
+// implemented in "game.c" / "consoleUI.c" / "main.c"
+
+#ifndef RENDER_H
+#define RENDER_H
+
+#include <stdio.h> // for FILE (RenderPrint)
+#include <stddef.h> // for size_t (buffer sizes)
+
+#include "game.h" // implement GameState structure
+
+// { Phase 4 - Buffered Rendering } //
+// builds whole boards in memory and sends each frame with one write
+
+/*
+    The board printers used to make one putchar / printf call per square.
+    They now append their text to a RenderBuffer, a caller supplied array,
+    and the finished frame is sent with a single write:
+
+        RenderWrite   write() to a file descriptor, no stdio and no stdio
+                      locking (servers, log files, other threads)
+        RenderPrint   flushes what the FILE already holds, then RenderWrite
+                      on its descriptor, so the order with printf is kept
+
+    PrintBoardPretty and PrintReferenceBoard render into a stack buffer and
+    call RenderPrint, their text is unchanged.
+
+    ANSI mode (RenderBoardAnsi, "./bitboardcheckers --ansi") keeps the board
+    at the top of the terminal: the first frame clears the screen, draws the
+    board on lines 1-11 and limits scrolling to the lines below it, so the
+    menu and prompts scroll underneath. Later frames only move the cursor to
+    the squares that changed since the previous frame and rewrite those,
+    usually 2-4 squares a move instead of the whole board.
+
+    A buffer that is too small keeps what fits and sets "truncated".
+*/
+
+// bytes of one RenderBoard frame (11 lines, 199 characters)
+#define RENDER_BOARD_SIZE 256
+
+// bytes of one RenderReferenceBoard frame
+#define RENDER_REFERENCE_SIZE 512
+
+// bytes of one RenderBoardAnsi frame, a full first frame included
+#define RENDER_ANSI_SIZE 512
+
+// terminal line below the ANSI board, where scrolling starts
+#define RENDER_ANSI_SCROLL_LINE 12
+
+// text of one frame being built, in memory supplied by the caller
+typedef struct
+{
+    char* data; // caller's array, not NUL terminated
+    size_t capacity; // size of "data"
+    size_t length; // characters rendered so far
+    int truncated; // flagger set when text did not fit
+} RenderBuffer;
+
+// what the terminal shows in ANSI mode, to find the squares that changed
+typedef struct
+{
+    char cells[64]; // character shown on each square
+    int drawn; // flagger set once the full board is on screen
+} RenderScreen;
+
+// Buffers //
+
+// start an empty frame in "data" ("capacity" bytes)
+void RenderInit(RenderBuffer* buffer, char* data, size_t capacity);
+
+// empty "buffer" again, keeping its memory
+void RenderReset(RenderBuffer* buffer);
+
+// append "text" to the frame
+void RenderText(RenderBuffer* buffer, const char* text);
+
+// send the frame to file descriptor "descriptor" with write (repeated only if the system writes part of it)
+// the frame is emptied, returns 1 if everything was written, otherwise 0
+int RenderWrite(RenderBuffer* buffer, int descriptor);
+
+// flush "file", then send the frame to its descriptor with RenderWrite
+// returns 1 if everything was written, otherwise 0
+int RenderPrint(RenderBuffer* buffer, FILE* file);
+
+// Boards //
+
+// append the ASCII board of "game", the text PrintBoardPretty prints
+void RenderBoard(RenderBuffer* buffer, const GameState* game);
+
+// append the numbered reference board, the text PrintReferenceBoard prints
+void RenderReferenceBoard(RenderBuffer* buffer);
+
+// ANSI Mode //
+
+// start "screen" with nothing drawn, the next RenderBoardAnsi draws the full board
+void RenderScreenInit(RenderScreen* screen);
+
+// append the ANSI codes that bring the terminal from the last frame of "screen" to "game"
+// nothing is appended when no square changed
+void RenderBoardAnsi(RenderBuffer* buffer, RenderScreen* screen, const GameState* game);
+
+// append the codes that give the whole terminal back to scrolling, before the program exits
+void RenderAnsiEnd(RenderBuffer* buffer, RenderScreen* screen);
+
+#endif
@@ -3,19 +3,19 @@
 #include <stdio.h> // for printing and reading files
 
 #include "saveload.h" // declare "saveload" and "game" variables/methods
+#include "zobrist.h" // position key for the loaded game
+#include "evaluate.h" // evaluation features for the loaded game
 
-// save the current game state to a text file
-int SaveGame(const char* filename, const GameState* game) 
+// write the current game state to a text file without printing anything
+int WriteGameFile(const char* filename, const GameState* game) 
 {
+    int written = 1; // flagger cleared if any write fails
+
     // open file for writing, overwrite if exists
     FILE* file = fopen(filename, "w");
     
     // qualifier: could not open file due to file pointer/path errors or protected file 
-    if (file == NULL) 
-    {
-        printf("Could not open file for writing: %s\n", filename);
-        return 0; // unsuccessful save
-    }
+    if (file == NULL) { return 0; } // unsuccessful save
 
     // write the 5 lines in text file, depicting the game state
     // 1: player1_men       2: player1_kings        3: player2_men
@@ -24,23 +24,36 @@ int SaveGame(const char* filename, const GameState* game)
     // "game" is a pointer to GameState, so "game->" to any of the fields from GameState
     // structure is accessed. The variables are casted to (unsigned long long) to match 
     // the %llu format for the 64-bit bitboards
-    fprintf(file, "%llu\n", (unsigned long long)game->player1_men);
-    fprintf(file, "%llu\n", (unsigned long long)game->player1_kings);
-    fprintf(file, "%llu\n", (unsigned long long)game->player2_men);
-    fprintf(file, "%llu\n", (unsigned long long)game->player2_kings);
+    if (fprintf(file, "%llu\n", (unsigned long long)game->player1_men) < 0) { written = 0; }
+    if (fprintf(file, "%llu\n", (unsigned long long)game->player1_kings) < 0) { written = 0; }
+    if (fprintf(file, "%llu\n", (unsigned long long)game->player2_men) < 0) { written = 0; }
+    if (fprintf(file, "%llu\n", (unsigned long long)game->player2_kings) < 0) { written = 0; }
     
     // "current_turn" is an int, so we use %d
-    fprintf(file, "%d\n", game->current_turn);
+    if (fprintf(file, "%d\n", game->current_turn) < 0) { written = 0; }
 
-    fclose(file); // close file after writing
+    // close file after writing, buffered data is written out here
+    if (fclose(file) != 0) { written = 0; }
+    return written; // 1 for a successful save
+}
+
+// save the current game state to a text file
+int SaveGame(const char* filename, const GameState* game) 
+{
+    // qualifier: could not open or write the file due to path errors or protected file 
+    if (!WriteGameFile(filename, game)) 
+    {
+        printf("Could not open file for writing: %s\n", filename);
+        return 0; // unsuccessful save
+    }
 
     // confirma successful save to the user
     printf("Game saved to \"%s\".\n", filename);
     return 1; // successful save
 }
 
-// load a game state from a text file
-int LoadGame(const char* filename, GameState* game) 
+// read a game state from a text file without printing anything
+int ReadGameFile(const char* filename, GameState* game, int* errorLine) 
 {
     // open file for reading
     FILE* file = fopen(filename, "r");
@@ -48,7 +61,7 @@ int LoadGame(const char* filename, GameState* game)
     // qualifier: could not open file, either does not exist or mis-type
     if (file == NULL) 
     { 
-        printf("Could not open save file: %s\n", filename); 
+        *errorLine = 0; // no line read
         return 0; // unsuccessful load
     }
 
@@ -74,7 +87,7 @@ int LoadGame(const char* filename, GameState* game)
     if (itemsRead != 1) 
     { 
         fclose(file); // close file for safety
-        printf("Invalid save file (line 1).\n"); 
+        *errorLine = 1; // first invalid line
         return 0; // unsuccessful load
     }
 
@@ -84,7 +97,7 @@ int LoadGame(const char* filename, GameState* game)
     if (itemsRead != 1) 
     { 
         fclose(file); // close file for saftey
-        printf("Invalid save file (line 2).\n"); 
+        *errorLine = 2; // first invalid line
         return 0; // unsuccessful load
     }
 
@@ -94,7 +107,7 @@ int LoadGame(const char* filename, GameState* game)
     if (itemsRead != 1) 
     {
         fclose(file); // close file for safety
-        printf("Invalid save file (line 3).\n"); 
+        *errorLine = 3; // first invalid line
         return 0; // unsuccessful load
     }
 
@@ -104,7 +117,7 @@ int LoadGame(const char* filename, GameState* game)
     if (itemsRead != 1) 
     { 
         fclose(file); // close file for safety
-        printf("Invalid save file (line 4).\n"); 
+        *errorLine = 4; // first invalid line
         return 0; // unsuccessful load
     }
 
@@ -114,7 +127,7 @@ int LoadGame(const char* filename, GameState* game)
     if (itemsRead != 1) 
     { 
         fclose(file); // close file for safety
-        printf("Invalid save file (line 5).\n"); 
+        *errorLine = 5; // first invalid line
         return 0; // unsuccessful load
     }
 
@@ -139,6 +152,25 @@ int LoadGame(const char* filename, GameState* game)
         game->current_turn = 1; 
     }
 
+    // compute the position key and the evaluation features for the loaded pieces and turn
+    game->zobrist_key = ComputeZobristKey(game);
+    ComputeEvalTerms(game);
+    return 1; // successful load
+}
+
+// load a game state from a text file
+int LoadGame(const char* filename, GameState* game) 
+{
+    int errorLine = 0; // first invalid line, 0 if the file could not be opened
+
+    // qualifier: report why the file did not load, the game state stays the same
+    if (!ReadGameFile(filename, game, &errorLine)) 
+    { 
+        if (errorLine == 0) { printf("Could not open save file: %s\n", filename); }
+        else { printf("Invalid save file (line %d).\n", errorLine); }
+        return 0; // unsuccessful load
+    }
+
     // confirma successful load to the user
     printf("Game loaded from \"%s\".\n", filename);
     return 1; // successful load
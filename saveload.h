@@ -36,14 +36,28 @@
 
 #include "game.h" // for GameState (bitboard pieces and current_turn)
 
+// write the current game state to a text file named "filename", with the 5-line format, printing nothing
+// used by SaveGame and by batch tools that report errors themselves
+// returns 1 if written successfully, 0 if the file could not be opened or written
+int WriteGameFile(const char* filename, const GameState* game);
+
 // save the current game state to a text file named "filename"
 // writes 5 lines to "filename": p1_men, p1_kings, p2_men, p2_kings, current_turn
+// prints whether the game saved, or that it could not
 // returns 1 if saved successfully, 
 // return 0 if save failed (open or write error)
 int SaveGame(const char* filename, const GameState* game);
 
+// read a game state from a text file named "filename", with the same 5-line format, printing nothing
+// used by LoadGame and by batch tools that report errors themselves
+// on success sets the bitboards, "current_turn" and "zobrist_key" and returns 1
+// on failure "game" is unchanged, "errorLine" is set to the first invalid line (1-5),
+// or to 0 if the file could not be opened, and 0 is returned
+int ReadGameFile(const char* filename, GameState* game, int* errorLine);
+
 // load a game state from a text file named "filename", with the same 5-line format
-// validates each line and on success sets the bitboards and "current_turn"
+// validates each line and on success sets the bitboards, "current_turn" and "zobrist_key"
+// prints whether the game loaded, or why it did not
 // returns 1 if loaded successfully, 
 // 0 if file missing or invalid
 int LoadGame(const char* filename, GameState* game);
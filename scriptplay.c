@@ -0,0 +1,277 @@
+// [scriptplay.c] file
+
+#include <stdio.h> // for reading the scripts and printing the results
+#include <string.h> // for comparing arguments and commands
+#include <ctype.h> // for isspace (trimming lines)
+#include <time.h> // for timespec_get (moves per second)
+
+#include "scriptplay.h" // declare "scriptplay" methods
+#include "game.h" // GameState, TryMove and the win conditions
+#include "movegen.h" // MoveFromText / MoveToText / MakeMove
+#include "saveload.h" // ReadGameFile for "--start"
+
+// size of the standard output buffer, results are written in blocks of this size
+#define BATCH_OUTPUT_BUFFER 65536
+
+// longest script line read (with its line break), longer lines are reported as illegal
+#define BATCH_LINE_MAX 256
+
+// state of the "batch" command
+typedef struct
+{
+    GameState start; // position every game begins from
+    GameState game; // game being played
+    int printMoves; // flagger set by "--moves"
+    int winner; // 1 or 2 once the current game ended, otherwise 0
+    int gameMoves; // legal moves of the current game
+    int gameIllegal; // illegal moves of the current game
+    int gameLine; // line the current game began on
+    unsigned long long games; // games finished
+    unsigned long long moves; // legal moves of every game
+    unsigned long long illegal; // illegal moves of every game
+    int unreadable; // files that could not be opened
+} BatchRun;
+
+// method to read the wall clock in seconds
+static double WallSeconds(void)
+{
+    struct timespec now; // current wall clock time
+    timespec_get(&now, TIME_UTC);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+// method to name a player for the output
+static const char* PlayerName(int player)
+{
+    if (player == 1) { return "Red"; }
+    if (player == 2) { return "Black"; }
+    return "none";
+}
+
+// method to find the winner after a move, the same checks as the menu game
+// returns 1 or 2 for the winning player, 0 while the game goes on
+static int GameWinner(const GameState* game)
+{
+    int win = CheckWinner(game); // player who captured every opposing piece, if any
+
+    if (win == 1 || win == 2) { return win; }
+
+    // qualifier: the player to move loses when blocked
+    if (!CheckLegalMoves(game)) { return (game->current_turn == 1) ? 2 : 1; }
+    return 0;
+}
+
+// method to explain why TryMove rejected "FROM" to "TO"
+static const char* MoveProblem(const GameState* game, int fromPosition, int toPosition)
+{
+    MoveList legal; // legal moves of the player to move
+
+    // qualifier: two capture chains with the same FROM and TO need every landing square
+    if (FindMovesBetween(game, fromPosition, toPosition, &legal) > 1) { return "ambiguous, several captures go from FROM to TO, write the full path"; }
+    if (!PieceBelongToPlayer(game, fromPosition)) { return "no piece of the player to move on FROM"; }
+
+    // qualifier: a step is rejected while a capture exists
+    if (GenerateMoves(game, &legal) > 0 && legal.moves[0].jumps > 0) { return "a capture is available and must be taken"; }
+    return "not a legal move";
+}
+
+// method to start the next game on "line"
+static void StartGame(BatchRun* run, int line)
+{
+    run->game = run->start;
+    run->winner = GameWinner(&run->game);
+    run->gameMoves = 0;
+    run->gameIllegal = 0;
+    run->gameLine = line;
+}
+
+// method to print the result line of the current game, read from "source"
+static void EndGame(BatchRun* run, const char* source)
+{
+    run->games++;
+    printf("game %llu %s:%d moves %d illegal %d winner %s position %llu %llu %llu %llu %d\n", run->games, source, run->gameLine,
+        run->gameMoves, run->gameIllegal, PlayerName(run->winner), run->game.player1_men, run->game.player1_kings,
+        run->game.player2_men, run->game.player2_kings, run->game.current_turn);
+}
+
+// method to play one move written as "text" (already trimmed), from "line" of "source"
+static void PlayMove(BatchRun* run, const char* text, const char* source, int line)
+{
+    MoveRecord record; // captures and promotion of the move
+    Move move; // move read from the notation
+    const char* problem = NULL; // why the move is illegal, NULL when it was played
+    int fromPosition = -1; // FROM index of a "FROM TO" move
+    int toPosition = -1; // TO index of a "FROM TO" move
+    char separator = '\0'; // "-" or "x" of a move in notation
+    char extra = '\0'; // anything after "FROM TO"
+    MoveList matches; // legal moves between the squares of a "FROMxTO" shorthand
+    char buffer[64]; // move text for "--moves"
+
+    if (run->winner != 0) { problem = "the game is over"; }
+
+    // qualifier: a single word is a move in notation ("21-28", "28x42")
+    else if (strpbrk(text, " \t") == NULL)
+    {
+        if (MoveFromText(&run->game, text, &move)) { MakeMove(&run->game, &move, &record); }
+        else if (sscanf(text, "%d%c%d%c", &fromPosition, &separator, &toPosition, &extra) == 3 && (separator == '-' || separator == 'x')
+            && FindMovesBetween(&run->game, fromPosition, toPosition, &matches) > 1)
+        {
+            problem = "ambiguous, several captures go from FROM to TO, write the full path";
+        }
+        else { problem = "not a legal move"; }
+    }
+
+    // qualifier: "FROM TO" indexes go through TryMove, like the menu
+    else if (sscanf(text, "%d %d %c", &fromPosition, &toPosition, &extra) == 2)
+    {
+        if (fromPosition < 0 || fromPosition > 63 || toPosition < 0 || toPosition > 63) { problem = "square out of range (0-63)"; }
+        else if (!TryMove(&run->game, fromPosition, toPosition, &record)) { problem = MoveProblem(&run->game, fromPosition, toPosition); }
+    }
+    else { problem = "could not read the move"; }
+
+    if (problem != NULL)
+    {
+        printf("illegal %s:%d %s: %s\n", source, line, text, problem);
+        run->gameIllegal++;
+        run->illegal++;
+        return;
+    }
+
+    run->gameMoves++;
+    run->moves++;
+    run->winner = GameWinner(&run->game);
+    if (run->printMoves)
+    {
+        printf("move %s:%d %s %s\n", source, line, PlayerName(record.player), MoveToText(&record.move, buffer, (int)sizeof(buffer)));
+    }
+}
+
+// method to play every line of "file", named "source" in the output
+static void PlayFile(BatchRun* run, FILE* file, const char* source)
+{
+    char text[BATCH_LINE_MAX]; // current line
+    int line = 0; // line counter
+    int played = 0; // flagger set once the current game has a result line
+
+    StartGame(run, 1);
+    while (fgets(text, sizeof(text), file) != NULL)
+    {
+        char* start = text; // first character of the command
+        size_t length = 0; // length of the command
+        int longer = 0; // flagger set if the line did not fit in "text"
+
+        line++;
+
+        // qualifier: a line without its line break did not fit, the rest of it is skipped and the line is reported instead of played
+        if (strchr(text, '\n') == NULL)
+        {
+            int c = fgetc(file); // next character of the same line
+
+            while (c != EOF && c != '\n')
+            {
+                if (!isspace(c)) { longer = 1; }
+                c = fgetc(file);
+            }
+        }
+
+        while (isspace((unsigned char)*start)) { start++; }
+        length = strlen(start);
+        while (length > 0 && isspace((unsigned char)start[length - 1])) { start[--length] = '\0'; }
+
+        // qualifier: blank lines and "#" comments are skipped
+        if (length == 0 || start[0] == '#') { continue; }
+        if (longer)
+        {
+            printf("illegal %s:%d %.16s...: line longer than %d characters\n", source, line, start, BATCH_LINE_MAX - 2);
+            run->gameIllegal++;
+            run->illegal++;
+            played = 0;
+            continue;
+        }
+
+        if (strcmp(start, "new") == 0)
+        {
+            EndGame(run, source);
+            StartGame(run, line + 1);
+            played = 1;
+            continue;
+        }
+        PlayMove(run, start, source, line);
+        played = 0;
+    }
+
+    // qualifier: the last game is reported unless "new" just reported it
+    if (!played || line == 0) { EndGame(run, source); }
+}
+
+// run the "batch" command
+int RunBatchPlay(int argc, char* argv[])
+{
+    BatchRun run; // games and counters
+    const char* startName = NULL; // save file every game begins from, NULL for the starting position
+    double started = 0.0; // wall clock before the first move
+    double seconds = 0.0; // time spent playing
+    int argument = 0; // loop iterator for the options and files
+    int files = 0; // script files given
+
+    memset(&run, 0, sizeof(run));
+    for (argument = 0; argument < argc; argument++)
+    {
+        if (strcmp(argv[argument], "--moves") == 0) { run.printMoves = 1; }
+        else if (strcmp(argv[argument], "--start") == 0 && argument + 1 < argc) { startName = argv[++argument]; }
+        else if (argv[argument][0] == '-' && argv[argument][1] != '\0')
+        {
+            printf("Usage: bitboardcheckers batch [--moves] [--start FILE] [files... | -]\n");
+            return 1;
+        }
+        else { break; }
+    }
+
+    SetBoard(&run.start);
+    if (startName != NULL)
+    {
+        int errorLine = 0; // first invalid line of the save file
+
+        if (!ReadGameFile(startName, &run.start, &errorLine))
+        {
+            if (errorLine == 0) { printf("Could not open the save file: %s\n", startName); }
+            else { printf("Invalid save file %s (line %d)\n", startName, errorLine); }
+            return 1;
+        }
+    }
+
+    // results are only read at the end, so nothing is flushed line by line
+    setvbuf(stdout, NULL, _IOFBF, BATCH_OUTPUT_BUFFER);
+    started = WallSeconds();
+
+    // qualifier: no file, or "-", reads the script from standard input
+    for (files = 0; argument < argc || files == 0; argument++, files++)
+    {
+        const char* name = (argument < argc) ? argv[argument] : "-"; // script file
+        FILE* file = NULL; // opened script
+
+        if (strcmp(name, "-") == 0)
+        {
+            PlayFile(&run, stdin, "stdin");
+            continue;
+        }
+
+        file = fopen(name, "r");
+        if (file == NULL)
+        {
+            fflush(stdout);
+            fprintf(stderr, "Could not open script file, skipped: %s\n", name);
+            run.unreadable++;
+            continue;
+        }
+        PlayFile(&run, file, name);
+        fclose(file);
+    }
+    seconds = WallSeconds() - started;
+    fflush(stdout);
+
+    fprintf(stderr, "Batch: %llu games, %llu moves, %llu illegal", run.games, run.moves, run.illegal);
+    if (seconds > 0.0) { fprintf(stderr, ", %.3f s, %.0f moves/s", seconds, (double)(run.moves + run.illegal) / seconds); }
+    fprintf(stderr, "\n");
+    return (run.unreadable == 0 && run.illegal == 0ull) ? 0 : 1;
+}
@@ -0,0 +1,53 @@
+// [scriptplay.h] header file
+// function declarations for "scriptplay.c"
+// implemented in "main.c"
+
+#ifndef SCRIPTPLAY_H
+#define SCRIPTPLAY_H
+
+// { Phase 4 - Batch Play } //
+// plays scripted moves through the same rules as the menu, without the
+// menu, the prompts and the board printed after every move
+
+/*
+    Usage:
+        ./bitboardcheckers batch [--moves] [--start FILE] [files... | -]
+            reads moves from each file in turn (standard input when no file
+            or "-" is given); every file starts a new game
+
+            --moves       also print a line for every legal move
+            --start FILE  begin every game from a save file instead of the
+                          starting position
+
+    One command per line, blank lines and lines starting with "#" are skipped:
+
+        FROM TO     board indexes (0-63) as typed at the "Make A Move" prompts,
+                    a multi-jump capture is entered with its final landing square
+        21-28       a move in the notation the computer prints ("28x42",
+                    "10x28x46", see "movegen.h")
+        new         ends the current game and starts the next one
+
+    A capture written with its first and last square only ("3x35" or "3 35")
+    is reported as ambiguous when two chains share them, and a line longer
+    than 254 characters is reported as illegal instead of being played.
+
+    Moves are checked by TryMove / MoveFromText, the game ends the same way as
+    in the menu (CheckWinner, then CheckLegalMoves for the player to move), and
+    a move after the end of a game is illegal until "new". Standard output is
+    fully buffered and holds only results, so it can be compared between runs:
+
+        illegal <file>:<line> <text>: <reason>
+        move <file>:<line> <player> <move>                (--moves only)
+        game <n> <file>:<line> moves <m> illegal <i> winner <Red|Black|none>
+             position <red men> <red kings> <black men> <black kings> <turn>
+
+    The "game" lines are one line each, the position uses the bitboards of a
+    save file. The totals and the moves per second go to standard error.
+*/
+
+// run the "batch" command, "argc" / "argv" are the arguments after "batch"
+// returns 0 when every move was legal, 1 on a usage error,
+// if a file could not be read, or if any move was illegal
+int RunBatchPlay(int argc, char* argv[]);
+
+#endif
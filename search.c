@@ -0,0 +1,713 @@
+// [search.c] file
+
+#include <stdio.h> // for printing search progress
+#include <stdlib.h> // for malloc / free of the search data
+#include <time.h> // for timespec_get (wall clock budget)
+#include <stdatomic.h> // for the shared stop flag
+#include <pthread.h> // for the helper search threads
+
+#include "search.h" // declare "search", "movegen" and "game" variables/methods
+#include "bitoperations.h" // PopCount64 for the tablebase piece count
+#include "evaluate.h" // static evaluation of the positions at the search horizon
+
+// larger than any score the search can return
+#define SCORE_INFINITY 32000
+
+// move ordering priorities, a higher value is searched first
+#define ORDER_ROOT_BEST 1000000
+#define ORDER_TABLE_MOVE 900000
+#define ORDER_CAPTURE 100000
+#define ORDER_KILLER_1 90000
+#define ORDER_KILLER_2 80000
+#define HISTORY_LIMIT 60000
+
+// the time and node limits are checked once every this many nodes (power of 2, minus 1)
+#define CHECK_INTERVAL 1023ull
+
+// stack size for each helper thread, room for SEARCH_MAX_PLY levels of Negamax
+#define THREAD_STACK_BYTES (8u * 1024u * 1024u)
+
+// depth staggering for the helper threads (helper "n" uses pattern (n - 1) % HELPER_PATTERNS)
+// a helper skips "depth" when (depth + skipPhase) / skipSize is odd, so the helpers
+// spread over neighbouring depths instead of all searching the same one
+#define HELPER_PATTERNS 20
+static const int skipSize[HELPER_PATTERNS] = { 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4 };
+static const int skipPhase[HELPER_PATTERNS] = { 0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7 };
+
+// deterministic mode: nodes each thread searches between two merges of the round tables,
+// and the size of each thread's round table (holds every entry a round can store)
+#define ROUND_NODES 16384ull
+#define ROUND_TABLE_MB 1u
+
+struct SearchRounds;
+
+// working data for one search
+typedef struct
+{
+    GameState position; // position being searched, changed by MakeMove / UnmakeMove
+    SearchLimits limits; // time and node budget
+    const EvalWeights* weights; // evaluation weights, "limits.weights" or the defaults
+    unsigned long long nodes; // positions visited so far
+    unsigned long long tablebaseHits; // positions answered by the tablebase so far
+    double startTime; // wall clock seconds when the search started
+    int stopped; // flagger set once a limit is reached, unwinds the search
+    Move killers[SEARCH_MAX_PLY][2]; // two quiet moves per ply that caused a cut-off
+    int history[64][64]; // history heuristic score for each FROM / TO pair
+    Move pvTable[SEARCH_MAX_PLY][SEARCH_MAX_PLY]; // triangular principal variation table
+    int pvLength[SEARCH_MAX_PLY]; // end of the principal variation stored at each ply
+    Move rootBest; // best move of the previous iteration, searched first at the root
+    int hasRootBest; // flagger for "rootBest" being valid
+    int threadIndex; // 0 for the main thread, 1, 2, ... for the helper threads
+    int maxDepth; // deepest iteration to start
+    const MoveList* rootMoves; // legal moves at the root (read only, shared by every thread)
+    _Atomic int* sharedStop; // set when the main thread is done, stops every thread (NULL if unused)
+    struct SearchRounds* rounds; // round state shared by every thread in deterministic mode, NULL otherwise
+    TranspositionTable roundTable; // entries this thread stored during the current round (deterministic mode)
+    int hasRoundTable; // flagger for "roundTable" being allocated
+    unsigned long long roundEnd; // node count at which this thread's current round ends
+    int leftRounds; // flagger set once this thread has finished searching and only helps merging
+    SearchResult result; // this thread's answer, from its last finished depth
+} Searcher;
+
+// state shared by the threads of a deterministic search
+// every thread searches ROUND_NODES nodes against the shared table, which nobody writes during
+// a round, and stores into its own round table; then all threads wait for each other and merge
+// the round tables into the shared table in thread order, so every run sees the same table
+typedef struct SearchRounds
+{
+    pthread_mutex_t lock; // protects every field below
+    pthread_cond_t wake; // signalled when the last thread reaches the barrier
+    int threads; // threads taking part in every round
+    int arrived; // threads waiting at the barrier
+    unsigned long long passes; // barriers passed so far
+    int finished; // threads done searching
+    int mainDone; // flagger set once the main thread is done, the helpers stop at the next round
+    TranspositionTable* table; // shared table the round tables are merged into
+    Searcher** searchers; // every thread's working data, for their round tables
+} SearchRounds;
+
+// method to read the wall clock in seconds
+static double WallSeconds(void)
+{
+    struct timespec now; // current wall clock time
+    timespec_get(&now, TIME_UTC);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+// method to score the searched position from the point of view of the player to move
+// the features kept up to date by MakeMove / UnmakeMove, weighted by this search's weights
+static int Evaluate(const Searcher* searcher)
+{
+    return EvaluatePosition(&searcher->position, searcher->weights);
+}
+
+// method to compare two moves, returns 1 when they are the same move
+static int SameMove(const Move* a, const Move* b)
+{
+    return a->from == b->from && a->to == b->to && a->captured == b->captured;
+}
+
+// method to convert a win / loss score to "distance from this position" before storing it in the table
+// scores from the root count plies from the root, a table entry must not depend on where it was found
+static int ScoreToTable(int score, int ply)
+{
+    if (score > SEARCH_WIN_SCORE - SEARCH_MAX_PLY) { return score + ply; }
+    if (score < -SEARCH_WIN_SCORE + SEARCH_MAX_PLY) { return score - ply; }
+    return score;
+}
+
+// method to convert a stored win / loss score back to "distance from the root" at "ply"
+static int ScoreFromTable(int score, int ply)
+{
+    if (score > SEARCH_WIN_SCORE - SEARCH_MAX_PLY) { return score - ply; }
+    if (score < -SEARCH_WIN_SCORE + SEARCH_MAX_PLY) { return score + ply; }
+    return score;
+}
+
+// method to wait until every thread of the deterministic search has reached this barrier
+static void RoundBarrier(SearchRounds* rounds)
+{
+    unsigned long long pass = 0ull; // barrier this thread is waiting at
+
+    pthread_mutex_lock(&rounds->lock);
+    pass = rounds->passes;
+    rounds->arrived++;
+
+    // qualifier: the last thread to arrive releases the others
+    if (rounds->arrived == rounds->threads)
+    {
+        rounds->arrived = 0;
+        rounds->passes++;
+        pthread_cond_broadcast(&rounds->wake);
+    }
+    else
+    {
+        while (rounds->passes == pass) { pthread_cond_wait(&rounds->wake, &rounds->lock); }
+    }
+    pthread_mutex_unlock(&rounds->lock);
+}
+
+// method to end a round of the deterministic search ("done" once this thread stopped searching)
+// waits for every thread, merges this thread's share of every round table into the shared table,
+// and waits again, so no thread searches while the shared table changes
+// returns 1 once every thread is done searching
+static int EndRound(Searcher* searcher, int done)
+{
+    SearchRounds* rounds = searcher->rounds; // shared round state
+    unsigned long long bucketCount = searcher->roundTable.bucketCount; // buckets of every round table
+    unsigned long long first = 0ull; // first round table bucket merged by this thread
+    unsigned long long last = 0ull; // end of the buckets merged by this thread
+    int allDone = 0; // flagger for every thread being done
+    int mainDone = 0; // flagger for the main thread being done
+    int i = 0; // loop iterator for the round tables
+
+    pthread_mutex_lock(&rounds->lock);
+    if (done && !searcher->leftRounds)
+    {
+        searcher->leftRounds = 1;
+        rounds->finished++;
+        if (searcher->threadIndex == 0) { rounds->mainDone = 1; }
+    }
+    pthread_mutex_unlock(&rounds->lock);
+
+    RoundBarrier(rounds);
+
+    // nobody changes "finished" between the two barriers, every thread reads the same values
+    pthread_mutex_lock(&rounds->lock);
+    allDone = (rounds->finished == rounds->threads);
+    mainDone = rounds->mainDone;
+    pthread_mutex_unlock(&rounds->lock);
+
+    // qualifier: each thread merges its own range of buckets, taking the round tables in thread order
+    // a shared table smaller than the round tables is merged by the main thread alone
+    if (rounds->table->bucketCount >= bucketCount)
+    {
+        first = bucketCount * (unsigned long long)searcher->threadIndex / (unsigned long long)rounds->threads;
+        last = bucketCount * (unsigned long long)(searcher->threadIndex + 1) / (unsigned long long)rounds->threads;
+    }
+    else if (searcher->threadIndex == 0) { last = bucketCount; }
+    for (i = 0; i < rounds->threads; i++) { TTMergeBuckets(rounds->table, &rounds->searchers[i]->roundTable, first, last); }
+
+    RoundBarrier(rounds);
+
+    // qualifier: the main thread is done, a helper's unfinished depth is thrown away
+    if (mainDone && !done) { searcher->stopped = 1; }
+    searcher->roundEnd = searcher->roundEnd + ROUND_NODES;
+    return allDone;
+}
+
+// method to look "key" up, in deterministic mode this thread's round table comes first
+static int ProbeTable(Searcher* searcher, unsigned long long key, TTData* out)
+{
+    if (searcher->rounds != NULL && TTProbe(&searcher->roundTable, key, out)) { return 1; }
+    return TTProbe(searcher->limits.table, key, out);
+}
+
+// method to check the time and node budget, returns 1 once a limit is reached
+static int LimitReached(const Searcher* searcher)
+{
+    // qualifier: another thread ended the search
+    if (searcher->sharedStop != NULL && atomic_load_explicit(searcher->sharedStop, memory_order_relaxed)) { return 1; }
+
+    // qualifier: the caller ended the search
+    if (searcher->limits.stop != NULL && atomic_load_explicit(searcher->limits.stop, memory_order_relaxed)) { return 1; }
+
+    // qualifier: node budget
+    if (searcher->limits.nodeLimit > 0ull && searcher->nodes >= searcher->limits.nodeLimit) { return 1; }
+
+    // qualifier: time budget
+    if (searcher->limits.timeLimitMs > 0)
+    {
+        double elapsedMs = (WallSeconds() - searcher->startTime) * 1000.0; // time used so far
+        if (elapsedMs >= (double)searcher->limits.timeLimitMs) { return 1; }
+    }
+    return 0;
+}
+
+// method to give every move in "list" an ordering score, a higher score is searched first
+// "tableMove" is the best move stored in the transposition table (NULL if none)
+static void ScoreMoves(const Searcher* searcher, const MoveList* list, int ply, const TTData* tableMove, int* scores)
+{
+    int i = 0; // loop iterator for the moves
+
+    for (i = 0; i < list->count; i++)
+    {
+        const Move* move = &list->moves[i]; // move being scored
+
+        // qualifier: the previous iteration's best move is searched first at the root
+        if (ply == 0 && searcher->hasRootBest && SameMove(move, &searcher->rootBest))
+        {
+            scores[i] = ORDER_ROOT_BEST;
+        }
+        // the transposition table's best move for this position
+        else if (tableMove != NULL && move->from == tableMove->from && move->to == tableMove->to)
+        {
+            scores[i] = ORDER_TABLE_MOVE;
+        }
+        // captures: longer chains first
+        else if (move->jumps > 0) { scores[i] = ORDER_CAPTURE + move->jumps * 1000; }
+        // quiet moves: killers, then history
+        else if (SameMove(move, &searcher->killers[ply][0])) { scores[i] = ORDER_KILLER_1; }
+        else if (SameMove(move, &searcher->killers[ply][1])) { scores[i] = ORDER_KILLER_2; }
+        else { scores[i] = searcher->history[move->from][move->to]; }
+    }
+}
+
+// method to move the highest scored move among "start" .. end of "list" to index "start"
+static void PickNextMove(MoveList* list, int* scores, int start)
+{
+    int best = start; // index of the highest score found
+    int i = 0; // loop iterator for the remaining moves
+
+    for (i = start + 1; i < list->count; i++)
+    {
+        if (scores[i] > scores[best]) { best = i; }
+    }
+
+    // qualifier: swap the best move (and its score) into place
+    if (best != start)
+    {
+        Move move = list->moves[start];
+        int score = scores[start];
+        list->moves[start] = list->moves[best];
+        scores[start] = scores[best];
+        list->moves[best] = move;
+        scores[best] = score;
+    }
+}
+
+// method to remember a quiet move that caused a beta cut-off at "ply"
+static void StoreCutoff(Searcher* searcher, const Move* move, int ply, int depth)
+{
+    int from = 0; // loop iterator for halving the history table
+    int to = 0;
+
+    // killer moves: keep the two most recent, without duplicates
+    if (!SameMove(move, &searcher->killers[ply][0]))
+    {
+        searcher->killers[ply][1] = searcher->killers[ply][0];
+        searcher->killers[ply][0] = *move;
+    }
+
+    // history heuristic: deeper cut-offs count more
+    searcher->history[move->from][move->to] += depth * depth;
+
+    // qualifier: keep history below the killer priorities by halving every entry
+    if (searcher->history[move->from][move->to] > HISTORY_LIMIT)
+    {
+        for (from = 0; from < 64; from++)
+        {
+            for (to = 0; to < 64; to++) { searcher->history[from][to] /= 2; }
+        }
+    }
+}
+
+// method for the negamax alpha-beta search
+// returns the score of the current position from the point of view of the player to move
+static int Negamax(Searcher* searcher, int depth, int ply, int alpha, int beta)
+{
+    MoveList list; // legal moves in this position
+    int scores[MAX_MOVES]; // ordering score of each move
+    int best = -SCORE_INFINITY; // best score found so far
+    int bestIndex = -1; // index of the move that raised alpha, -1 if none did
+    int alphaStart = alpha; // alpha on entry, decides the bound type stored in the table
+    TTData entry; // transposition table entry for this position
+    int hasEntry = 0; // flagger for a table hit
+    int i = 0; // loop iterator for the moves
+
+    searcher->pvLength[ply] = ply; // no principal variation below this ply yet
+
+    // qualifier: check the budget every few nodes, then unwind once it is used up
+    if ((searcher->nodes & CHECK_INTERVAL) == 0ull && LimitReached(searcher)) { searcher->stopped = 1; }
+    if (searcher->stopped) { return 0; }
+
+    // qualifier: deterministic mode, every thread merges its stored entries after the same number of nodes
+    if (searcher->rounds != NULL && searcher->nodes == searcher->roundEnd)
+    {
+        EndRound(searcher, 0);
+        if (searcher->stopped) { return 0; }
+    }
+    searcher->nodes = searcher->nodes + 1ull;
+
+    // qualifier: a deep enough table entry can answer this position without searching it
+    if (searcher->limits.table != NULL)
+    {
+        hasEntry = ProbeTable(searcher, searcher->position.zobrist_key, &entry);
+        if (hasEntry && ply > 0 && entry.depth >= depth)
+        {
+            int stored = ScoreFromTable(entry.score, ply); // table score as seen from the root
+
+            if (entry.bound == TT_EXACT) { return stored; }
+            if (entry.bound == TT_LOWER && stored >= beta) { return stored; }
+            if (entry.bound == TT_UPPER && stored <= alpha) { return stored; }
+        }
+    }
+
+    // qualifier: with few pieces left the tablebase knows the result (the root still needs a move)
+    if (ply > 0 && searcher->limits.tablebase != NULL
+        && PopCount64(searcher->position.player1_men | searcher->position.player1_kings | searcher->position.player2_men
+            | searcher->position.player2_kings) <= searcher->limits.tablebase->maxPieces)
+    {
+        int outcome = TB_DRAW; // result for the player to move
+
+        if (ProbeTablebaseWdl(searcher->limits.tablebase, &searcher->position, &outcome))
+        {
+            searcher->tablebaseHits = searcher->tablebaseHits + 1ull;
+            if (outcome == TB_DRAW) { return 0; }
+            return outcome * SEARCH_TB_WIN_SCORE + Evaluate(searcher);
+        }
+    }
+
+    GenerateMoves(&searcher->position, &list);
+
+    // qualifier: no legal move loses, a sooner loss scores lower
+    if (list.count == 0) { return -SEARCH_WIN_SCORE + ply; }
+
+    // qualifier: score the position at the horizon, unless a capture still has to be played
+    if ((depth <= 0 && list.moves[0].jumps == 0) || ply >= SEARCH_MAX_PLY - 1)
+    {
+        return Evaluate(searcher);
+    }
+
+    ScoreMoves(searcher, &list, ply, (hasEntry && entry.hasMove) ? &entry : NULL, scores);
+
+    for (i = 0; i < list.count; i++)
+    {
+        MoveRecord record; // undo information for this move
+        int score = 0; // score of this move for the player to move
+
+        PickNextMove(&list, scores, i);
+
+        MakeMove(&searcher->position, &list.moves[i], &record);
+        score = -Negamax(searcher, depth - 1, ply + 1, -beta, -alpha);
+        UnmakeMove(&searcher->position, &record);
+
+        // qualifier: the budget ran out below this move, the score is not valid
+        if (searcher->stopped) { return 0; }
+
+        if (score > best) { best = score; }
+
+        // qualifier: a new best move, store it with the variation below it
+        if (score > alpha)
+        {
+            int next = 0; // loop iterator for copying the variation
+
+            alpha = score;
+            bestIndex = i;
+            searcher->pvTable[ply][ply] = list.moves[i];
+            for (next = ply + 1; next < searcher->pvLength[ply + 1]; next++)
+            {
+                searcher->pvTable[ply][next] = searcher->pvTable[ply + 1][next];
+            }
+            searcher->pvLength[ply] = searcher->pvLength[ply + 1];
+
+            // qualifier: beta cut-off, the opponent will avoid this position
+            if (alpha >= beta)
+            {
+                if (list.moves[i].jumps == 0) { StoreCutoff(searcher, &list.moves[i], ply, depth); }
+                break;
+            }
+        }
+    }
+
+    // store the result: a fail-low only gives an upper bound (and no trusted move),
+    // a cut-off only gives a lower bound, anything in between is exact
+    if (searcher->limits.table != NULL)
+    {
+        int bound = TT_EXACT; // how "best" relates to the true score
+
+        if (best <= alphaStart) { bound = TT_UPPER; }
+        else if (best >= beta) { bound = TT_LOWER; }
+
+        // qualifier: deterministic mode stores into the round table, the shared table is read only until the merge
+        TTStore((searcher->rounds != NULL) ? &searcher->roundTable : searcher->limits.table, searcher->position.zobrist_key, depth, bound,
+            ScoreToTable(best, ply), (bestIndex >= 0) ? &list.moves[bestIndex] : NULL);
+    }
+    return best;
+}
+
+// method to start "result" with the first legal move, in case not even depth 1 finishes
+static void StartResult(SearchResult* result, const MoveList* rootMoves)
+{
+    result->hasMove = 1;
+    result->bestMove = rootMoves->moves[0];
+    result->score = 0;
+    result->depth = 0;
+    result->nodes = 0ull;
+    result->tablebaseHits = 0ull;
+    result->seconds = 0.0;
+    result->pv[0] = rootMoves->moves[0];
+    result->pvLength = 1;
+}
+
+// method for iterative deepening on one thread
+// each finished depth replaces the answer of the previous one in "searcher->result"
+static void IterativeDeepening(Searcher* searcher)
+{
+    SearchResult* result = &searcher->result; // this thread's answer
+    int depth = 0; // current iteration depth
+
+    for (depth = 1; depth <= searcher->maxDepth; depth++)
+    {
+        int score = 0; // score of this depth
+        int i = 0; // loop iterator for copying the variation
+
+        // qualifier: helper threads skip some depths, so the threads spread over several depths
+        if (searcher->threadIndex > 0)
+        {
+            int pattern = (searcher->threadIndex - 1) % HELPER_PATTERNS; // staggering pattern of this helper
+            if (((depth + skipPhase[pattern]) / skipSize[pattern]) % 2 == 1) { continue; }
+        }
+
+        score = Negamax(searcher, depth, 0, -SCORE_INFINITY, SCORE_INFINITY);
+
+        // qualifier: an unfinished depth is thrown away
+        if (searcher->stopped) { break; }
+
+        result->score = score;
+        result->depth = depth;
+        result->bestMove = searcher->pvTable[0][0];
+        result->pvLength = searcher->pvLength[0];
+        for (i = 0; i < result->pvLength; i++) { result->pv[i] = searcher->pvTable[0][i]; }
+
+        searcher->rootBest = result->bestMove;
+        searcher->hasRootBest = 1;
+
+        // qualifier: print the progress of each finished depth (main thread only)
+        if (searcher->limits.verbose && searcher->threadIndex == 0)
+        {
+            char text[512]; // principal variation as text
+            int hashfull = 0; // table usage in permille
+
+            if (searcher->limits.table != NULL) { hashfull = TTHashfull(searcher->limits.table); }
+            printf("depth %2d  score %6d  nodes %10llu  time %6.3f s  hashfull %4d  pv %s\n", depth, score,
+                searcher->nodes, WallSeconds() - searcher->startTime, hashfull,
+                PrincipalVariationText(result, text, (int)sizeof(text)));
+        }
+
+        // qualifier: report the finished depth to the caller (main thread only)
+        if (searcher->limits.progress != NULL && searcher->threadIndex == 0)
+        {
+            result->nodes = searcher->nodes;
+            result->seconds = WallSeconds() - searcher->startTime;
+            searcher->limits.progress(result, searcher->limits.progressContext);
+        }
+
+        // qualifier: only one legal move, or a forced win / loss already found, deeper search cannot help
+        if (searcher->rootMoves->count == 1) { break; }
+        if (score >= SEARCH_WIN_SCORE - depth || score <= -SEARCH_WIN_SCORE + depth) { break; }
+    }
+
+    // qualifier: the main thread finishing ends the search for every helper
+    if (searcher->threadIndex == 0 && searcher->sharedStop != NULL)
+    {
+        atomic_store_explicit(searcher->sharedStop, 1, memory_order_relaxed);
+    }
+
+    // qualifier: deterministic mode, keep taking part in the merges until every thread is done
+    if (searcher->rounds != NULL)
+    {
+        while (!EndRound(searcher, 1)) { }
+    }
+}
+
+// method run by each helper thread
+static void* HelperThread(void* argument)
+{
+    IterativeDeepening((Searcher*)argument);
+    return NULL;
+}
+
+// search "game" for the best move of the player to move within "limits"
+// "game" is not changed, the answer and its principal variation are stored in "result"
+// returns 1 if a move was found, 0 if the player to move has no legal move
+int SearchBestMove(const GameState* game, const SearchLimits* limits, SearchResult* result)
+{
+    Searcher* searchers[SEARCH_MAX_THREADS]; // working data of each thread, too large for the stack
+    pthread_t handles[SEARCH_MAX_THREADS]; // helper thread handles
+    int started[SEARCH_MAX_THREADS]; // flagger for each helper thread having started
+    pthread_attr_t attributes; // helper thread stack size
+    _Atomic int stop; // shared stop flag, set when the main thread is done
+    SearchRounds rounds; // round state of a deterministic search with a table
+    MoveList rootMoves; // legal moves at the root
+    int maxDepth = limits->maxDepth; // deepest iteration to start
+    int threads = limits->threads; // number of search threads
+    int deterministic = 0; // flagger for a reproducible multi-threaded search (node limit only)
+    int best = 0; // thread whose answer is used
+    int allocated = 0; // threads whose working data was allocated
+    double startTime = 0.0; // wall clock seconds when the search started
+    unsigned long long nodes = 0ull; // positions visited by every thread
+    unsigned long long tablebaseHits = 0ull; // positions every thread answered from the tablebase
+    int i = 0; // loop iterator for the threads
+
+    result->hasMove = 0;
+    result->score = 0;
+    result->depth = 0;
+    result->nodes = 0ull;
+    result->tablebaseHits = 0ull;
+    result->seconds = 0.0;
+    result->pvLength = 0;
+
+    // qualifier: nothing to search when the player to move is blocked
+    if (GenerateMoves(game, &rootMoves) == 0) { return 0; }
+
+    // qualifier: clamp the requested depth and thread count into the supported range
+    if (maxDepth <= 0 || maxDepth > SEARCH_MAX_DEPTH) { maxDepth = SEARCH_MAX_DEPTH; }
+    if (threads < 1) { threads = 1; }
+    if (threads > SEARCH_MAX_THREADS) { threads = SEARCH_MAX_THREADS; }
+
+    // qualifier: a forced move is answered after depth 1, helpers would only add overhead
+    if (rootMoves.count == 1) { threads = 1; }
+
+    deterministic = (threads > 1 && limits->nodeLimit > 0ull && limits->timeLimitMs == 0);
+    atomic_init(&stop, 0);
+    startTime = WallSeconds();
+
+    // qualifier: a new search generation makes older table entries the first to be replaced
+    if (limits->table != NULL) { TTNewSearch(limits->table); }
+
+    // allocate the working data of each thread, fewer threads search if memory runs short
+    for (i = 0; i < threads; i++)
+    {
+        Searcher* searcher = (Searcher*)calloc(1, sizeof(Searcher)); // this thread's working data
+        if (searcher == NULL) { break; }
+
+        searcher->position = *game;
+        searcher->limits = *limits;
+        searcher->weights = (limits->weights != NULL) ? limits->weights : &defaultEvalWeights;
+
+        // the evaluation features are worked out once here, "game" may have been built without them
+        ComputeEvalTerms(&searcher->position);
+        searcher->startTime = startTime;
+        searcher->threadIndex = i;
+        searcher->maxDepth = maxDepth;
+        searcher->rootMoves = &rootMoves;
+        StartResult(&searcher->result, &rootMoves);
+
+        // qualifier: deterministic mode, an equal share of the nodes and a small round table for each thread
+        if (deterministic)
+        {
+            searcher->limits.nodeLimit = limits->nodeLimit / (unsigned long long)threads;
+            if (searcher->limits.nodeLimit == 0ull) { searcher->limits.nodeLimit = 1ull; }
+
+            if (limits->table != NULL)
+            {
+                searcher->hasRoundTable = TTInit(&searcher->roundTable, ROUND_TABLE_MB);
+                if (!searcher->hasRoundTable)
+                {
+                    free(searcher);
+                    break;
+                }
+
+                // the round entries carry the shared table's generation into it
+                atomic_store(&searcher->roundTable.generation, atomic_load(&limits->table->generation));
+                searcher->rounds = &rounds;
+                searcher->roundEnd = ROUND_NODES;
+            }
+        }
+        searchers[i] = searcher;
+    }
+    threads = i;
+    allocated = i;
+
+    // qualifier: fall back to the first legal move if no working data could be allocated
+    if (threads == 0)
+    {
+        StartResult(result, &rootMoves);
+        return 1;
+    }
+
+    // qualifier: threads sharing a table stop together once the main thread is done
+    if (!deterministic && threads > 1)
+    {
+        for (i = 0; i < threads; i++) { searchers[i]->sharedStop = &stop; }
+    }
+
+    // qualifier: deterministic threads with a table merge it in rounds, one thread needs no rounds
+    if (deterministic && limits->table != NULL)
+    {
+        pthread_mutex_init(&rounds.lock, NULL);
+        pthread_cond_init(&rounds.wake, NULL);
+        rounds.threads = threads;
+        rounds.arrived = 0;
+        rounds.passes = 0ull;
+        rounds.finished = 0;
+        rounds.mainDone = 0;
+        rounds.table = limits->table;
+        rounds.searchers = searchers;
+        if (threads == 1) { searchers[0]->rounds = NULL; }
+    }
+
+    // start the helpers, then search on this thread as the main thread
+    pthread_attr_init(&attributes);
+    pthread_attr_setstacksize(&attributes, THREAD_STACK_BYTES);
+    for (i = 1; i < threads; i++)
+    {
+        started[i] = (pthread_create(&handles[i], &attributes, HelperThread, searchers[i]) == 0);
+
+        // qualifier: a deterministic search needs every thread at every merge, the others search without rounds
+        if (!started[i] && searchers[0]->rounds != NULL)
+        {
+            pthread_mutex_lock(&rounds.lock);
+            rounds.threads = i;
+            pthread_mutex_unlock(&rounds.lock);
+            threads = i;
+            if (threads == 1) { searchers[0]->rounds = NULL; }
+            break;
+        }
+    }
+    pthread_attr_destroy(&attributes);
+
+    IterativeDeepening(searchers[0]);
+
+    // wait for every helper
+    for (i = 1; i < threads; i++)
+    {
+        if (started[i]) { pthread_join(handles[i], NULL); }
+    }
+
+    // the deepest finished thread gives the answer, the lowest thread number wins a tie
+    for (i = 0; i < threads; i++)
+    {
+        if (searchers[i]->result.depth > searchers[best]->result.depth) { best = i; }
+        nodes = nodes + searchers[i]->nodes;
+        tablebaseHits = tablebaseHits + searchers[i]->tablebaseHits;
+    }
+    *result = searchers[best]->result;
+    result->nodes = nodes;
+    result->tablebaseHits = tablebaseHits;
+    result->seconds = WallSeconds() - startTime;
+
+    for (i = 0; i < allocated; i++)
+    {
+        if (searchers[i]->hasRoundTable) { TTFree(&searchers[i]->roundTable); }
+        free(searchers[i]);
+    }
+    if (deterministic && limits->table != NULL)
+    {
+        pthread_cond_destroy(&rounds.wake);
+        pthread_mutex_destroy(&rounds.lock);
+    }
+    return 1;
+}
+
+// write the principal variation of "result" as text into "buffer" (holds at least "size" characters)
+// moves are separated by spaces (Example: "21-28 42-35 28x42")
+// returns "buffer" so it can be passed straight to printf
+char* PrincipalVariationText(const SearchResult* result, char* buffer, int size)
+{
+    int length = 0; // characters written so far
+    int i = 0; // loop iterator for the variation
+
+    buffer[0] = '\0';
+    for (i = 0; i < result->pvLength; i++)
+    {
+        char move[64]; // one move as text
+        int needed = snprintf(NULL, 0, "%s%s", (i > 0) ? " " : "", MoveToText(&result->pv[i], move, (int)sizeof(move)));
+
+        // qualifier: stop before the buffer overflows
+        if (length + needed >= size) { break; }
+        length = length + snprintf(buffer + length, (size_t)(size - length), "%s%s", (i > 0) ? " " : "", move);
+    }
+    return buffer;
+}
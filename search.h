@@ -0,0 +1,125 @@
+// [search.h] header file
+// function declarations for "search.c"
+// implemented in "main.c"
+
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <stdatomic.h> // for the caller's stop flag
+
+#include "game.h" // implement GameState structure
+#include "movegen.h" // implement Move / MoveList structures
+#include "tt.h" // implement TranspositionTable structure
+#include "tablebase.h" // implement Tablebase structure
+#include "evaluate.h" // implement EvalWeights structure
+
+// { Phase 4 - Computer Opponent Search } //
+// finds the best move for the player to move, used by "Play vs Computer"
+
+/*
+    The search looks ahead through the game tree built from GenerateMoves and
+    MakeMove / UnmakeMove and picks the move with the best guaranteed score.
+
+        - negamax alpha-beta: every score is from the point of view of the
+          player to move, branches that cannot change the result are skipped
+        - iterative deepening: searches depth 1, 2, 3, ... until the time or
+          node budget runs out, the last finished depth gives the answer
+        - capture extension: positions with a capture still to play are
+          searched further instead of being scored in the middle of an exchange
+        - transposition table: results are stored by "zobrist_key", a position
+          reached again is answered (or at least ordered) from the table
+        - move ordering: previous best / table move first, then longer captures,
+          then killer moves (quiet moves that caused a cut at the same ply),
+          then the history heuristic (quiet moves that caused cuts anywhere)
+        - endgame tablebase: once few enough pieces are left, every position
+          below the root is answered win / draw / loss from the tablebase
+          (WDL stream, see "tablebase.h") instead of being searched
+        - Lazy SMP: with "threads" > 1, helper threads search the same root at
+          staggered depths and share the transposition table, every thread's
+          results speed up the others through the table
+
+    With several threads and only a node limit (no time limit), the search is
+    deterministic: every thread gets an equal share of the nodes and the search
+    runs in rounds of a fixed number of nodes per thread. During a round the
+    caller's table is only read, each thread stores into a small round table of
+    its own; at the end of the round the threads wait for each other and merge
+    the round tables into the caller's table in thread order. The result comes
+    from the deepest finished thread (the lowest thread number on a tie), and
+    the helpers stop at the round after the main thread is done. Otherwise the
+    threads share the caller's table directly, stop together when the main
+    thread (thread 0) is done, and the result depends on thread timing.
+
+    A caller running the search on its own thread can end it at any time by
+    setting "stop" (checked every 1024 nodes), the answer then comes from the
+    last finished depth as with any other limit. "progress" reports every
+    finished depth while the search is still running.
+
+    Scores are in "points", a man is worth 100.
+    A won position scores close to SEARCH_WIN_SCORE (sooner wins score higher).
+    A tablebase win scores SEARCH_TB_WIN_SCORE plus the normal evaluation, so
+    the winning side still prefers to capture and promote on its way.
+*/
+
+// deepest iteration the search will start
+#define SEARCH_MAX_DEPTH 64
+
+// deepest ply reachable, including capture extensions
+#define SEARCH_MAX_PLY 128
+
+// score of a position where the player to move has already won
+#define SEARCH_WIN_SCORE 30000
+
+// score of a position the tablebase reports as won (below every SEARCH_WIN_SCORE distance)
+#define SEARCH_TB_WIN_SCORE 20000
+
+// most search threads accepted in "threads"
+#define SEARCH_MAX_THREADS 256
+
+struct SearchResult;
+
+// called by the main search thread after every finished depth, "result" holds that depth's answer
+// (nodes and seconds so far, from the main thread), "context" is "SearchLimits.progressContext"
+typedef void (*SearchProgress)(const struct SearchResult* result, void* context);
+
+// limits for one search, a value of 0 means "no limit" for that field
+typedef struct
+{
+    int maxDepth; // deepest iteration to search (1 - SEARCH_MAX_DEPTH), 0 for SEARCH_MAX_DEPTH
+    int timeLimitMs; // wall clock budget in milliseconds
+    unsigned long long nodeLimit; // maximum number of positions to visit (shared out between the threads)
+    int verbose; // 1 to print a line (depth, score, nodes, time, pv) after every finished depth
+    TranspositionTable* table; // transposition table to use (may be shared between searches), NULL for none
+    int threads; // search threads (1 - SEARCH_MAX_THREADS), 0 for 1
+    const Tablebase* tablebase; // endgame tablebase to probe (may be shared between threads), NULL for none
+    _Atomic int* stop; // set to 1 by another thread to end the search early, NULL for none
+    SearchProgress progress; // called after every finished depth, NULL for none
+    void* progressContext; // passed to "progress"
+    const EvalWeights* weights; // evaluation weights (may be shared between threads), NULL for the defaults
+} SearchLimits;
+
+// result of a search, from the last fully searched depth
+typedef struct SearchResult
+{
+    int hasMove; // 1 if "bestMove" is valid, 0 if the player to move has no legal move
+    Move bestMove; // best move found for the player to move
+    int score; // score of "bestMove" from the point of view of the player to move
+    int depth; // deepest fully searched depth
+    unsigned long long nodes; // positions visited by the whole search (all threads)
+    unsigned long long tablebaseHits; // positions answered by the tablebase (all threads)
+    double seconds; // wall clock time used
+    int pvLength; // number of moves in "pv"
+    Move pv[SEARCH_MAX_PLY]; // principal variation, the expected line of play starting with "bestMove"
+} SearchResult;
+
+// search "game" for the best move of the player to move within "limits"
+// "game" must have a valid "zobrist_key" (SetBoard / LoadGame / MakeMove keep it valid)
+// "game" is not changed, the answer and its principal variation are stored in "result"
+// returns 1 if a move was found, 0 if the player to move has no legal move
+int SearchBestMove(const GameState* game, const SearchLimits* limits, SearchResult* result);
+
+// write the principal variation of "result" as text into "buffer" (holds at least "size" characters)
+// moves are separated by spaces (Example: "21-28 42-35 28x42")
+// returns "buffer" so it can be passed straight to printf
+char* PrincipalVariationText(const SearchResult* result, char* buffer, int size);
+
+#endif
@@ -0,0 +1,231 @@
+// [searchbench.c] file
+// run the search scaling benchmark here!
+
+/*
+    Measures how the Lazy SMP search scales with the number of threads.
+    Every saved position is searched to a fixed depth (time to depth), first
+    on 1 thread and then on each larger thread count. The table is cleared
+    before every search, so each measurement starts from the same state.
+
+    Usage:
+        ./searchbench [--depth D] [--threads N,N,...] [--hash MB] [--tablebase DIR] [--tbcache MB] [savefiles...]
+
+        --depth D       depth searched in every position (default 16)
+        --threads N,... thread counts to measure (default 1,2,4,8,16,32)
+        --hash MB       shared transposition table size (default 64)
+        --tablebase DIR probe the endgame tablebase in DIR (made by "tbgen")
+        --tbcache MB    tablebase block cache size (default 32)
+        [savefiles]     5-line save files (same format as LoadGame),
+                        otherwise the positions in "positions/" are used
+
+    For each thread count the total time over all positions is reported,
+    with the speedup against the first thread count in the list.
+    Speedups above 1 are only possible with that many free CPU cores.
+    With a tablebase, each row is followed by the positions it answered and
+    the block cache hits and misses of that row (the cache stays warm).
+*/
+
+#include <stdio.h> // for printing
+#include <stdlib.h> // for parsing numbers (atoi / strtol)
+#include <string.h> // for comparing arguments
+
+#include "game.h" // GameState structure and game functions
+#include "saveload.h" // LoadGame for reading the positions
+#include "search.h" // SearchBestMove
+#include "tt.h" // TranspositionTable
+#include "tablebase.h" // Tablebase and its cache counters
+#include "stats.h" // game core counters of instrumented builds
+
+// most positions and thread counts accepted
+#define BENCH_MAX_POSITIONS 64
+#define BENCH_MAX_COUNTS 16
+
+// default settings
+#define BENCH_DEFAULT_DEPTH 16
+#define BENCH_DEFAULT_HASH_MB 64
+
+// fixed set of saved positions searched when no save file is given
+static const char* defaultPositions[] =
+{
+    "positions/opening1", "positions/opening2",
+    "positions/middle1", "positions/middle2", "positions/middle3", "positions/middle4",
+    "positions/endgame1", "positions/endgame2"
+};
+
+// thread counts measured when "--threads" is not given
+static const int defaultCounts[] = { 1, 2, 4, 8, 16, 32 };
+
+// method to read a comma separated list of thread counts into "counts"
+// returns the number of counts read, 0 if the list is invalid
+static int ParseCounts(const char* text, int* counts)
+{
+    int total = 0; // counts read so far
+    char* end = NULL; // first character after each number
+
+    while (*text != '\0' && total < BENCH_MAX_COUNTS)
+    {
+        long value = strtol(text, &end, 10); // next thread count
+
+        // qualifier: every entry must be a number in the supported range
+        if (end == text || value < 1 || value > SEARCH_MAX_THREADS) { return 0; }
+        counts[total] = (int)value;
+        total++;
+
+        // qualifier: numbers are separated by commas
+        if (*end == ',') { end++; }
+        else if (*end != '\0') { return 0; }
+        text = end;
+    }
+    return total;
+}
+
+// method for running the scaling benchmark (entry point)
+int main(int argc, char* argv[])
+{
+    GameState positions[BENCH_MAX_POSITIONS]; // positions to search
+    const char* names[BENCH_MAX_POSITIONS]; // file name of each position
+    int positionCount = 0; // positions loaded
+    int counts[BENCH_MAX_COUNTS]; // thread counts to measure
+    int countTotal = 0; // number of thread counts
+    int depth = BENCH_DEFAULT_DEPTH; // depth searched in every position
+    int hashMb = BENCH_DEFAULT_HASH_MB; // table size in MB
+    double baseSeconds = 0.0; // total time of the first thread count, for the speedup
+    TranspositionTable table; // shared by the threads of each search
+    const char* tablebaseFolder = NULL; // folder of the endgame tablebase, NULL for none
+    int tablebaseCacheMb = TB_DEFAULT_CACHE_MB; // block cache of the tablebase, in MB
+    Tablebase tablebase; // endgame tablebase probed by the searches
+    Tablebase* searchTablebase = NULL; // points to "tablebase" once opened
+    int i = 0; // loop iterator for arguments and thread counts
+    int p = 0; // loop iterator for the positions
+
+    StatsDumpOnExit(); // instrumented builds print the game core counters at exit
+
+    // read the options, every other argument is a save file
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--depth") == 0 && i + 1 < argc) { depth = atoi(argv[++i]); }
+        else if (strcmp(argv[i], "--hash") == 0 && i + 1 < argc) { hashMb = atoi(argv[++i]); }
+        else if (strcmp(argv[i], "--tablebase") == 0 && i + 1 < argc) { tablebaseFolder = argv[++i]; }
+        else if (strcmp(argv[i], "--tbcache") == 0 && i + 1 < argc) { tablebaseCacheMb = atoi(argv[++i]); }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+        {
+            countTotal = ParseCounts(argv[++i], counts);
+            if (countTotal == 0)
+            {
+                printf("Threads must be a list like 1,2,4 (each 1-%d).\n", SEARCH_MAX_THREADS);
+                return 1;
+            }
+        }
+        else if (positionCount < BENCH_MAX_POSITIONS) { names[positionCount++] = argv[i]; }
+    }
+
+    // qualifier: keep the settings inside a sensible range
+    if (depth < 1 || depth > SEARCH_MAX_DEPTH)
+    {
+        printf("Depth must be between 1 and %d.\n", SEARCH_MAX_DEPTH);
+        return 1;
+    }
+    if (hashMb < 1) { hashMb = 1; }
+    if (tablebaseCacheMb < 0) { tablebaseCacheMb = 0; }
+
+    // qualifier: fall back to the default positions and thread counts
+    if (positionCount == 0)
+    {
+        positionCount = (int)(sizeof(defaultPositions) / sizeof(defaultPositions[0]));
+        for (p = 0; p < positionCount; p++) { names[p] = defaultPositions[p]; }
+    }
+    if (countTotal == 0)
+    {
+        countTotal = (int)(sizeof(defaultCounts) / sizeof(defaultCounts[0]));
+        for (i = 0; i < countTotal; i++) { counts[i] = defaultCounts[i]; }
+    }
+
+    // load every position before timing anything
+    for (p = 0; p < positionCount; p++)
+    {
+        SetBoard(&positions[p]);
+        if (!LoadGame(names[p], &positions[p])) { return 1; }
+    }
+
+    if (!TTInit(&table, (size_t)hashMb))
+    {
+        printf("Could not allocate a %d MB table.\n", hashMb);
+        return 1;
+    }
+
+    // qualifier: the tablebase is optional, a folder without slices is an error
+    if (tablebaseFolder != NULL)
+    {
+        if (OpenTablebase(tablebaseFolder, (size_t)tablebaseCacheMb, &tablebase) == 0)
+        {
+            printf("No tablebase files found in: %s\n", tablebaseFolder);
+            CloseTablebase(&tablebase);
+            TTFree(&table);
+            return 1;
+        }
+        searchTablebase = &tablebase;
+        printf("\ntablebase: %d slices, up to %d pieces, %d MB cache\n", tablebase.sliceCount, tablebase.maxPieces, tablebaseCacheMb);
+    }
+
+    printf("\ntime to depth %d, %d positions, %d MB table\n\n", depth, positionCount, hashMb);
+    printf("%7s %10s %8s %15s %15s\n", "threads", "seconds", "speedup", "nodes", "nodes/second");
+
+    for (i = 0; i < countTotal; i++)
+    {
+        double seconds = 0.0; // total time over every position
+        unsigned long long nodes = 0ull; // total nodes over every position
+        double speedup = 0.0; // time of the first thread count divided by this one
+        double rate = 0.0; // nodes per second
+        unsigned long long tablebaseHits = 0ull; // positions answered by the tablebase
+
+        if (searchTablebase != NULL) { ResetTablebaseCacheCounters(searchTablebase); }
+        for (p = 0; p < positionCount; p++)
+        {
+            SearchLimits limits; // fixed depth, no time or node limit
+            SearchResult result; // time and nodes of this search
+
+            limits.maxDepth = depth;
+            limits.timeLimitMs = 0;
+            limits.nodeLimit = 0ull;
+            limits.verbose = 0;
+            limits.table = &table;
+            limits.threads = counts[i];
+            limits.tablebase = searchTablebase;
+            limits.stop = NULL;
+            limits.progress = NULL;
+            limits.progressContext = NULL;
+            limits.weights = NULL;
+
+            TTClear(&table); // every search starts from an empty table
+            SearchBestMove(&positions[p], &limits, &result);
+            seconds = seconds + result.seconds;
+            nodes = nodes + result.nodes;
+            tablebaseHits = tablebaseHits + result.tablebaseHits;
+        }
+
+        // qualifier: the first thread count is the baseline for the speedup
+        if (i == 0) { baseSeconds = seconds; }
+        if (seconds > 0.0)
+        {
+            speedup = baseSeconds / seconds;
+            rate = (double)nodes / seconds;
+        }
+        printf("%7d %10.3f %8.2f %15llu %15.0f\n", counts[i], seconds, speedup, nodes, rate);
+
+        // qualifier: how much the tablebase answered, and how often its blocks were already cached
+        if (searchTablebase != NULL)
+        {
+            TablebaseCacheStats stats; // block cache counters of this row
+
+            TablebaseCacheCounters(searchTablebase, &stats);
+            printf("%7s tablebase %llu positions, cache %llu hits / %llu misses (%.1f%% hits), %llu of %llu blocks used\n", "",
+                tablebaseHits, stats.hits, stats.misses,
+                (stats.hits + stats.misses > 0ull) ? 100.0 * (double)stats.hits / (double)(stats.hits + stats.misses) : 0.0,
+                stats.used, stats.blocks);
+        }
+    }
+
+    if (searchTablebase != NULL) { CloseTablebase(searchTablebase); }
+    TTFree(&table);
+    return 0;
+}
@@ -0,0 +1,741 @@
+// [selfplay.c] file
+// run the self-play tournament here!
+
+/*
+    Plays the engine against itself without any prompts, to measure whether a
+    change makes it play stronger. Engine A and engine B use the same search
+    with their own limits (depth, nodes, or time per move); every opening is
+    played twice with the colors swapped, so neither side gains from the
+    opening itself. Games run in parallel, one game per worker thread.
+
+    Usage:
+        ./selfplay [options] [dir|savefiles...]
+
+        --games N           games to play (default 200, rounded up to an even number)
+        --jobs N            games played at the same time (default: one per CPU core)
+        --depth-a D         depth limit per move of engine A (default 6)
+        --depth-b D         depth limit per move of engine B (default 6)
+        --nodes-a N         node limit per move of engine A (default none)
+        --nodes-b N         node limit per move of engine B (default none)
+        --time-a MS         time per move of engine A (default none)
+        --time-b MS         time per move of engine B (default none)
+        --weights-a FILE    evaluation weights of engine A (default: the built-in weights, see "evaluate.h")
+        --weights-b FILE    evaluation weights of engine B
+        --hash MB           transposition table of each engine in each worker (default 4)
+        --random-plies N    random moves that start each opening from SetBoard (default 4)
+        --max-plies N       game length after which the game is a draw (default 300)
+        --seed N            seed of the random openings (default 1)
+        --sprt E0 E1        stop once the Elo difference is shown to be E0 (H0) or E1 (H1)
+        --alpha A           chance of accepting H1 when H0 is true (default 0.05)
+        --beta B            chance of accepting H0 when H1 is true (default 0.05)
+        --output FILE       write every game as a game record (the format "bookbuild" reads)
+        --book FILE         both engines play book moves while the position is in this opening book
+        [dir|savefiles]     start the openings from these 5-line save files instead
+
+    Book moves are chosen after the random plies, from a random state of the
+    opening, so both games of an opening follow the same book line.
+
+    A game ends when a player has no pieces or no legal moves, and is a draw
+    after --max-plies plies or when the same position comes up a third time.
+
+    Results are printed from engine A's point of view: wins, draws, losses,
+    the score, and the Elo difference with its 95% error bar. With --sprt the
+    log-likelihood ratio is updated after every game and, once SPRT_MIN_GAMES
+    games are finished, the run stops as soon as it leaves
+    [log(beta / (1 - alpha)), log((1 - beta) / alpha)].
+*/
+
+// sysconf is POSIX, not part of plain C11
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h> // for printing and writing the game records
+#include <stdlib.h> // for atoi / strtoull / malloc / free
+#include <string.h> // for comparing arguments
+#include <math.h> // for log / log10 / sqrt (Elo and SPRT)
+#include <time.h> // for timespec_get (run time)
+#include <pthread.h> // for the worker threads
+#include <unistd.h> // for sysconf (number of CPU cores)
+
+#include "filewalk.h" // WalkFiles for directories of save files
+#include "game.h" // GameState, SetBoard, CheckWinner, PositionProblem
+#include "movegen.h" // GenerateMoves / MakeMove / MoveToText
+#include "saveload.h" // ReadGameFile for the start positions
+#include "search.h" // SearchBestMove
+#include "evaluate.h" // LoadEvalWeights for "--weights-a" / "--weights-b"
+#include "tt.h" // one transposition table per engine in each worker
+#include "book.h" // opening book shared by both engines ("--book")
+#include "stats.h" // game core counters of instrumented builds
+#include "gamerecord.h" // WriteFenTag for the start positions of "--output"
+
+// default and maximum settings
+#define SELFPLAY_DEFAULT_GAMES 200
+#define SELFPLAY_DEFAULT_DEPTH 6
+#define SELFPLAY_DEFAULT_HASH_MB 4
+#define SELFPLAY_DEFAULT_RANDOM_PLIES 4
+#define SELFPLAY_DEFAULT_MAX_PLIES 300
+#define SELFPLAY_MAX_JOBS 256
+
+// games finished before the SPRT may stop the run, the variance of fewer games is too uncertain
+#define SPRT_MIN_GAMES 40
+
+// longest text of one move ("FROMxLANDx..." with MAX_JUMPS landings) plus a space
+#define MOVE_TEXT_MAX 64
+
+// how a game ended, printed in the game record
+#define END_PIECES 0 // a player has no pieces left
+#define END_BLOCKED 1 // the player to move has no legal moves
+#define END_PLY_LIMIT 2 // draw after --max-plies plies
+#define END_REPETITION 3 // draw, same position a third time
+
+// search limits of one engine
+typedef struct
+{
+    int depth; // depth limit per move, 0 for none
+    unsigned long long nodes; // node limit per move, 0 for none
+    int timeMs; // time per move in milliseconds, 0 for none
+    EvalWeights weights; // evaluation weights ("--weights-a" / "--weights-b")
+    int hasWeights; // flagger for "weights" being read from a file, otherwise the defaults are used
+} EngineSettings;
+
+// settings and shared state of one tournament
+typedef struct
+{
+    EngineSettings engines[2]; // engine A (0) and engine B (1)
+    int games; // games to play
+    int hashMb; // table size of each engine, in MB
+    int randomPlies; // random opening moves from SetBoard
+    int maxPlies; // plies until the game is a draw
+    unsigned long long seed; // seed of the random openings
+    GameState* starts; // start positions read from save files (NULL for SetBoard)
+    int startCount; // positions in "starts"
+    int startCapacity; // room in "starts"
+    int sprt; // flagger set when the SPRT stop is used
+    double elo0; // Elo difference of H0
+    double elo1; // Elo difference of H1
+    double lowerBound; // log(beta / (1 - alpha)), H0 is accepted below it
+    double upperBound; // log((1 - beta) / alpha), H1 is accepted above it
+    FILE* output; // game records, NULL for none
+    OpeningBook book; // opening book, read by every worker ("--book")
+    int hasBook; // flagger for "book" being open
+    pthread_mutex_t lock; // protects every field below
+    int nextGame; // next game to hand to a worker
+    int stopped; // flagger set once the SPRT decided, no new games start
+    int decision; // 0 while undecided, 1 H1 accepted, -1 H0 accepted
+    int finished; // games finished
+    int reported; // games finished when the last results line was printed
+    int wins; // games won by engine A
+    int draws; // games drawn
+    int losses; // games lost by engine A
+    unsigned long long plies; // plies played in every finished game
+    double started; // wall clock at the start
+} Tournament;
+
+// one worker thread and its own tables
+typedef struct
+{
+    Tournament* tournament; // shared state
+    TranspositionTable tables[2]; // table of engine A and engine B
+    char* text; // moves of the game being played, as text
+    size_t textSize; // room in "text"
+} Worker;
+
+// method to read the wall clock in seconds
+static double WallSeconds(void)
+{
+    struct timespec now; // current wall clock time
+    timespec_get(&now, TIME_UTC);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+// method to find the number of CPU cores, 1 if unknown
+static int CoreCount(void)
+{
+#ifdef _SC_NPROCESSORS_ONLN
+    long cores = sysconf(_SC_NPROCESSORS_ONLN); // cores currently online
+    if (cores > 0) { return (cores > SELFPLAY_MAX_JOBS) ? SELFPLAY_MAX_JOBS : (int)cores; }
+#endif
+    return 1;
+}
+
+// method for the splitmix64 random number generator, advances "state" and returns the next number
+static unsigned long long NextRandom(unsigned long long* state)
+{
+    unsigned long long mixed = 0ull; // number being scrambled
+
+    *state = *state + 0x9E3779B97F4A7C15ull;
+    mixed = *state;
+    mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ull;
+    mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBull;
+    return mixed ^ (mixed >> 31);
+}
+
+// Statistics //
+
+// method to turn a score (0 to 1) into an Elo difference
+static double EloFromScore(double score)
+{
+    // qualifier: a perfect score has no finite Elo, keep it at +/- 1200
+    if (score < 0.001) { score = 0.001; }
+    if (score > 0.999) { score = 0.999; }
+    return -400.0 * log10(1.0 / score - 1.0);
+}
+
+// method to turn an Elo difference into the expected score
+static double ScoreFromElo(double elo)
+{
+    return 1.0 / (1.0 + pow(10.0, -elo / 400.0));
+}
+
+// method to compute the score of engine A, its per-game variance, the Elo difference and its 95% error bar
+// must be called with at least one finished game
+static void ResultStats(const Tournament* tournament, double* score, double* variance, double* elo, double* margin)
+{
+    double games = (double)tournament->finished; // games finished
+    double mean = (tournament->wins + 0.5 * tournament->draws) / games; // average points per game
+    double spread = 0.0; // standard error of "mean"
+
+    // variance of the points of one game (1 / 0.5 / 0) around the mean
+    *variance = (tournament->wins * (1.0 - mean) * (1.0 - mean) + tournament->draws * (0.5 - mean) * (0.5 - mean)
+        + tournament->losses * mean * mean) / games;
+    spread = sqrt(*variance / games);
+
+    *score = mean;
+    *elo = EloFromScore(mean);
+    *margin = (EloFromScore(mean + 1.96 * spread) - EloFromScore(mean - 1.96 * spread)) / 2.0;
+}
+
+// method to compute the log-likelihood ratio of H1 (elo1) against H0 (elo0) for the games so far
+// uses the normal approximation of the score, 0 while every game had the same result
+static double LogLikelihoodRatio(const Tournament* tournament)
+{
+    double score = 0.0; // average points of engine A
+    double variance = 0.0; // variance of the points of one game
+    double elo = 0.0; // unused here
+    double margin = 0.0; // unused here
+    double score0 = ScoreFromElo(tournament->elo0); // expected score under H0
+    double score1 = ScoreFromElo(tournament->elo1); // expected score under H1
+
+    if (tournament->finished == 0) { return 0.0; }
+    ResultStats(tournament, &score, &variance, &elo, &margin);
+    if (variance <= 0.0) { return 0.0; }
+    return tournament->finished * (score1 - score0) * (2.0 * score - score0 - score1) / (2.0 * variance);
+}
+
+// method to print one line with the results so far
+// nothing is printed if no game finished since the last line
+static void PrintResults(Tournament* tournament)
+{
+    double score = 0.0; // average points of engine A
+    double variance = 0.0; // variance of the points of one game
+    double elo = 0.0; // Elo difference of A against B
+    double margin = 0.0; // 95% error bar of "elo"
+
+    if (tournament->finished == 0 || tournament->finished == tournament->reported) { return; }
+    ResultStats(tournament, &score, &variance, &elo, &margin);
+    tournament->reported = tournament->finished;
+
+    printf("games %5d  +%d =%d -%d  score %5.1f%%  Elo %+7.1f +/- %.1f", tournament->finished,
+        tournament->wins, tournament->draws, tournament->losses, 100.0 * score, elo, margin);
+    if (tournament->sprt)
+    {
+        printf("  LLR %+.2f [%.2f, %.2f]", LogLikelihoodRatio(tournament), tournament->lowerBound, tournament->upperBound);
+    }
+    printf("  (%.1f s)\n", WallSeconds() - tournament->started);
+    fflush(stdout);
+}
+
+// Games //
+
+// method to add a start position read by WalkFiles, "context" is the Tournament
+static void AddStart(const char* path, void* context)
+{
+    Tournament* tournament = (Tournament*)context; // tournament receiving the position
+    GameState game; // position read from the file
+    int errorLine = 0; // first invalid line of the file
+
+    // qualifier: only legal positions that are not already over can start a game
+    if (!ReadGameFile(path, &game, &errorLine) || PositionProblem(&game) != NULL
+        || CheckWinner(&game) != 0 || !CheckLegalMoves(&game))
+    {
+        fprintf(stderr, "Not a playable position, skipped: %s\n", path);
+        return;
+    }
+
+    if (tournament->startCount == tournament->startCapacity)
+    {
+        int capacity = (tournament->startCapacity == 0) ? 64 : tournament->startCapacity * 2; // new room
+        GameState* starts = (GameState*)realloc(tournament->starts, (size_t)capacity * sizeof(GameState)); // grown list
+
+        if (starts == NULL)
+        {
+            fprintf(stderr, "Out of memory, skipped: %s\n", path);
+            return;
+        }
+        tournament->starts = starts;
+        tournament->startCapacity = capacity;
+    }
+    tournament->starts[tournament->startCount++] = game;
+}
+
+// method to append "text" and a space to the worker's move text
+static void AppendText(Worker* worker, size_t* length, const char* text)
+{
+    size_t extra = strlen(text) + 1u; // characters added
+
+    // qualifier: grow the buffer, a game with many plies still fits
+    if (*length + extra + 1u > worker->textSize)
+    {
+        size_t size = (worker->textSize + extra + 1u) * 2u; // new room
+        char* grown = (char*)realloc(worker->text, size); // larger buffer
+
+        if (grown == NULL) { return; }
+        worker->text = grown;
+        worker->textSize = size;
+    }
+    memcpy(worker->text + *length, text, extra - 1u);
+    worker->text[*length + extra - 1u] = ' ';
+    *length += extra;
+    worker->text[*length] = '\0';
+}
+
+// method to set up the opening of game "index": its start position plus any random plies
+// games 2k and 2k + 1 share the same opening
+// returns the random plies played (fewer than asked if they already ended the game)
+static int SetupOpening(const Tournament* tournament, int index, GameState* game, Worker* worker, size_t* length)
+{
+    int pair = index / 2; // opening number
+    unsigned long long state = tournament->seed ^ (0xD1B54A32D192ED03ull * (unsigned long long)(pair + 1)); // random state of this opening
+    int ply = 0; // loop iterator for the random plies
+
+    // qualifier: save files are used in turn, otherwise the game starts from SetBoard
+    if (tournament->startCount > 0) { *game = tournament->starts[pair % tournament->startCount]; }
+    else { SetBoard(game); }
+
+    for (ply = 0; ply < tournament->randomPlies; ply++)
+    {
+        MoveList list; // legal moves of the position
+        const Move* move = NULL; // random legal move
+        char text[MOVE_TEXT_MAX]; // chosen move as text
+
+        // qualifier: stop early if the random moves already ended the game
+        if (GenerateMoves(game, &list) == 0 || CheckWinner(game) != 0) { break; }
+
+        move = &list.moves[NextRandom(&state) % (unsigned long long)list.count];
+        AppendText(worker, length, MoveToText(move, text, (int)sizeof(text)));
+        ApplyMove(game, move);
+    }
+    return ply;
+}
+
+// method to play game "index" and return its result for engine A: 2 win, 1 draw, 0 loss
+// "plies" receives the game length, "ending" how the game ended (END_*)
+static int PlayGame(Worker* worker, int index, int* plies, int* ending)
+{
+    Tournament* tournament = worker->tournament; // shared settings
+    int redEngine = index % 2; // engine playing Red (0 is A), the colors swap every game
+    GameState game; // position being played
+    unsigned long long* history = NULL; // keys since the last capture or man move
+    int historyCount = 0; // keys in "history"
+    size_t length = 0u; // characters in the worker's move text
+    int winner = 0; // 1 Red, 2 Black, 0 draw
+    int ply = 0; // plies played, the random opening included
+    unsigned long long bookState = tournament->seed ^ (0x9FB21C651E98DF25ull * (unsigned long long)(index / 2 + 1)); // book choices of this opening
+
+    worker->text[0] = '\0';
+    ply = SetupOpening(tournament, index, &game, worker, &length);
+    TTClear(&worker->tables[0]);
+    TTClear(&worker->tables[1]);
+
+    history = (unsigned long long*)malloc(((size_t)tournament->maxPlies + 1u) * sizeof(unsigned long long));
+    *ending = END_PLY_LIMIT;
+
+    while (1)
+    {
+        int engine = (game.current_turn == 1) ? redEngine : 1 - redEngine; // engine to move
+        const EngineSettings* settings = &tournament->engines[engine]; // its limits
+        SearchLimits limits; // search of this move
+        SearchResult result; // move chosen
+        BookMove bookMove; // move chosen from the opening book
+        MoveRecord record; // captures and promotion of the move
+        char text[MOVE_TEXT_MAX]; // move as text
+        int repeats = 0; // earlier occurrences of the position
+        int i = 0; // loop iterator for the history
+
+        // qualifier: the game is over when a player has no pieces or no legal moves
+        winner = CheckWinner(&game);
+        if (winner != 0)
+        {
+            *ending = END_PIECES;
+            break;
+        }
+        if (!CheckLegalMoves(&game))
+        {
+            winner = 3 - game.current_turn;
+            *ending = END_BLOCKED;
+            break;
+        }
+
+        // qualifier: a draw after the ply limit, or when the position comes up a third time
+        if (ply >= tournament->maxPlies) { break; }
+        for (i = 0; i < historyCount; i++)
+        {
+            if (history[i] == game.zobrist_key) { repeats++; }
+        }
+        if (repeats >= 2)
+        {
+            *ending = END_REPETITION;
+            break;
+        }
+        if (history != NULL) { history[historyCount++] = game.zobrist_key; }
+
+        limits.maxDepth = settings->depth;
+        limits.timeLimitMs = settings->timeMs;
+        limits.nodeLimit = settings->nodes;
+        limits.verbose = 0;
+        limits.table = &worker->tables[engine];
+        limits.threads = 1;
+        limits.tablebase = NULL;
+        limits.stop = NULL;
+        limits.progress = NULL;
+        limits.progressContext = NULL;
+        limits.weights = settings->hasWeights ? &settings->weights : NULL;
+
+        // qualifier: a position in the book is played from the book without a search, both engines alike
+        if (tournament->hasBook && ChooseBookMove(&tournament->book, &game, NextRandom(&bookState), &bookMove))
+        {
+            MakeMove(&game, &bookMove.move, &record);
+        }
+        else
+        {
+            SearchBestMove(&game, &limits, &result);
+            MakeMove(&game, &result.bestMove, &record);
+        }
+        AppendText(worker, &length, MoveToText(&record.move, text, (int)sizeof(text)));
+        ply++;
+
+        // qualifier: a capture or a man move can never be undone, earlier positions cannot repeat
+        if (record.move.jumps > 0 || !record.movedKing) { historyCount = 0; }
+    }
+
+    free(history);
+    *plies = ply;
+
+    if (winner == 0) { return 1; }
+    return ((winner == 1) == (redEngine == 0)) ? 2 : 0;
+}
+
+// method to write game "index" as a game record, called with the tournament lock held
+static void WriteRecord(const Tournament* tournament, const Worker* worker, int index, int points, int ending)
+{
+    static const char* endings[] = { "no pieces left", "no legal moves", "ply limit", "repetition" }; // END_* text
+    int redEngine = index % 2; // engine playing Red
+    const char* result = "1/2-1/2"; // result token
+
+    if (points != 1) { result = ((points == 2) == (redEngine == 0)) ? "1-0" : "0-1"; }
+
+    fprintf(tournament->output, "# game %d: %s (Red) vs %s (Black), %s", index + 1,
+        (redEngine == 0) ? "A" : "B", (redEngine == 0) ? "B" : "A", endings[ending]);
+    if (tournament->startCount > 0) { fprintf(tournament->output, ", start position %d", (index / 2) % tournament->startCount + 1); }
+    fprintf(tournament->output, "\n");
+
+    // qualifier: a save file start is written as a [FEN] tag, "bookbuild" starts the game there instead of at SetBoard
+    if (tournament->startCount > 0) { WriteFenTag(tournament->output, &tournament->starts[(index / 2) % tournament->startCount]); }
+    fprintf(tournament->output, "%s%s\n", worker->text, result);
+}
+
+// method run by each worker thread, plays games until every game is handed out or the SPRT decided
+static void* PlayWorker(void* argument)
+{
+    Worker* worker = (Worker*)argument; // this worker and its tables
+    Tournament* tournament = worker->tournament; // shared state
+
+    while (1)
+    {
+        int index = 0; // game to play
+        int points = 0; // result for engine A
+        int plies = 0; // game length
+        int ending = 0; // how the game ended
+        int decided = 0; // flagger set if this game made the SPRT decide
+
+        pthread_mutex_lock(&tournament->lock);
+        if (tournament->stopped || tournament->nextGame >= tournament->games)
+        {
+            pthread_mutex_unlock(&tournament->lock);
+            break;
+        }
+        index = tournament->nextGame++;
+        pthread_mutex_unlock(&tournament->lock);
+
+        points = PlayGame(worker, index, &plies, &ending);
+
+        pthread_mutex_lock(&tournament->lock);
+        if (points == 2) { tournament->wins++; }
+        else if (points == 1) { tournament->draws++; }
+        else { tournament->losses++; }
+        tournament->finished++;
+        tournament->plies += (unsigned long long)plies;
+        if (tournament->output != NULL) { WriteRecord(tournament, worker, index, points, ending); }
+
+        // qualifier: the SPRT stops the run as soon as either bound is crossed
+        if (tournament->sprt && tournament->decision == 0 && tournament->finished >= SPRT_MIN_GAMES)
+        {
+            double ratio = LogLikelihoodRatio(tournament); // evidence for H1 against H0
+
+            if (ratio >= tournament->upperBound) { tournament->decision = 1; }
+            else if (ratio <= tournament->lowerBound) { tournament->decision = -1; }
+            if (tournament->decision != 0)
+            {
+                tournament->stopped = 1;
+                decided = 1;
+            }
+        }
+
+        // qualifier: a progress line every 10% of the games, and when the SPRT decided
+        if (tournament->finished % ((tournament->games >= 10) ? tournament->games / 10 : 1) == 0 || decided)
+        {
+            PrintResults(tournament);
+        }
+        pthread_mutex_unlock(&tournament->lock);
+    }
+    return NULL;
+}
+
+// method to read the limits of one engine from "--depth-a" style options
+// returns 1 if "argv[i]" was such an option (and advances "i" past its value),
+// -1 if it named a weight file that could not be read, otherwise 0
+static int ReadEngineOption(Tournament* tournament, int argc, char* argv[], int* i)
+{
+    static const char* names[] = { "--depth-", "--nodes-", "--time-", "--weights-" }; // option names without the engine letter
+    int option = 0; // loop iterator for the option names
+
+    for (option = 0; option < 4; option++)
+    {
+        size_t length = strlen(names[option]); // characters before the engine letter
+        EngineSettings* settings = NULL; // engine the option is for
+
+        if (strncmp(argv[*i], names[option], length) != 0 || argv[*i][length + 1] != '\0' || *i + 1 >= argc) { continue; }
+        if (argv[*i][length] == 'a') { settings = &tournament->engines[0]; }
+        else if (argv[*i][length] == 'b') { settings = &tournament->engines[1]; }
+        else { return 0; }
+
+        (*i)++;
+        if (option == 0) { settings->depth = atoi(argv[*i]); }
+        else if (option == 1) { settings->nodes = strtoull(argv[*i], NULL, 10); }
+        else if (option == 2) { settings->timeMs = atoi(argv[*i]); }
+        else
+        {
+            int errorLine = 0; // first invalid line of the weight file
+
+            // qualifier: a weight file that cannot be used stops the run, the engines would not be what was asked
+            if (!LoadEvalWeights(argv[*i], &settings->weights, &errorLine))
+            {
+                if (errorLine > 0) { printf("Invalid weight in %s, line %d.\n", argv[*i], errorLine); }
+                else { printf("Could not read weight file %s.\n", argv[*i]); }
+                return -1;
+            }
+            settings->hasWeights = 1;
+        }
+        return 1;
+    }
+    return 0;
+}
+
+// method to print the usage text
+static void PrintUsage(void)
+{
+    printf("Usage: ./selfplay [--games N] [--jobs N] [--depth-a D] [--depth-b D] [--nodes-a N] [--nodes-b N]\n");
+    printf("                  [--time-a MS] [--time-b MS] [--weights-a FILE] [--weights-b FILE] [--hash MB]\n");
+    printf("                  [--random-plies N] [--max-plies N] [--seed N]\n");
+    printf("                  [--sprt E0 E1] [--alpha A] [--beta B] [--output FILE]\n");
+    printf("                  [--book FILE] [dir|savefiles...]\n");
+}
+
+// method for running the self-play tournament (entry point)
+int main(int argc, char* argv[])
+{
+    static Tournament tournament; // shared run state (static, it holds the mutex for the whole run)
+    static Worker workers[SELFPLAY_MAX_JOBS]; // worker state and tables
+    pthread_t threads[SELFPLAY_MAX_JOBS]; // worker thread handles
+    int started[SELFPLAY_MAX_JOBS] = { 0 }; // flagger per worker, set if its thread is running
+    const char* outputName = NULL; // game record file, NULL for none
+    const char* bookName = NULL; // opening book file, NULL for none
+    double alpha = 0.05; // SPRT false positive rate
+    double beta = 0.05; // SPRT false negative rate
+    int jobs = CoreCount(); // worker threads
+    int failed = 0; // paths that could not be read
+    int paths = 0; // start position paths given
+    int i = 0; // loop iterator for arguments and workers
+    GameState start; // SetBoard position, also fills the Zobrist tables before any thread starts
+
+    tournament.games = SELFPLAY_DEFAULT_GAMES;
+    tournament.engines[0].depth = SELFPLAY_DEFAULT_DEPTH;
+    tournament.engines[1].depth = SELFPLAY_DEFAULT_DEPTH;
+    tournament.hashMb = SELFPLAY_DEFAULT_HASH_MB;
+    tournament.randomPlies = SELFPLAY_DEFAULT_RANDOM_PLIES;
+    tournament.maxPlies = SELFPLAY_DEFAULT_MAX_PLIES;
+    tournament.seed = 1ull;
+    SetBoard(&start);
+    StatsDumpOnExit(); // instrumented builds print the game core counters at exit
+
+    // read the options, every other argument is a save file or a folder of them
+    for (i = 1; i < argc; i++)
+    {
+        int engineOption = ReadEngineOption(&tournament, argc, argv, &i); // 1 for an engine option, -1 for a bad weight file
+
+        if (engineOption < 0) { return 1; }
+        if (engineOption > 0) { continue; }
+        if (strcmp(argv[i], "--games") == 0 && i + 1 < argc) { tournament.games = atoi(argv[++i]); }
+        else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) { jobs = atoi(argv[++i]); }
+        else if (strcmp(argv[i], "--hash") == 0 && i + 1 < argc) { tournament.hashMb = atoi(argv[++i]); }
+        else if (strcmp(argv[i], "--random-plies") == 0 && i + 1 < argc) { tournament.randomPlies = atoi(argv[++i]); }
+        else if (strcmp(argv[i], "--max-plies") == 0 && i + 1 < argc) { tournament.maxPlies = atoi(argv[++i]); }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) { tournament.seed = strtoull(argv[++i], NULL, 10); }
+        else if (strcmp(argv[i], "--alpha") == 0 && i + 1 < argc) { alpha = atof(argv[++i]); }
+        else if (strcmp(argv[i], "--beta") == 0 && i + 1 < argc) { beta = atof(argv[++i]); }
+        else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) { outputName = argv[++i]; }
+        else if (strcmp(argv[i], "--book") == 0 && i + 1 < argc) { bookName = argv[++i]; }
+        else if (strcmp(argv[i], "--sprt") == 0 && i + 2 < argc)
+        {
+            tournament.sprt = 1;
+            tournament.elo0 = atof(argv[++i]);
+            tournament.elo1 = atof(argv[++i]);
+        }
+        else if (strncmp(argv[i], "--", 2) == 0)
+        {
+            PrintUsage();
+            return 1;
+        }
+        else
+        {
+            failed += WalkFiles(argv[i], AddStart, &tournament);
+            paths++;
+        }
+    }
+
+    // qualifier: keep the settings inside a sensible range
+    if (tournament.games < 1 || jobs < 1 || jobs > SELFPLAY_MAX_JOBS || tournament.hashMb < 1
+        || tournament.randomPlies < 0 || tournament.maxPlies < 1 || tournament.maxPlies <= tournament.randomPlies
+        || alpha <= 0.0 || alpha >= 0.5 || beta <= 0.0 || beta >= 0.5 || (tournament.sprt && tournament.elo1 <= tournament.elo0))
+    {
+        PrintUsage();
+        printf("--jobs 1-%d, --max-plies above --random-plies, --alpha / --beta below 0.5, --sprt E0 below E1\n", SELFPLAY_MAX_JOBS);
+        return 1;
+    }
+    for (i = 0; i < 2; i++)
+    {
+        EngineSettings* settings = &tournament.engines[i]; // engine being checked
+
+        if (settings->depth < 0 || settings->depth > SEARCH_MAX_DEPTH || settings->timeMs < 0
+            || (settings->depth == 0 && settings->nodes == 0ull && settings->timeMs == 0))
+        {
+            printf("Engine %c needs a depth (1-%d), node or time limit.\n", 'A' + i, SEARCH_MAX_DEPTH);
+            return 1;
+        }
+    }
+    if (paths > 0 && tournament.startCount == 0)
+    {
+        printf("No playable start positions found.\n");
+        return 1;
+    }
+    tournament.games += tournament.games % 2; // every opening is played with both colors
+    if (jobs > tournament.games) { jobs = tournament.games; }
+    tournament.lowerBound = log(beta / (1.0 - alpha));
+    tournament.upperBound = log((1.0 - beta) / alpha);
+
+    if (bookName != NULL)
+    {
+        tournament.hasBook = OpenBook(bookName, &tournament.book);
+        if (!tournament.hasBook)
+        {
+            printf("Could not open the opening book: %s\n", bookName);
+            free(tournament.starts);
+            return 1;
+        }
+    }
+    if (outputName != NULL)
+    {
+        tournament.output = fopen(outputName, "w");
+        if (tournament.output == NULL)
+        {
+            printf("Could not create the output file: %s\n", outputName);
+            if (tournament.hasBook) { CloseBook(&tournament.book); }
+            free(tournament.starts);
+            return 1;
+        }
+    }
+
+    printf("\n%d games, %d jobs, openings from %s + %d random plies\n", tournament.games, jobs,
+        (tournament.startCount > 0) ? "save files" : "SetBoard", tournament.randomPlies);
+    if (tournament.hasBook) { printf("opening book: %llu moves, played by both engines\n", tournament.book.count); }
+    for (i = 0; i < 2; i++)
+    {
+        printf("engine %c: depth %d, nodes %llu, time %d ms (0 = no limit), %s weights\n", 'A' + i,
+            tournament.engines[i].depth, tournament.engines[i].nodes, tournament.engines[i].timeMs,
+            tournament.engines[i].hasWeights ? "file" : "default");
+    }
+    if (tournament.sprt)
+    {
+        printf("SPRT: H0 Elo %.1f, H1 Elo %.1f, alpha %.3f, beta %.3f\n", tournament.elo0, tournament.elo1, alpha, beta);
+    }
+    printf("\n");
+
+    pthread_mutex_init(&tournament.lock, NULL);
+    tournament.started = WallSeconds();
+
+    // start the workers, each with its own pair of tables
+    for (i = 0; i < jobs; i++)
+    {
+        workers[i].tournament = &tournament;
+        workers[i].textSize = 4096u;
+        workers[i].text = (char*)malloc(workers[i].textSize);
+        if (workers[i].text == NULL) { break; }
+        if (!TTInit(&workers[i].tables[0], (size_t)tournament.hashMb)) { free(workers[i].text); break; }
+        if (!TTInit(&workers[i].tables[1], (size_t)tournament.hashMb))
+        {
+            TTFree(&workers[i].tables[0]);
+            free(workers[i].text);
+            break;
+        }
+        started[i] = (pthread_create(&threads[i], NULL, PlayWorker, &workers[i]) == 0);
+        if (!started[i])
+        {
+            TTFree(&workers[i].tables[0]);
+            TTFree(&workers[i].tables[1]);
+            free(workers[i].text);
+            break;
+        }
+    }
+    if (i == 0) { printf("Could not start any worker (out of memory).\n"); }
+
+    for (i = 0; i < jobs; i++)
+    {
+        if (!started[i]) { continue; }
+        pthread_join(threads[i], NULL);
+        TTFree(&workers[i].tables[0]);
+        TTFree(&workers[i].tables[1]);
+        free(workers[i].text);
+    }
+
+    // the final line, games still running when the SPRT decided are included
+    PrintResults(&tournament);
+    if (tournament.finished > 0)
+    {
+        printf("\naverage game length %.1f plies\n", (double)tournament.plies / tournament.finished);
+    }
+    if (tournament.sprt)
+    {
+        if (tournament.decision > 0) { printf("SPRT: H1 accepted, A is at least %.1f Elo stronger\n", tournament.elo1); }
+        else if (tournament.decision < 0) { printf("SPRT: H0 accepted, A is not %.1f Elo stronger\n", tournament.elo1); }
+        else { printf("SPRT: no decision after %d games\n", tournament.finished); }
+    }
+
+    if (tournament.output != NULL && fclose(tournament.output) != 0)
+    {
+        printf("Could not write the output file: %s\n", outputName);
+        failed++;
+    }
+    pthread_mutex_destroy(&tournament.lock);
+    if (tournament.hasBook) { CloseBook(&tournament.book); }
+    free(tournament.starts);
+    return (failed == 0 && tournament.finished > 0) ? 0 : 1;
+}
@@ -0,0 +1,269 @@
+// [stats.c] file
+
+// clock_gettime (CLOCK_MONOTONIC) is POSIX, not part of plain C11
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h> // for printing the summary
+#include <stdlib.h> // for aligned_alloc / free / atexit / getenv
+#include <string.h> // for memset
+#include <time.h> // for clock_gettime
+#include <pthread.h> // for the block list lock and the thread exit hook
+
+#include "stats.h" // declare "stats" variables/methods
+
+// names of the counters, text and JSON
+static const char* counterNames[STAT_COUNTERS][2] =
+{
+    { "TryMove calls", "try_move_calls" },
+    { "TryMove rejected", "try_move_rejected" },
+    { "CheckLegalMoves scans", "legality_scans" },
+    { "CheckWinner checks", "winner_checks" },
+    { "GenerateMoves calls", "generate_calls" },
+    { "moves made", "moves_made" },
+    { "pieces captured", "captures" },
+    { "men promoted", "promotions" }
+};
+
+// names of the timers, text and JSON
+static const char* timerNames[STAT_TIMERS][2] =
+{
+    { "TryMove", "try_move" },
+    { "CheckLegalMoves", "legal_moves" }
+};
+
+#ifdef GAME_STATS
+
+// this thread's block, NULL until it first counts something
+_Thread_local StatsBlock* statsThread = NULL;
+
+static pthread_mutex_t statsLock = PTHREAD_MUTEX_INITIALIZER; // guards the block list and "statsEnded"
+static pthread_once_t statsOnce = PTHREAD_ONCE_INIT; // creates "statsKey" once
+static pthread_key_t statsKey; // calls "EndThreadBlock" when a counting thread ends
+static StatsBlock* statsLive = NULL; // blocks of the threads still running
+static StatsTotals statsEnded; // totals of the threads that ended
+
+// method to add the counters of "block" into "totals"
+static void AddBlock(StatsTotals* totals, StatsBlock* block)
+{
+    int i = 0; // loop iterator for the counters and timers
+
+    for (i = 0; i < STAT_COUNTERS; i++) { totals->counts[i] += atomic_load_explicit(&block->counts[i], memory_order_relaxed); }
+    for (i = 0; i < STAT_TIMERS; i++)
+    {
+        unsigned long long slowest = atomic_load_explicit(&block->timerMaxNs[i], memory_order_relaxed); // slowest call
+
+        totals->timerCalls[i] += atomic_load_explicit(&block->timerCalls[i], memory_order_relaxed);
+        totals->timerNs[i] += atomic_load_explicit(&block->timerNs[i], memory_order_relaxed);
+        if (slowest > totals->timerMaxNs[i]) { totals->timerMaxNs[i] = slowest; }
+    }
+}
+
+// method called when a counting thread ends, moves its counters into "statsEnded"
+static void EndThreadBlock(void* value)
+{
+    StatsBlock* block = (StatsBlock*)value; // the ending thread's block
+
+    pthread_mutex_lock(&statsLock);
+    AddBlock(&statsEnded, block);
+    statsEnded.threads++;
+    if (block->previous != NULL) { block->previous->next = block->next; }
+    else { statsLive = block->next; }
+    if (block->next != NULL) { block->next->previous = block->previous; }
+    pthread_mutex_unlock(&statsLock);
+    free(block);
+}
+
+// method to create the thread exit hook, run once
+static void CreateStatsKey(void)
+{
+    pthread_key_create(&statsKey, EndThreadBlock);
+}
+
+// create and register this thread's block (first use only)
+StatsBlock* StatsThreadBlock(void)
+{
+    // qualifier: the block starts on a cache line of its own, its size is whole cache lines (see "stats.h")
+    StatsBlock* block = (StatsBlock*)aligned_alloc(STATS_CACHE_LINE, sizeof(StatsBlock)); // new counters
+    static StatsBlock fallback; // shared block if memory ran out (counts may then race)
+    static int fallbackLinked = 0; // flagger set once "fallback" is in "statsLive"
+
+    // qualifier: the shared block is linked once, it counts as one thread and never ends
+    if (block == NULL)
+    {
+        pthread_mutex_lock(&statsLock);
+        if (!fallbackLinked)
+        {
+            fallback.next = statsLive;
+            if (statsLive != NULL) { statsLive->previous = &fallback; }
+            statsLive = &fallback;
+            fallbackLinked = 1;
+        }
+        pthread_mutex_unlock(&statsLock);
+        statsThread = &fallback;
+        return &fallback;
+    }
+    memset(block, 0, sizeof(StatsBlock));
+
+    pthread_once(&statsOnce, CreateStatsKey);
+    pthread_mutex_lock(&statsLock);
+    block->next = statsLive;
+    if (statsLive != NULL) { statsLive->previous = block; }
+    statsLive = block;
+    pthread_mutex_unlock(&statsLock);
+
+    pthread_setspecific(statsKey, block);
+    statsThread = block;
+    return block;
+}
+
+// read the monotonic clock in nanoseconds
+unsigned long long StatsNow(void)
+{
+    struct timespec now; // current monotonic time
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec * 1000000000ull + (unsigned long long)now.tv_nsec;
+}
+
+// add "nanoseconds" to timer "timer" of this thread
+void StatsTime(int timer, unsigned long long nanoseconds)
+{
+    StatsBlock* block = statsThread; // this thread's counters
+    unsigned long long calls = 0ull; // timed calls so far
+    unsigned long long total = 0ull; // nanoseconds so far
+
+    if (block == NULL) { block = StatsThreadBlock(); }
+    calls = atomic_load_explicit(&block->timerCalls[timer], memory_order_relaxed);
+    total = atomic_load_explicit(&block->timerNs[timer], memory_order_relaxed);
+    atomic_store_explicit(&block->timerCalls[timer], calls + 1ull, memory_order_relaxed);
+    atomic_store_explicit(&block->timerNs[timer], total + nanoseconds, memory_order_relaxed);
+    if (nanoseconds > atomic_load_explicit(&block->timerMaxNs[timer], memory_order_relaxed))
+    {
+        atomic_store_explicit(&block->timerMaxNs[timer], nanoseconds, memory_order_relaxed);
+    }
+}
+
+// method run by atexit, prints the summary to stderr and appends the JSON one to GAME_STATS_JSON
+static void DumpStats(void)
+{
+    const char* jsonName = getenv("GAME_STATS_JSON"); // JSON file, NULL for none
+
+    PrintStats(stderr, STATS_FORMAT_TEXT);
+    if (jsonName != NULL && jsonName[0] != '\0')
+    {
+        FILE* file = fopen(jsonName, "a"); // JSON lines file
+
+        if (file == NULL)
+        {
+            fprintf(stderr, "Could not write the stats to: %s\n", jsonName);
+            return;
+        }
+        PrintStats(file, STATS_FORMAT_JSON);
+        fclose(file);
+    }
+}
+
+#endif
+
+// returns 1 when the program was built with GAME_STATS, otherwise 0
+int StatsEnabled(void)
+{
+#ifdef GAME_STATS
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+// add up the counters of every thread into "totals" (all 0 without GAME_STATS)
+void StatsSnapshot(StatsTotals* totals)
+{
+    memset(totals, 0, sizeof(*totals));
+#ifdef GAME_STATS
+    {
+        StatsBlock* block = NULL; // loop iterator for the live blocks
+
+        pthread_mutex_lock(&statsLock);
+        *totals = statsEnded;
+        for (block = statsLive; block != NULL; block = block->next)
+        {
+            AddBlock(totals, block);
+            totals->threads++;
+        }
+        pthread_mutex_unlock(&statsLock);
+    }
+#endif
+}
+
+// set every counter and timer of every thread back to 0
+// note: the other threads' blocks are written here, so no other thread may be counting meanwhile
+void StatsReset(void)
+{
+#ifdef GAME_STATS
+    StatsBlock* block = NULL; // loop iterator for the live blocks
+    int i = 0; // loop iterator for the counters and timers
+
+    pthread_mutex_lock(&statsLock);
+    memset(&statsEnded, 0, sizeof(statsEnded));
+    for (block = statsLive; block != NULL; block = block->next)
+    {
+        for (i = 0; i < STAT_COUNTERS; i++) { atomic_store_explicit(&block->counts[i], 0ull, memory_order_relaxed); }
+        for (i = 0; i < STAT_TIMERS; i++)
+        {
+            atomic_store_explicit(&block->timerCalls[i], 0ull, memory_order_relaxed);
+            atomic_store_explicit(&block->timerNs[i], 0ull, memory_order_relaxed);
+            atomic_store_explicit(&block->timerMaxNs[i], 0ull, memory_order_relaxed);
+        }
+    }
+    pthread_mutex_unlock(&statsLock);
+#endif
+}
+
+// print the totals to "file" as text lines or one JSON object
+void PrintStats(FILE* file, int format)
+{
+    StatsTotals totals; // sums of every thread
+    int i = 0; // loop iterator for the counters and timers
+
+    // qualifier: nothing was counted in a build without GAME_STATS
+    if (!StatsEnabled())
+    {
+        if (format == STATS_FORMAT_JSON) { fprintf(file, "{\"enabled\":false}\n"); }
+        else { fprintf(file, "[Stats] not built in (rebuild with \"make clean\" and \"make STATS=1\")\n"); }
+        return;
+    }
+
+    StatsSnapshot(&totals);
+    if (format == STATS_FORMAT_JSON)
+    {
+        fprintf(file, "{\"enabled\":true,\"threads\":%d,\"counters\":{", totals.threads);
+        for (i = 0; i < STAT_COUNTERS; i++) { fprintf(file, "%s\"%s\":%llu", (i > 0) ? "," : "", counterNames[i][1], totals.counts[i]); }
+        fprintf(file, "},\"timers\":{");
+        for (i = 0; i < STAT_TIMERS; i++)
+        {
+            unsigned long long average = (totals.timerCalls[i] > 0ull) ? totals.timerNs[i] / totals.timerCalls[i] : 0ull; // mean call
+
+            fprintf(file, "%s\"%s\":{\"calls\":%llu,\"total_ns\":%llu,\"avg_ns\":%llu,\"max_ns\":%llu}", (i > 0) ? "," : "",
+                timerNames[i][1], totals.timerCalls[i], totals.timerNs[i], average, totals.timerMaxNs[i]);
+        }
+        fprintf(file, "}}\n");
+        return;
+    }
+
+    fprintf(file, "[Stats] %d thread(s)\n", totals.threads);
+    for (i = 0; i < STAT_COUNTERS; i++) { fprintf(file, "  %-24s %15llu\n", counterNames[i][0], totals.counts[i]); }
+    for (i = 0; i < STAT_TIMERS; i++)
+    {
+        unsigned long long average = (totals.timerCalls[i] > 0ull) ? totals.timerNs[i] / totals.timerCalls[i] : 0ull; // mean call
+
+        fprintf(file, "  %-24s %15llu calls  %12.3f ms total  %8llu ns avg  %10llu ns max\n", timerNames[i][0],
+            totals.timerCalls[i], (double)totals.timerNs[i] / 1e6, average, totals.timerMaxNs[i]);
+    }
+}
+
+// print the summary when the program exits, does nothing without GAME_STATS
+void StatsDumpOnExit(void)
+{
+#ifdef GAME_STATS
+    atexit(DumpStats);
+#endif
+}
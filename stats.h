@@ -0,0 +1,145 @@
+// [stats.h] header file
+// function declarations for "stats.c"
+// implemented in "game.c" / "movegen.c" / "main.c" / "engine.c"
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdio.h> // for FILE (PrintStats)
+
+// { Phase 4 - Instrumentation } //
+// counters and timers on the game core entry points, switched on at compile time
+
+/*
+    Built with "make STATS=1" (which defines GAME_STATS), the game core counts
+    how often its entry points run and times the ones a player waits for:
+
+        counters   TryMove calls and rejections, CheckLegalMoves scans,
+                   CheckWinner checks, GenerateMoves calls, moves made,
+                   pieces captured and men promoted
+        timers     TryMove and CheckLegalMoves: calls, total, average and
+                   slowest call in nanoseconds (monotonic clock)
+
+    Every thread counts into its own block. Blocks are aligned to and padded
+    out to STATS_CACHE_LINE bytes, so the search threads never share a cache
+    line. A thread's block is added to the totals when the thread ends,
+    PrintStats sums the live blocks and those totals. Each counter is
+    written only by its own thread (relaxed atomics, a plain load / add /
+    store), so reading them while the search runs is safe.
+
+    StatsReset is the one exception: it writes the blocks of other threads.
+    A thread counting at the same time can write its old value back over
+    the reset (its load / add / store is not one step), so only call it
+    while no other thread is counting, e.g. between searches.
+
+    Without GAME_STATS, the STAT_* macros below are empty: the game core
+    compiles to the same code as before and nothing is counted. PrintStats
+    then only reports that the counters are off.
+
+    On exit (StatsDumpOnExit) the text summary goes to stderr, and the JSON
+    summary is also appended to the file named by the GAME_STATS_JSON
+    environment variable when it is set. "engine" answers "stats" with the
+    JSON summary on demand.
+*/
+
+// counters, one per event
+#define STAT_TRY_MOVE_CALLS 0 // TryMove calls
+#define STAT_TRY_MOVE_REJECTED 1 // TryMove calls that found no legal move
+#define STAT_LEGALITY_SCANS 2 // CheckLegalMoves calls
+#define STAT_WINNER_CHECKS 3 // CheckWinner calls
+#define STAT_GENERATE_CALLS 4 // GenerateMoves calls (including the search)
+#define STAT_MOVES_MADE 5 // MakeMove calls (including the search)
+#define STAT_CAPTURES 6 // pieces captured by MakeMove
+#define STAT_PROMOTIONS 7 // men promoted by MakeMove
+#define STAT_COUNTERS 8 // number of counters
+
+// timers, one per timed entry point
+#define STAT_TIME_TRY_MOVE 0 // TryMove
+#define STAT_TIME_LEGAL_MOVES 1 // CheckLegalMoves
+#define STAT_TIMERS 2 // number of timers
+
+// JSON / text choice for PrintStats
+#define STATS_FORMAT_TEXT 0
+#define STATS_FORMAT_JSON 1
+
+// totals of every thread, filled by StatsSnapshot
+typedef struct
+{
+    unsigned long long counts[STAT_COUNTERS]; // STAT_* counters
+    unsigned long long timerCalls[STAT_TIMERS]; // timed calls
+    unsigned long long timerNs[STAT_TIMERS]; // nanoseconds spent in them
+    unsigned long long timerMaxNs[STAT_TIMERS]; // slowest call
+    int threads; // threads that counted anything (live and ended)
+} StatsTotals;
+
+#ifdef GAME_STATS
+
+#include <stdatomic.h> // for the per-thread counters
+
+// cache line size assumed for the per-thread blocks, in bytes
+#define STATS_CACHE_LINE 64
+
+// counters of one thread, see "stats.c"
+// aligned to a cache line, so its size is rounded up to whole cache lines as well
+typedef struct StatsBlock
+{
+    _Alignas(STATS_CACHE_LINE) _Atomic unsigned long long counts[STAT_COUNTERS]; // STAT_* counters
+    _Atomic unsigned long long timerCalls[STAT_TIMERS]; // timed calls
+    _Atomic unsigned long long timerNs[STAT_TIMERS]; // nanoseconds spent in them
+    _Atomic unsigned long long timerMaxNs[STAT_TIMERS]; // slowest call
+    struct StatsBlock* next; // next live block
+    struct StatsBlock* previous; // previous live block
+} StatsBlock;
+
+// this thread's block, NULL until it first counts something
+extern _Thread_local StatsBlock* statsThread;
+
+// create and register this thread's block (first use only)
+StatsBlock* StatsThreadBlock(void);
+
+// read the monotonic clock in nanoseconds
+unsigned long long StatsNow(void);
+
+// add "nanoseconds" to timer "timer" of this thread
+void StatsTime(int timer, unsigned long long nanoseconds);
+
+// add "amount" to counter "counter" of this thread, written only by this thread
+static inline void StatsAdd(int counter, unsigned long long amount)
+{
+    StatsBlock* block = statsThread; // this thread's counters
+    unsigned long long value = 0ull; // counter before the add
+
+    if (block == NULL) { block = StatsThreadBlock(); }
+    value = atomic_load_explicit(&block->counts[counter], memory_order_relaxed);
+    atomic_store_explicit(&block->counts[counter], value + amount, memory_order_relaxed);
+}
+
+#define STAT_ADD(counter, amount) StatsAdd((counter), (unsigned long long)(amount))
+#define STAT_TIMER_START(name) unsigned long long name = StatsNow()
+#define STAT_TIMER_STOP(timer, name) StatsTime((timer), StatsNow() - (name))
+
+#else
+
+#define STAT_ADD(counter, amount) ((void)0)
+#define STAT_TIMER_START(name) ((void)0)
+#define STAT_TIMER_STOP(timer, name) ((void)0)
+
+#endif
+
+// returns 1 when the program was built with GAME_STATS, otherwise 0
+int StatsEnabled(void);
+
+// add up the counters of every thread into "totals" (all 0 without GAME_STATS)
+void StatsSnapshot(StatsTotals* totals);
+
+// set every counter and timer of every thread back to 0
+// only while no other thread is counting (see above), a concurrent count may undo the reset
+void StatsReset(void);
+
+// print the totals to "file" as text lines (STATS_FORMAT_TEXT) or one JSON object (STATS_FORMAT_JSON)
+void PrintStats(FILE* file, int format);
+
+// print the summary when the program exits (see above), does nothing without GAME_STATS
+void StatsDumpOnExit(void);
+
+#endif
@@ -0,0 +1,904 @@
+// [tablebase.c] file
+
+#include <stdio.h> // for writing slice files and building file names
+#include <stdlib.h> // for malloc / free
+#include <string.h> // for memcmp / memset
+#include <stdatomic.h> // for the slice id counter
+#include <pthread.h> // for pthread_once (binomial table)
+
+#include "tablebase.h" // declare "tablebase" structures and methods
+#include "bitoperations.h" // PopCount64 / BitScanForward64 for the square sets
+#include "board32.h" // PackBoard / ExpandBoard (32-square layout)
+#include "movegen.h" // HasCapture / GenerateMoves / ApplyMove for positions with a capture
+
+// bytes before the block offset table
+#define TB_HEADER_BYTES 32
+
+// streams in each slice file: WDL blocks first, then DTW blocks
+#define TB_STREAMS 2
+
+// largest compressed block: a single literal costs 2 bytes and so does a run of 2, longer stretches cost less
+#define TB_MAX_PACKED (2 * TB_BLOCK_ENTRIES)
+
+// men may not stand on their own promotion row (square sets, bit n - 1 for square n)
+#define RED_MEN_SQUARES 0x0FFFFFFFu // squares 1-28
+#define BLACK_MEN_SQUARES 0xFFFFFFF0u // squares 5-32
+
+// identifies a slice file
+static const unsigned char tablebaseMagic[8] = { 'B', 'B', 'C', 'K', 'T', 'B', '0', '1' };
+
+// binomial[n][k] = number of ways to pick k of n squares, filled once by FillBinomials()
+static unsigned long long binomial[33][TB_MAX_PIECES + 1];
+static pthread_once_t binomialOnce = PTHREAD_ONCE_INIT;
+
+// next slice id, so a cached block can never be confused with one of a closed slice
+static _Atomic unsigned int nextSliceId = 1u;
+
+// no slot (end of a list or chain)
+#define CACHE_NONE -1
+
+// one block slot of a cache shard, its entries are in the shard's "values"
+typedef struct
+{
+    unsigned long long key; // slice id << 32 | block number (DTW blocks follow the WDL blocks), 0 for a free slot
+    int newer; // more recently used slot, CACHE_NONE for the newest
+    int older; // less recently used slot, CACHE_NONE for the oldest
+    int chain; // next slot in the same hash bucket, CACHE_NONE at the end
+} CacheSlot;
+
+// one independently locked part of the block cache
+typedef struct
+{
+    pthread_mutex_t lock; // guards every field below
+    CacheSlot* slots; // block slots
+    unsigned char* values; // TB_BLOCK_ENTRIES entries for each slot
+    int* buckets; // first slot of each hash bucket, CACHE_NONE if empty
+    int bucketMask; // buckets - 1 (a power of 2)
+    int slotCount; // slots in the shard
+    int newest; // most recently used slot
+    int oldest; // least recently used slot, replaced by the next miss
+    unsigned long long hits; // probes that found their block
+    unsigned long long misses; // probes that decompressed their block
+    unsigned long long used; // slots holding a block
+} CacheShard;
+
+// cache of decompressed blocks shared by every thread
+struct TablebaseCache
+{
+    CacheShard shards[TB_CACHE_SHARDS]; // parts picked by the hash of the block key
+};
+
+// method to fill the binomial table with Pascal's triangle
+static void FillBinomials(void)
+{
+    int n = 0; // loop iterator for the number of squares
+    int k = 0; // loop iterator for the number of pieces
+
+    for (n = 0; n <= 32; n++)
+    {
+        binomial[n][0] = 1ull;
+        for (k = 1; k <= TB_MAX_PIECES; k++)
+        {
+            binomial[n][k] = (n == 0) ? 0ull : binomial[n - 1][k - 1] + binomial[n - 1][k];
+        }
+    }
+}
+
+// method to make sure the binomial table is ready (safe from any thread)
+static void InitBinomials(void)
+{
+    pthread_once(&binomialOnce, FillBinomials);
+}
+
+// method to write "value" as 4 / 8 little-endian bytes
+static void Write32(unsigned char* bytes, unsigned int value)
+{
+    bytes[0] = (unsigned char)(value & 0xFFu);
+    bytes[1] = (unsigned char)((value >> 8) & 0xFFu);
+    bytes[2] = (unsigned char)((value >> 16) & 0xFFu);
+    bytes[3] = (unsigned char)((value >> 24) & 0xFFu);
+}
+static void Write64(unsigned char* bytes, unsigned long long value)
+{
+    Write32(bytes, (unsigned int)(value & 0xFFFFFFFFull));
+    Write32(bytes + 4, (unsigned int)(value >> 32));
+}
+
+// method to read 4 / 8 little-endian bytes
+static unsigned int Read32(const unsigned char* bytes)
+{
+    return (unsigned int)bytes[0] | ((unsigned int)bytes[1] << 8) | ((unsigned int)bytes[2] << 16)
+        | ((unsigned int)bytes[3] << 24);
+}
+static unsigned long long Read64(const unsigned char* bytes)
+{
+    return (unsigned long long)Read32(bytes) | ((unsigned long long)Read32(bytes + 4) << 32);
+}
+
+// Indexing //
+
+// method to number a set of squares (bits 0-31) by its combination rank
+// the k-th lowest square "s" adds binomial[s][k], which numbers every set of the same size 0, 1, 2, ...
+static unsigned long long RankSet(unsigned int squares)
+{
+    unsigned long long rank = 0ull; // rank built so far
+    unsigned long long rest = squares; // squares not yet counted
+    int k = 1; // position of the next square in the set
+
+    while (rest != 0ull)
+    {
+        rank = rank + binomial[PopLowestBit64(&rest)][k];
+        k++;
+    }
+    return rank;
+}
+
+// method to rebuild the set of "count" squares (below "limit") numbered "rank" by RankSet
+static unsigned int UnrankSet(unsigned long long rank, int count, int limit)
+{
+    unsigned int squares = 0u; // set being rebuilt
+    int square = limit - 1; // highest square still possible
+    int k = 0; // loop iterator for the pieces, highest square first
+
+    for (k = count; k >= 1; k--)
+    {
+        // the highest square is the largest one whose binomial still fits in the rank
+        while (binomial[square][k] > rank) { square--; }
+        rank = rank - binomial[square][k];
+        squares = squares | (1u << square);
+        square--;
+    }
+    return squares;
+}
+
+// method to renumber "squares" by their order among the "free" squares
+// (the k-th free square becomes bit k), so kings are ranked only over empty squares
+static unsigned int SqueezeSet(unsigned int squares, unsigned int free)
+{
+    unsigned int result = 0u; // squeezed set
+    unsigned long long rest = squares; // squares not yet moved
+
+    while (rest != 0ull)
+    {
+        int square = PopLowestBit64(&rest); // next square of the set
+        result = result | (1u << PopCount64(free & ((1u << square) - 1u)));
+    }
+    return result;
+}
+
+// method to undo SqueezeSet: bit k of "squeezed" becomes the k-th free square
+static unsigned int SpreadSet(unsigned int squeezed, unsigned int free)
+{
+    unsigned int result = 0u; // spread set
+    unsigned long long rest = free; // free squares not yet visited
+    unsigned int bit = 1u; // bit of "squeezed" for the next free square
+
+    while (rest != 0ull && squeezed != 0u)
+    {
+        int square = PopLowestBit64(&rest); // next free square
+        if ((squeezed & bit) != 0u)
+        {
+            result = result | (1u << square);
+            squeezed = squeezed & ~bit;
+        }
+        bit = bit << 1;
+    }
+    return result;
+}
+
+// method to find the number of combinations of every piece set of "material"
+// returns the entries for one side to move, 0 if "material" has no slice
+static unsigned long long HalfEntries(const TablebaseMaterial* material, unsigned long long* blackMenCount,
+    unsigned long long* redKingCount, unsigned long long* blackKingCount)
+{
+    int men = material->redMen + material->blackMen; // men on the board
+
+    InitBinomials();
+
+    // qualifier: both sides need a piece, and the slice must fit the limits
+    if (material->redMen < 0 || material->redKings < 0 || material->blackMen < 0 || material->blackKings < 0) { return 0ull; }
+    if (material->redMen + material->redKings == 0 || material->blackMen + material->blackKings == 0) { return 0ull; }
+    if (men + material->redKings + material->blackKings > TB_MAX_PIECES) { return 0ull; }
+
+    *blackMenCount = binomial[28][material->blackMen];
+    *redKingCount = binomial[32 - men][material->redKings];
+    *blackKingCount = binomial[32 - men - material->redKings][material->blackKings];
+    return binomial[28][material->redMen] * *blackMenCount * *redKingCount * *blackKingCount;
+}
+
+// fill "material" with the piece counts of "game"
+void TablebaseMaterialOf(const GameState* game, TablebaseMaterial* material)
+{
+    material->redMen = PopCount64(game->player1_men);
+    material->redKings = PopCount64(game->player1_kings);
+    material->blackMen = PopCount64(game->player2_men);
+    material->blackKings = PopCount64(game->player2_kings);
+}
+
+// number of entries in the slice of "material" (both sides to move), 0 if it has no slice
+unsigned long long TablebaseSliceEntries(const TablebaseMaterial* material)
+{
+    unsigned long long blackMenCount = 0ull, redKingCount = 0ull, blackKingCount = 0ull; // unused here
+
+    return 2ull * HalfEntries(material, &blackMenCount, &redKingCount, &blackKingCount);
+}
+
+// index of "game" inside the slice of its own material
+// returns 1 on success, 0 if "game" has no slice or a man stands on its promotion row
+int TablebaseIndex(const GameState* game, unsigned long long* index)
+{
+    TablebaseMaterial material; // piece counts, pick the slice
+    PackedBoard packed; // 32-square layout
+    unsigned long long half = 0ull; // entries for one side to move
+    unsigned long long blackMenCount = 0ull, redKingCount = 0ull, blackKingCount = 0ull; // combinations per set
+    unsigned int redMen = 0u, blackMen = 0u, redKings = 0u, blackKings = 0u; // square sets
+    unsigned int free = 0u; // squares not taken by men
+
+    TablebaseMaterialOf(game, &material);
+    half = HalfEntries(&material, &blackMenCount, &redKingCount, &blackKingCount);
+    if (half == 0ull) { return 0; }
+
+    PackBoard(game, &packed);
+    redMen = packed.red & ~packed.kings;
+    redKings = packed.red & packed.kings;
+    blackMen = packed.black & ~packed.kings;
+    blackKings = packed.black & packed.kings;
+
+    // qualifier: men on their promotion row (or a bad turn) have no index
+    if ((redMen & ~RED_MEN_SQUARES) != 0u || (blackMen & ~BLACK_MEN_SQUARES) != 0u) { return 0; }
+    if (game->current_turn != 1 && game->current_turn != 2) { return 0; }
+
+    free = ~(redMen | blackMen);
+    *index = (RankSet(redMen) * blackMenCount + RankSet(blackMen >> 4)) * redKingCount;
+    *index = (*index + RankSet(SqueezeSet(redKings, free))) * blackKingCount;
+    *index = *index + RankSet(SqueezeSet(blackKings, free & ~redKings));
+    *index = *index + half * (unsigned long long)(game->current_turn - 1);
+    return 1;
+}
+
+// rebuild the position numbered "index" in the slice of "material" ("zobrist_key" is not set)
+// returns 1 on success, 0 if "index" is out of range or is not a position (men on one square)
+int TablebasePosition(const TablebaseMaterial* material, unsigned long long index, GameState* game)
+{
+    unsigned long long blackMenCount = 0ull, redKingCount = 0ull, blackKingCount = 0ull; // combinations per set
+    unsigned long long half = HalfEntries(material, &blackMenCount, &redKingCount, &blackKingCount);
+    unsigned int redMen = 0u, blackMen = 0u, redKings = 0u, blackKings = 0u; // square sets
+    unsigned int free = 0u; // squares not taken by men
+    int men = material->redMen + material->blackMen; // men on the board
+    int turn = 1; // player to move
+
+    // qualifier: the index has to be inside the slice
+    if (half == 0ull || index >= 2ull * half) { return 0; }
+    if (index >= half)
+    {
+        turn = 2;
+        index = index - half;
+    }
+
+    // split the index back into the rank of each set, last set first
+    blackKings = UnrankSet(index % blackKingCount, material->blackKings, 32 - men - material->redKings);
+    index = index / blackKingCount;
+    redKings = UnrankSet(index % redKingCount, material->redKings, 32 - men);
+    index = index / redKingCount;
+    blackMen = UnrankSet(index % blackMenCount, material->blackMen, 28) << 4;
+    redMen = UnrankSet(index / blackMenCount, material->redMen, 28);
+
+    // qualifier: index numbers with a Red and a Black man on one square are not positions
+    if ((redMen & blackMen) != 0u) { return 0; }
+
+    free = ~(redMen | blackMen);
+    redKings = SpreadSet(redKings, free);
+    blackKings = SpreadSet(blackKings, free & ~redKings);
+
+    game->player1_men = ExpandBoard(redMen);
+    game->player1_kings = ExpandBoard(redKings);
+    game->player2_men = ExpandBoard(blackMen);
+    game->player2_kings = ExpandBoard(blackKings);
+    game->current_turn = turn;
+    game->zobrist_key = 0ull;
+    memset(game->eval_terms, 0, sizeof(game->eval_terms));
+    return 1;
+}
+
+// write the file name of the slice of "material" into "buffer" (Example: "tb_2011.cktb")
+void TablebaseFileName(const TablebaseMaterial* material, char* buffer, int size)
+{
+    snprintf(buffer, (size_t)size, "tb_%d%d%d%d.cktb", material->redMen, material->redKings,
+        material->blackMen, material->blackKings);
+}
+
+// Entry Values //
+
+// turn an entry byte into a result for the player to move
+void TablebaseDecode(unsigned char value, TablebaseResult* result)
+{
+    if (value == 0u)
+    {
+        result->outcome = TB_DRAW;
+        result->plies = 0;
+    }
+    else if (value < 128u)
+    {
+        result->outcome = TB_WIN;
+        result->plies = value;
+    }
+    else
+    {
+        result->outcome = TB_LOSS;
+        result->plies = value - 128;
+    }
+}
+
+// Block Compression //
+
+// method to compress "count" entry bytes into "packed", returns the compressed size
+// control byte 0-127: that many + 1 literal bytes follow
+// control byte 128-255: the next byte repeats (control - 128 + 2) times
+static size_t PackBlock(const unsigned char* values, size_t count, unsigned char* packed)
+{
+    size_t size = 0; // bytes written to "packed"
+    size_t literalStart = 0; // first byte of the pending literal stretch
+    size_t literals = 0; // bytes in the pending literal stretch
+    size_t i = 0; // next byte to encode
+
+    while (i < count)
+    {
+        size_t run = 1; // equal bytes starting at "i"
+
+        while (i + run < count && values[i + run] == values[i] && run < 129) { run++; }
+
+        // qualifier: a run of 2 or more is stored as one pair, otherwise the byte joins the literals
+        if (run >= 2 || literals == 128)
+        {
+            if (literals > 0)
+            {
+                packed[size++] = (unsigned char)(literals - 1);
+                memcpy(packed + size, values + literalStart, literals);
+                size = size + literals;
+                literals = 0;
+            }
+        }
+        if (run >= 2)
+        {
+            packed[size++] = (unsigned char)(128 + run - 2);
+            packed[size++] = values[i];
+            i = i + run;
+        }
+        else
+        {
+            if (literals == 0) { literalStart = i; }
+            literals++;
+            i++;
+        }
+    }
+
+    // the last literal stretch
+    if (literals > 0)
+    {
+        packed[size++] = (unsigned char)(literals - 1);
+        memcpy(packed + size, values + literalStart, literals);
+        size = size + literals;
+    }
+    return size;
+}
+
+// method to decompress one block made by PackBlock into exactly "count" bytes
+// returns 1 on success, 0 if the block is damaged
+static int UnpackBlock(const unsigned char* packed, size_t size, unsigned char* values, size_t count)
+{
+    size_t in = 0; // next compressed byte
+    size_t out = 0; // bytes produced
+
+    while (in < size)
+    {
+        unsigned int control = packed[in++]; // literal or run marker
+
+        if (control < 128u)
+        {
+            size_t length = (size_t)control + 1; // literal bytes that follow
+            if (in + length > size || out + length > count) { return 0; }
+            memcpy(values + out, packed + in, length);
+            in = in + length;
+            out = out + length;
+        }
+        else
+        {
+            size_t length = (size_t)control - 128 + 2; // copies of the next byte
+            if (in >= size || out + length > count) { return 0; }
+            memset(values + out, packed[in++], length);
+            out = out + length;
+        }
+    }
+    return out == count;
+}
+
+// Block Cache //
+
+// method to decompress block "block" of the file (entry block "block % slice->blocks") into "values"
+// returns 1 on success, 0 if the block is damaged
+static int LoadBlock(const TablebaseSlice* slice, unsigned int block, unsigned char* values)
+{
+    const unsigned char* offsets = slice->map.data + TB_HEADER_BYTES + 8ull * block; // offsets of this block
+    unsigned long long start = Read64(offsets); // first compressed byte
+    unsigned long long end = Read64(offsets + 8); // one past the last compressed byte
+    unsigned long long first = (unsigned long long)(block % slice->blocks) * TB_BLOCK_ENTRIES; // first entry of the block
+    size_t count = (size_t)((slice->entries - first < TB_BLOCK_ENTRIES) ? slice->entries - first : TB_BLOCK_ENTRIES);
+
+    if (start > end || end > slice->map.size) { return 0; }
+    return UnpackBlock(slice->map.data + start, (size_t)(end - start), values, count);
+}
+
+// method to mix a block key into a hash, the top bits pick the shard and the rest the bucket
+static unsigned long long HashBlockKey(unsigned long long key)
+{
+    key = key * 0x9E3779B97F4A7C15ull;
+    return key ^ (key >> 29);
+}
+
+// method to find the slot holding "key" in "shard" (lock held), CACHE_NONE if it is not cached
+static int FindSlot(const CacheShard* shard, unsigned long long key, unsigned long long hash)
+{
+    int slot = shard->buckets[hash & (unsigned long long)shard->bucketMask]; // first slot of the bucket
+
+    while (slot != CACHE_NONE && shard->slots[slot].key != key) { slot = shard->slots[slot].chain; }
+    return slot;
+}
+
+// method to move "slot" to the newest end of the shard's list (lock held)
+static void TouchSlot(CacheShard* shard, int slot)
+{
+    CacheSlot* entry = &shard->slots[slot]; // the slot being moved
+
+    if (shard->newest == slot) { return; }
+
+    // unlink it, it is not the newest so it has a newer neighbour
+    shard->slots[entry->newer].older = entry->older;
+    if (entry->older != CACHE_NONE) { shard->slots[entry->older].newer = entry->newer; }
+    else { shard->oldest = entry->newer; }
+
+    // and put it in front
+    entry->older = shard->newest;
+    entry->newer = CACHE_NONE;
+    shard->slots[shard->newest].newer = slot;
+    shard->newest = slot;
+}
+
+// method to put the block "values" under "key" into the least recently used slot of "shard" (lock held)
+static void ReplaceOldest(CacheShard* shard, unsigned long long key, unsigned long long hash, const unsigned char* values)
+{
+    int slot = shard->oldest; // slot given to the new block
+    CacheSlot* entry = &shard->slots[slot]; // its bookkeeping
+
+    // qualifier: an occupied slot first leaves its hash chain
+    if (entry->key != 0ull)
+    {
+        int* link = &shard->buckets[HashBlockKey(entry->key) & (unsigned long long)shard->bucketMask]; // link pointing at the slot
+
+        while (*link != slot) { link = &shard->slots[*link].chain; }
+        *link = entry->chain;
+    }
+    else { shard->used++; }
+
+    entry->key = key;
+    entry->chain = shard->buckets[hash & (unsigned long long)shard->bucketMask];
+    shard->buckets[hash & (unsigned long long)shard->bucketMask] = slot;
+    memcpy(shard->values + (size_t)slot * TB_BLOCK_ENTRIES, values, TB_BLOCK_ENTRIES);
+    TouchSlot(shard, slot);
+}
+
+// method to read entry "index" of a slice from the WDL stream ("stream" 0) or the DTW stream ("stream" 1)
+// returns 1 and sets "value" on success, 0 if the block is damaged
+static int ReadEntry(const Tablebase* tablebase, const TablebaseSlice* slice, int stream, unsigned long long index,
+    unsigned char* value)
+{
+    unsigned int block = (unsigned int)stream * slice->blocks + (unsigned int)(index / TB_BLOCK_ENTRIES); // block in the file
+    unsigned long long key = ((unsigned long long)slice->id << 32) | block; // cache key of the block
+    unsigned long long hash = HashBlockKey(key); // picks the shard and bucket
+    unsigned char values[TB_BLOCK_ENTRIES]; // block decompressed on a miss
+    CacheShard* shard = NULL; // shard holding the block
+    int slot = CACHE_NONE; // slot of the block
+
+    // qualifier: without a cache every probe decompresses its block
+    if (tablebase->cache == NULL)
+    {
+        if (!LoadBlock(slice, block, values)) { return 0; }
+        *value = values[index % TB_BLOCK_ENTRIES];
+        return 1;
+    }
+
+    // a hit reads the entry straight from the cache
+    shard = &tablebase->cache->shards[(hash >> 56) % TB_CACHE_SHARDS];
+    pthread_mutex_lock(&shard->lock);
+    slot = FindSlot(shard, key, hash);
+    if (slot != CACHE_NONE)
+    {
+        shard->hits++;
+        TouchSlot(shard, slot);
+        *value = shard->values[(size_t)slot * TB_BLOCK_ENTRIES + index % TB_BLOCK_ENTRIES];
+        pthread_mutex_unlock(&shard->lock);
+        return 1;
+    }
+    shard->misses++;
+    pthread_mutex_unlock(&shard->lock);
+
+    // a miss decompresses without the lock, so other threads keep probing the shard meanwhile
+    if (!LoadBlock(slice, block, values)) { return 0; }
+    *value = values[index % TB_BLOCK_ENTRIES];
+
+    // qualifier: another thread may have cached the same block in the meantime
+    pthread_mutex_lock(&shard->lock);
+    if (FindSlot(shard, key, hash) == CACHE_NONE) { ReplaceOldest(shard, key, hash, values); }
+    pthread_mutex_unlock(&shard->lock);
+    return 1;
+}
+
+// method to release the memory of a block cache
+static void FreeCache(TablebaseCache* cache)
+{
+    int i = 0; // loop iterator for the shards
+
+    for (i = 0; i < TB_CACHE_SHARDS; i++)
+    {
+        if (cache->shards[i].slots != NULL) { pthread_mutex_destroy(&cache->shards[i].lock); }
+        free(cache->shards[i].slots);
+        free(cache->shards[i].values);
+        free(cache->shards[i].buckets);
+    }
+    free(cache);
+}
+
+// method to create a block cache of about "megabytes" MB
+// returns the cache, or NULL if "megabytes" is 0 or the memory could not be allocated
+static TablebaseCache* CreateCache(size_t megabytes)
+{
+    size_t slotBytes = TB_BLOCK_ENTRIES + sizeof(CacheSlot) + 2 * sizeof(int); // memory per slot, with its buckets
+    size_t slotCount = megabytes * 1024u * 1024u / slotBytes / TB_CACHE_SHARDS; // slots in each shard
+    TablebaseCache* cache = NULL; // the new cache
+    int i = 0; // loop iterator for the shards
+
+    if (megabytes == 0u) { return NULL; }
+    if (slotCount < 1u) { slotCount = 1u; }
+    if (slotCount > 0x10000000u) { slotCount = 0x10000000u; }
+
+    cache = (TablebaseCache*)calloc(1, sizeof(TablebaseCache));
+    if (cache == NULL) { return NULL; }
+
+    for (i = 0; i < TB_CACHE_SHARDS; i++)
+    {
+        CacheShard* shard = &cache->shards[i]; // shard being set up
+        int buckets = 1; // hash buckets, the first power of 2 at or above the slot count
+        int slot = 0; // loop iterator for the slots
+
+        while ((size_t)buckets < slotCount) { buckets = buckets * 2; }
+        shard->slots = (CacheSlot*)malloc(slotCount * sizeof(CacheSlot));
+        shard->values = (unsigned char*)malloc(slotCount * TB_BLOCK_ENTRIES);
+        shard->buckets = (int*)malloc((size_t)buckets * sizeof(int));
+        if (shard->slots == NULL || shard->values == NULL || shard->buckets == NULL || pthread_mutex_init(&shard->lock, NULL) != 0)
+        {
+            free(shard->slots);
+            shard->slots = NULL;
+            FreeCache(cache);
+            return NULL;
+        }
+
+        // every slot starts free, linked oldest (last) to newest (first)
+        for (slot = 0; slot < (int)slotCount; slot++)
+        {
+            shard->slots[slot].key = 0ull;
+            shard->slots[slot].newer = slot - 1;
+            shard->slots[slot].older = (slot + 1 < (int)slotCount) ? slot + 1 : CACHE_NONE;
+            shard->slots[slot].chain = CACHE_NONE;
+        }
+        for (slot = 0; slot < buckets; slot++) { shard->buckets[slot] = CACHE_NONE; }
+        shard->bucketMask = buckets - 1;
+        shard->slotCount = (int)slotCount;
+        shard->newest = 0;
+        shard->oldest = (int)slotCount - 1;
+    }
+    return cache;
+}
+
+// read the block cache counters of "tablebase" into "stats" (all 0 without a cache)
+void TablebaseCacheCounters(const Tablebase* tablebase, TablebaseCacheStats* stats)
+{
+    int i = 0; // loop iterator for the shards
+
+    memset(stats, 0, sizeof(TablebaseCacheStats));
+    if (tablebase->cache == NULL) { return; }
+
+    for (i = 0; i < TB_CACHE_SHARDS; i++)
+    {
+        CacheShard* shard = &tablebase->cache->shards[i]; // shard being counted
+
+        pthread_mutex_lock(&shard->lock);
+        stats->hits = stats->hits + shard->hits;
+        stats->misses = stats->misses + shard->misses;
+        stats->blocks = stats->blocks + (unsigned long long)shard->slotCount;
+        stats->used = stats->used + shard->used;
+        pthread_mutex_unlock(&shard->lock);
+    }
+}
+
+// set the hit and miss counters of "tablebase" back to 0 (the cached blocks stay)
+void ResetTablebaseCacheCounters(Tablebase* tablebase)
+{
+    int i = 0; // loop iterator for the shards
+
+    if (tablebase->cache == NULL) { return; }
+    for (i = 0; i < TB_CACHE_SHARDS; i++)
+    {
+        CacheShard* shard = &tablebase->cache->shards[i]; // shard being reset
+
+        pthread_mutex_lock(&shard->lock);
+        shard->hits = 0ull;
+        shard->misses = 0ull;
+        pthread_mutex_unlock(&shard->lock);
+    }
+}
+
+// Files //
+
+// method to fill the "don't care" entries of one WDL block with their neighbour, so they join its run
+// "wdl" holds "count" entries, "filled" receives them with TB_WDL_ANY replaced
+static void FillWdlBlock(const unsigned char* wdl, size_t count, unsigned char* filled)
+{
+    unsigned char previous = TB_WDL_DRAW; // last entry that was not "don't care"
+    size_t i = 0; // loop iterator for the entries
+
+    // qualifier: leading "don't care" entries join the first real run of the block
+    for (i = 0; i < count; i++)
+    {
+        if (wdl[i] != TB_WDL_ANY)
+        {
+            previous = wdl[i];
+            break;
+        }
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        if (wdl[i] != TB_WDL_ANY) { previous = wdl[i]; }
+        filled[i] = previous;
+    }
+}
+
+// write one slice file "filename" from the DTW stream "values" and the WDL stream "wdl" ("entries" of each)
+// returns 1 on success, 0 if the file could not be written completely
+int WriteTablebaseSlice(const char* filename, const TablebaseMaterial* material,
+    const unsigned char* values, const unsigned char* wdl, unsigned long long entries)
+{
+    unsigned int blocks = (unsigned int)((entries + TB_BLOCK_ENTRIES - 1) / TB_BLOCK_ENTRIES); // blocks in each stream
+    unsigned int streamBlocks = TB_STREAMS * blocks; // blocks in the file
+    unsigned long long* offsets = (unsigned long long*)malloc(((size_t)streamBlocks + 1) * sizeof(unsigned long long));
+    unsigned char header[TB_HEADER_BYTES] = { 0 }; // file header
+    unsigned char filled[TB_BLOCK_ENTRIES]; // one WDL block with its "don't care" entries filled
+    unsigned char packed[TB_MAX_PACKED]; // one compressed block
+    unsigned char bytes[8]; // one encoded offset
+    unsigned long long position = 0ull; // file offset of the next block
+    unsigned int block = 0u; // loop iterator for the blocks
+    int ok = 1; // flagger for every write succeeding
+    FILE* file = NULL; // slice file
+
+    if (offsets == NULL) { return 0; }
+    file = fopen(filename, "wb");
+    if (file == NULL)
+    {
+        free(offsets);
+        return 0;
+    }
+
+    memcpy(header, tablebaseMagic, sizeof(tablebaseMagic));
+    header[8] = (unsigned char)material->redMen;
+    header[9] = (unsigned char)material->redKings;
+    header[10] = (unsigned char)material->blackMen;
+    header[11] = (unsigned char)material->blackKings;
+    Write32(header + 12, TB_BLOCK_ENTRIES);
+    Write64(header + 16, entries);
+    Write32(header + 24, blocks);
+    Write32(header + 28, TB_STREAMS);
+    ok = fwrite(header, 1, sizeof(header), file) == sizeof(header);
+
+    // reserve the offset table, it is filled in once every block has been written
+    memset(bytes, 0, sizeof(bytes));
+    for (block = 0u; ok && block <= streamBlocks; block++) { ok = fwrite(bytes, 1, 8, file) == 8; }
+    position = TB_HEADER_BYTES + 8ull * ((unsigned long long)streamBlocks + 1ull);
+
+    // compress and write the blocks one at a time, the WDL stream then the DTW stream
+    for (block = 0u; ok && block < streamBlocks; block++)
+    {
+        unsigned long long first = (unsigned long long)(block % blocks) * TB_BLOCK_ENTRIES; // first entry of the block
+        size_t count = (size_t)((entries - first < TB_BLOCK_ENTRIES) ? entries - first : TB_BLOCK_ENTRIES);
+        size_t size = 0; // compressed bytes
+
+        if (block < blocks)
+        {
+            FillWdlBlock(wdl + first, count, filled);
+            size = PackBlock(filled, count, packed);
+        }
+        else { size = PackBlock(values + first, count, packed); }
+
+        offsets[block] = position;
+        ok = fwrite(packed, 1, size, file) == size;
+        position = position + size;
+    }
+    offsets[streamBlocks] = position;
+
+    // go back and fill in the offset table
+    if (ok) { ok = fseek(file, TB_HEADER_BYTES, SEEK_SET) == 0; }
+    for (block = 0u; ok && block <= streamBlocks; block++)
+    {
+        Write64(bytes, offsets[block]);
+        ok = fwrite(bytes, 1, 8, file) == 8;
+    }
+
+    free(offsets);
+    if (fclose(file) != 0) { ok = 0; }
+    if (!ok) { remove(filename); }
+    return ok;
+}
+
+// open the one slice of "material" from "folder" into "tablebase" (used while generating)
+// returns 1 if it was opened (or was already open), 0 if the file is missing or invalid
+int OpenTablebaseSlice(const char* folder, const TablebaseMaterial* material, Tablebase* tablebase)
+{
+    char name[32]; // slice file name
+    char path[4096]; // folder and file name
+    TablebaseSlice* slice = NULL; // the new slice
+    unsigned long long entries = TablebaseSliceEntries(material); // expected entries
+    unsigned long long blocks = (entries + TB_BLOCK_ENTRIES - 1) / TB_BLOCK_ENTRIES; // expected blocks in each stream
+    unsigned long long streamBlocks = TB_STREAMS * blocks; // expected blocks in the file
+    const unsigned char* data = NULL; // mapped file
+    int pieces = material->redMen + material->redKings + material->blackMen + material->blackKings;
+
+    if (entries == 0ull) { return 0; }
+    if (tablebase->slices[material->redMen][material->redKings][material->blackMen][material->blackKings] != NULL) { return 1; }
+
+    TablebaseFileName(material, name, sizeof(name));
+    snprintf(path, sizeof(path), "%s/%s", folder, name);
+
+    slice = (TablebaseSlice*)malloc(sizeof(TablebaseSlice));
+    if (slice == NULL) { return 0; }
+    if (!MapFile(path, &slice->map))
+    {
+        free(slice);
+        return 0;
+    }
+
+    // qualifier: the header must describe exactly this slice, and the offset table must fit
+    data = slice->map.data;
+    if (slice->map.size < TB_HEADER_BYTES + 8ull * (streamBlocks + 1ull) || memcmp(data, tablebaseMagic, 8) != 0
+        || data[8] != material->redMen || data[9] != material->redKings || data[10] != material->blackMen
+        || data[11] != material->blackKings || Read32(data + 12) != TB_BLOCK_ENTRIES || Read64(data + 16) != entries
+        || Read32(data + 24) != blocks || Read32(data + 28) != TB_STREAMS
+        || Read64(data + TB_HEADER_BYTES + 8ull * streamBlocks) > slice->map.size)
+    {
+        fprintf(stderr, "Invalid tablebase file, ignored: %s\n", path);
+        UnmapFile(&slice->map);
+        free(slice);
+        return 0;
+    }
+
+    AdviseRandomAccess(&slice->map);
+    slice->entries = entries;
+    slice->blocks = (unsigned int)blocks;
+    slice->id = atomic_fetch_add(&nextSliceId, 1u);
+    tablebase->slices[material->redMen][material->redKings][material->blackMen][material->blackKings] = slice;
+    tablebase->sliceCount++;
+    if (pieces > tablebase->maxPieces) { tablebase->maxPieces = pieces; }
+    return 1;
+}
+
+// open every slice file found in "folder" (slices missing from the folder are simply absent)
+// returns the number of slices opened
+int OpenTablebase(const char* folder, size_t cacheMegabytes, Tablebase* tablebase)
+{
+    TablebaseMaterial material; // slice being looked for
+
+    memset(tablebase, 0, sizeof(Tablebase));
+    tablebase->cache = CreateCache(cacheMegabytes);
+    for (material.redMen = 0; material.redMen <= TB_MAX_PIECES; material.redMen++)
+    {
+        for (material.redKings = 0; material.redKings <= TB_MAX_PIECES; material.redKings++)
+        {
+            for (material.blackMen = 0; material.blackMen <= TB_MAX_PIECES; material.blackMen++)
+            {
+                for (material.blackKings = 0; material.blackKings <= TB_MAX_PIECES; material.blackKings++)
+                {
+                    // qualifier: only counts that form a slice have a file
+                    if (TablebaseSliceEntries(&material) > 0ull) { OpenTablebaseSlice(folder, &material, tablebase); }
+                }
+            }
+        }
+    }
+    return tablebase->sliceCount;
+}
+
+// close every slice of "tablebase" and release its block cache
+void CloseTablebase(Tablebase* tablebase)
+{
+    TablebaseSlice** slices = &tablebase->slices[0][0][0][0]; // every slot, in one flat run
+    int count = (TB_MAX_PIECES + 1) * (TB_MAX_PIECES + 1) * (TB_MAX_PIECES + 1) * (TB_MAX_PIECES + 1);
+    int i = 0; // loop iterator for the slots
+
+    for (i = 0; i < count; i++)
+    {
+        if (slices[i] != NULL)
+        {
+            UnmapFile(&slices[i]->map);
+            free(slices[i]);
+            slices[i] = NULL;
+        }
+    }
+    tablebase->sliceCount = 0;
+    tablebase->maxPieces = 0;
+
+    if (tablebase->cache != NULL) { FreeCache(tablebase->cache); }
+    tablebase->cache = NULL;
+}
+
+// method to find the slice and entry of "game"
+// returns the open slice holding it, or NULL if there is none
+static const TablebaseSlice* FindEntry(const Tablebase* tablebase, const GameState* game, unsigned long long* index)
+{
+    TablebaseMaterial material; // piece counts, pick the slice
+    const TablebaseSlice* slice = NULL; // slice holding the position
+
+    TablebaseMaterialOf(game, &material);
+
+    // qualifier: the position must be inside an open slice
+    if (material.redMen + material.redKings + material.blackMen + material.blackKings > tablebase->maxPieces) { return NULL; }
+    slice = tablebase->slices[material.redMen][material.redKings][material.blackMen][material.blackKings];
+    if (slice == NULL || !TablebaseIndex(game, index)) { return NULL; }
+    return slice;
+}
+
+// look "game" up in "tablebase" (DTW stream: result and distance)
+// returns 1 and fills "result" when the position's slice is open, otherwise 0
+int ProbeTablebase(const Tablebase* tablebase, const GameState* game, TablebaseResult* result)
+{
+    unsigned long long index = 0ull; // entry of the position
+    const TablebaseSlice* slice = FindEntry(tablebase, game, &index); // slice holding the position
+    unsigned char value = 0u; // entry byte
+
+    if (slice == NULL || !ReadEntry(tablebase, slice, 1, index, &value)) { return 0; }
+    TablebaseDecode(value, result);
+    return 1;
+}
+
+// look "game" up in "tablebase" (WDL stream: result only)
+// returns 1 and sets "outcome" when every slice needed is open, otherwise 0
+int ProbeTablebaseWdl(const Tablebase* tablebase, const GameState* game, int* outcome)
+{
+    unsigned long long index = 0ull; // entry of the position
+    const TablebaseSlice* slice = FindEntry(tablebase, game, &index); // slice holding the position
+    unsigned char value = 0u; // entry byte
+
+    if (slice == NULL) { return 0; }
+
+    // qualifier: capture positions are "don't care" entries, their result is the best capture
+    // (every capture leaves a smaller slice, so this always ends)
+    if (HasCapture(game))
+    {
+        MoveList list; // the captures
+        int best = TB_LOSS; // best result found for the player to move
+        int i = 0; // loop iterator for the captures
+
+        GenerateMoves(game, &list);
+        for (i = 0; i < list.count && best != TB_WIN; i++)
+        {
+            GameState child = *game; // position after the capture
+            int childOutcome = TB_DRAW; // result for the opponent
+
+            ApplyMove(&child, &list.moves[i]);
+            if (CheckWinner(&child) != 0) { childOutcome = TB_LOSS; }
+            else if (!ProbeTablebaseWdl(tablebase, &child, &childOutcome)) { return 0; }
+            if (-childOutcome > best) { best = -childOutcome; }
+        }
+        *outcome = best;
+        return 1;
+    }
+
+    if (!ReadEntry(tablebase, slice, 0, index, &value)) { return 0; }
+    *outcome = (value == TB_WDL_WIN) ? TB_WIN : ((value == TB_WDL_LOSS) ? TB_LOSS : TB_DRAW);
+    return 1;
+}
@@ -0,0 +1,211 @@
+// [tablebase.h] header file
+// function declarations for "tablebase.c"
+// implemented in "tbgen.c" / "search.c" / "main.c"
+
+#ifndef TABLEBASE_H
+#define TABLEBASE_H
+
+#include <stddef.h> // for size_t (cache size)
+
+#include "game.h" // implement GameState structure
+#include "mapfile.h" // implement MappedFile structure
+
+// { Phase 4 - Endgame Tablebase } //
+// exact results for every position with few pieces, read from files made by "tbgen"
+
+/*
+    A tablebase is a folder with one file per "slice": every position with
+    the same number of Red men, Red kings, Black men and Black kings. The
+    file "tb_2011.cktb" holds 2 Red men, 0 Red kings, 1 Black man, 1 Black king.
+
+    Positions are numbered by a perfect index (combinations of squares, in
+    the 32-square numbering of "board32.h"):
+
+        Red men      on squares 1-28 (square 29-32 would have promoted)
+        Black men    on squares 5-32 (square 1-4 would have promoted)
+        Red kings    on the squares left free by the men
+        Black kings  on the squares left free by the men and Red kings
+
+        index = half * (turn - 1) + ((redMen * B + blackMen) * K + redKings) * L + blackKings
+
+    where each piece set is numbered by its combination rank, and B, K and L
+    are the number of combinations of the next set. Index numbers where a
+    Red man and a Black man share a square are not positions and read as draws.
+
+    Each slice stores two streams with one byte per entry, for the player
+    to move with best play:
+
+        WDL stream (probed by the search)
+            0  draw    1  win    2  loss
+            positions where the player to move has a capture, and index
+            numbers that are not positions, are "don't care" entries: they
+            copy their neighbour so the runs stay long, and the probe works
+            captures out again from the smaller slices they lead into
+
+        DTW stream (distance to win, exact for every position)
+            0          draw (neither side can force a win)
+            1 - 127    win in that many plies (127 means 127 or more)
+            128 - 255  loss in (value - 128) plies (128 means blocked or no pieces)
+
+    Each stream is cut into blocks of TB_BLOCK_ENTRIES entries, each block
+    compressed on its own (runs of equal bytes and literal stretches), so
+    one entry is found by decompressing a single block. A file starts with a
+    32-byte header and a table of block offsets:
+
+        0   8 bytes  "BBCKTB01"
+        8   4 bytes  Red men, Red kings, Black men, Black kings
+        12  4 bytes  entries per block
+        16  8 bytes  number of entries
+        24  4 bytes  number of blocks in each stream
+        28  4 bytes  number of streams (2)
+        32  (2 * blocks + 1) 8-byte file offsets: the WDL blocks, then the
+            DTW blocks, block "b" is [offset b, offset b + 1)
+
+    Numbers are little-endian. Files are mapped into memory (see "mapfile.h"),
+    so opening a tablebase reads nothing until a position is probed.
+
+    Probing: decompressed blocks are kept in a block cache shared by every
+    thread, its size given to OpenTablebase. The cache is split into
+    TB_CACHE_SHARDS shards, each with its own lock and its own least
+    recently used list, so threads probing different blocks rarely wait for
+    each other. A probe that finds its block (a hit) costs one hash lookup
+    and an uncontended lock; a miss decompresses the block from the mapped
+    file (no system call, at most a page fault the first time) outside the
+    lock and then replaces the least recently used block of that shard.
+*/
+
+// most pieces (both sides together) in any slice
+#define TB_MAX_PIECES 8
+
+// entries in each compressed block
+#define TB_BLOCK_ENTRIES 4096
+
+// block cache: independently locked parts, and the default size in MB
+#define TB_CACHE_SHARDS 16
+#define TB_DEFAULT_CACHE_MB 32
+
+// results for the player to move
+#define TB_LOSS -1
+#define TB_DRAW 0
+#define TB_WIN 1
+
+// longest distance stored exactly, in plies
+#define TB_MAX_PLIES 127
+
+// entries of the WDL stream
+#define TB_WDL_DRAW 0
+#define TB_WDL_WIN 1
+#define TB_WDL_LOSS 2
+#define TB_WDL_ANY 3 // only given to WriteTablebaseSlice: a capture position or not a position
+
+// pieces of each kind in one slice
+typedef struct
+{
+    int redMen; // Red men
+    int redKings; // Red kings
+    int blackMen; // Black men
+    int blackKings; // Black kings
+} TablebaseMaterial;
+
+// one opened slice file
+typedef struct
+{
+    MappedFile map; // the mapped file
+    unsigned long long entries; // entries in the slice
+    unsigned int blocks; // compressed blocks in each stream
+    unsigned int id; // unique number for the block cache (never reused)
+} TablebaseSlice;
+
+// cache of decompressed blocks shared by every thread (defined in "tablebase.c")
+typedef struct TablebaseCache TablebaseCache;
+
+// every slice of a tablebase folder, NULL where a slice has no file
+typedef struct
+{
+    TablebaseSlice* slices[TB_MAX_PIECES + 1][TB_MAX_PIECES + 1][TB_MAX_PIECES + 1][TB_MAX_PIECES + 1];
+    int sliceCount; // slices opened
+    int maxPieces; // most pieces in any opened slice
+    TablebaseCache* cache; // decompressed blocks, NULL to decompress on every probe
+} Tablebase;
+
+// block cache counters, summed over every shard
+typedef struct
+{
+    unsigned long long hits; // probes that found their block in the cache
+    unsigned long long misses; // probes that had to decompress their block
+    unsigned long long blocks; // blocks the cache can hold
+    unsigned long long used; // blocks held right now
+} TablebaseCacheStats;
+
+// result of a probe, for the player to move
+typedef struct
+{
+    int outcome; // TB_WIN, TB_LOSS or TB_DRAW
+    int plies; // plies to the end of the game with best play (0 for a draw, TB_MAX_PLIES means at least that many)
+} TablebaseResult;
+
+// Indexing //
+
+// fill "material" with the piece counts of "game"
+void TablebaseMaterialOf(const GameState* game, TablebaseMaterial* material);
+
+// number of entries in the slice of "material" (both sides to move), 0 if it has no slice
+// (a side without pieces, more than TB_MAX_PIECES pieces or more than 12 of one color)
+unsigned long long TablebaseSliceEntries(const TablebaseMaterial* material);
+
+// index of "game" inside the slice of its own material
+// returns 1 on success, 0 if "game" has no slice or a man stands on its promotion row
+int TablebaseIndex(const GameState* game, unsigned long long* index);
+
+// rebuild the position numbered "index" in the slice of "material" ("zobrist_key" is not set)
+// returns 1 on success, 0 if "index" is out of range or is not a position (men on one square)
+int TablebasePosition(const TablebaseMaterial* material, unsigned long long index, GameState* game);
+
+// write the file name of the slice of "material" into "buffer" (Example: "tb_2011.cktb")
+void TablebaseFileName(const TablebaseMaterial* material, char* buffer, int size);
+
+// Entry Values //
+
+// turn an entry byte into a result for the player to move
+void TablebaseDecode(unsigned char value, TablebaseResult* result);
+
+// Files //
+
+// write one slice file "filename" from the DTW stream "values" and the WDL stream "wdl" ("entries" of each)
+// "wdl" holds TB_WDL_DRAW / TB_WDL_WIN / TB_WDL_LOSS, or TB_WDL_ANY for entries the probe works out itself
+// blocks are compressed and written one at a time, only the block offsets are kept in memory
+// returns 1 on success, 0 if the file could not be written completely
+int WriteTablebaseSlice(const char* filename, const TablebaseMaterial* material,
+    const unsigned char* values, const unsigned char* wdl, unsigned long long entries);
+
+// open every slice file found in "folder" (slices missing from the folder are simply absent)
+// with a block cache of "cacheMegabytes" MB (0 for none, probes then decompress every time)
+// returns the number of slices opened
+int OpenTablebase(const char* folder, size_t cacheMegabytes, Tablebase* tablebase);
+
+// open the one slice of "material" from "folder" into "tablebase" (used while generating)
+// returns 1 if it was opened (or was already open), 0 if the file is missing or invalid
+int OpenTablebaseSlice(const char* folder, const TablebaseMaterial* material, Tablebase* tablebase);
+
+// close every slice of "tablebase" and release its block cache
+void CloseTablebase(Tablebase* tablebase);
+
+// Probing //
+
+// read the block cache counters of "tablebase" into "stats" (all 0 without a cache)
+void TablebaseCacheCounters(const Tablebase* tablebase, TablebaseCacheStats* stats);
+
+// set the hit and miss counters of "tablebase" back to 0 (the cached blocks stay)
+void ResetTablebaseCacheCounters(Tablebase* tablebase);
+
+// look "game" up in "tablebase" (DTW stream: result and distance)
+// safe to call from several threads at once, the block cache is shared
+// returns 1 and fills "result" when the position's slice is open, otherwise 0
+int ProbeTablebase(const Tablebase* tablebase, const GameState* game, TablebaseResult* result);
+
+// look "game" up in "tablebase" (WDL stream: result only, smaller and faster to read)
+// positions with a capture are worked out from the slices the captures lead into
+// returns 1 and sets "outcome" to TB_WIN / TB_DRAW / TB_LOSS when every slice needed is open, otherwise 0
+int ProbeTablebaseWdl(const Tablebase* tablebase, const GameState* game, int* outcome);
+
+#endif
@@ -0,0 +1,644 @@
+// [tbgen.c] file
+
+// sysconf is POSIX, not part of plain C11
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h> // for printing progress and building file names
+#include <stdlib.h> // for malloc / free of the slice arrays
+#include <string.h> // for comparing arguments
+#include <time.h> // for timespec_get (time per slice)
+#include <stdatomic.h> // for the shared slice arrays and counters
+#include <pthread.h> // for the worker threads
+#include <unistd.h> // for sysconf (number of CPU cores)
+
+#include "tbgen.h" // declare "tbgen" methods
+#include "tablebase.h" // slice indexing, files and probing
+#include "game.h" // GameState and CheckWinner
+#include "movegen.h" // GenerateMoves / ApplyMove / HasCapture
+#include "movetables.h" // neighborSquare for stepping pieces back
+#include "bitoperations.h" // PopLowestBit64 for the piece sets
+#include "saveload.h" // ReadGameFile for "tbprobe"
+#include "zobrist.h" // InitZobrist before the workers start
+
+// default and maximum settings
+#define TBGEN_DEFAULT_PIECES 6
+#define TBGEN_MAX_JOBS 256
+
+// indexes handed to a worker at a time
+#define TBGEN_CHUNK 16384ull
+
+// indexes sharing one "next level" mark, so passes skip groups with nothing to do at a level
+#define TBGEN_GROUP 256ull
+#define LEVEL_NONE 0xFFFFu // group with no entry left to step back from
+
+// solving state of each entry (16 bits)
+#define STATE_UNKNOWN 0x0000u // not solved yet, a draw if still unknown at the end
+#define STATE_LOSS 0x8000u // STATE_LOSS | plies: the player to move loses
+#define STATE_INVALID 0xFFFFu // index number that is not a position
+#define STATE_CAPTURE 0x4000u // flag: the player to move has a capture ("don't care" in the WDL stream)
+#define STATE_PLIES 0x3FFFu // plies part of a state (a win is just its plies, 1 or more)
+
+// what the moves into other slices (captures, promotions) already decided, per entry
+#define OUT_WIN 0x8000u // OUT_WIN | plies: fastest win through another slice
+#define OUT_DRAW 0x4000u // a move into another slice draws, the entry can no longer lose
+// otherwise the value is the longest loss through another slice, in plies
+
+// steps of one solving pass
+#define PHASE_INIT 0 // generate every move, count moves inside the slice
+#define PHASE_PENDING 1 // wins through other slices that are due at this level
+#define PHASE_PROPAGATE 2 // step back from every entry solved at this level
+
+// one slice being solved, shared by every worker
+typedef struct
+{
+    const Tablebase* tablebase; // slices solved before this one (read only)
+    TablebaseMaterial material; // pieces of this slice
+    unsigned long long entries; // entries in the slice
+    _Atomic unsigned short* state; // solving state of each entry
+    _Atomic unsigned short* groupLevel; // lowest level still to process in each group of TBGEN_GROUP entries
+    _Atomic unsigned char* remaining; // moves inside the slice not yet known to lose
+    unsigned short* out; // result of the moves into other slices (written once in PHASE_INIT)
+    _Atomic unsigned long long next; // first index of the next chunk handed out
+    int phase; // PHASE_INIT / PHASE_PENDING / PHASE_PROPAGATE
+    int level; // plies being processed by PHASE_PENDING / PHASE_PROPAGATE
+    _Atomic int highest; // highest plies given to any entry so far
+    _Atomic int missing; // flagger for a needed slice that could not be probed
+} Solver;
+
+// method to read the wall clock in seconds
+static double WallSeconds(void)
+{
+    struct timespec now; // current wall clock time
+    timespec_get(&now, TIME_UTC);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+// method to record that entry "index" has work at level "plies" (a result or a pending win)
+// lowers the mark of its group and raises "highest" as needed
+static void NoteLevel(Solver* solver, unsigned long long index, int plies)
+{
+    _Atomic unsigned short* mark = &solver->groupLevel[index / TBGEN_GROUP]; // the entry's group
+    unsigned short level = atomic_load(mark); // current mark
+    int seen = atomic_load(&solver->highest); // current highest
+
+    while (plies < (int)level && !atomic_compare_exchange_weak(mark, &level, (unsigned short)plies)) { }
+    while (plies > seen && !atomic_compare_exchange_weak(&solver->highest, &seen, plies)) { }
+}
+
+// method to check if two materials are the same slice
+static int SameMaterial(const TablebaseMaterial* a, const TablebaseMaterial* b)
+{
+    return a->redMen == b->redMen && a->redKings == b->redKings && a->blackMen == b->blackMen
+        && a->blackKings == b->blackKings;
+}
+
+// method to generate every move of entry "index" and record what they lead to (PHASE_INIT)
+// moves that stay in the slice are only counted, the others are looked up in the solved slices
+static void InitEntry(Solver* solver, unsigned long long index)
+{
+    GameState position; // position of the entry
+    MoveList list; // its legal moves
+    unsigned int inside = 0u; // moves that stay in this slice
+    unsigned int win = 0u; // fastest win through another slice (0 for none)
+    unsigned int capture = 0u; // STATE_CAPTURE if the moves are captures
+    unsigned int lossMax = 0u; // longest loss through another slice
+    int draw = 0; // flagger for a move into another slice that draws
+    int i = 0; // loop iterator for the moves
+
+    // qualifier: index numbers that are not positions are skipped for good
+    if (!TablebasePosition(&solver->material, index, &position))
+    {
+        atomic_store(&solver->state[index], STATE_INVALID);
+        return;
+    }
+
+    // qualifier: a blocked player has lost
+    if (GenerateMoves(&position, &list) == 0)
+    {
+        atomic_store(&solver->state[index], STATE_LOSS);
+        NoteLevel(solver, index, 0);
+        return;
+    }
+
+    if (list.moves[0].jumps > 0) { capture = STATE_CAPTURE; }
+    for (i = 0; i < list.count; i++)
+    {
+        GameState child = position; // position after the move
+        TablebaseMaterial childMaterial; // pieces after the move
+        TablebaseResult result; // solved result of the child, for its player to move
+
+        ApplyMove(&child, &list.moves[i]);
+
+        // qualifier: capturing the last piece wins on the spot
+        if (CheckWinner(&child) != 0)
+        {
+            win = 1u;
+            continue;
+        }
+
+        // qualifier: steps that keep every piece stay in the slice, they are solved together
+        TablebaseMaterialOf(&child, &childMaterial);
+        if (SameMaterial(&childMaterial, &solver->material))
+        {
+            inside++;
+            continue;
+        }
+
+        // otherwise the child is in a smaller slice, solved earlier
+        if (!ProbeTablebase(solver->tablebase, &child, &result))
+        {
+            atomic_store(&solver->missing, 1);
+            continue;
+        }
+        if (result.outcome == TB_LOSS && (win == 0u || (unsigned int)result.plies + 1u < win)) { win = (unsigned int)result.plies + 1u; }
+        else if (result.outcome == TB_WIN && (unsigned int)result.plies > lossMax) { lossMax = (unsigned int)result.plies; }
+        else if (result.outcome == TB_DRAW) { draw = 1; }
+    }
+
+    // qualifier: with no moves inside the slice (always true for captures) the entry is decided now
+    if (inside == 0u)
+    {
+        if (win != 0u)
+        {
+            atomic_store(&solver->state[index], (unsigned short)(capture | win));
+            NoteLevel(solver, index, (int)win);
+        }
+        else if (!draw)
+        {
+            atomic_store(&solver->state[index], (unsigned short)(capture | STATE_LOSS | (lossMax + 1u)));
+            NoteLevel(solver, index, (int)lossMax + 1);
+        }
+        else { atomic_store(&solver->state[index], (unsigned short)capture); }
+        return;
+    }
+
+    // otherwise wait for the moves inside the slice, a win through another slice
+    // is only given at its own level in case a faster one turns up inside
+    atomic_store(&solver->remaining[index], (unsigned char)inside);
+    if (win != 0u)
+    {
+        solver->out[index] = (unsigned short)(OUT_WIN | win);
+        NoteLevel(solver, index, (int)win);
+    }
+    else if (draw) { solver->out[index] = OUT_DRAW; }
+    else { solver->out[index] = (unsigned short)lossMax; }
+}
+
+// method to give an entry the win through another slice that is due at this level (PHASE_PENDING)
+static void PendingEntry(Solver* solver, unsigned long long index)
+{
+    unsigned short out = solver->out[index]; // result of the moves into other slices
+
+    if ((out & OUT_WIN) != 0u && (int)(out & STATE_PLIES) == solver->level
+        && atomic_load(&solver->state[index]) == STATE_UNKNOWN)
+    {
+        atomic_store(&solver->state[index], (unsigned short)solver->level);
+    }
+}
+
+// method to update the entry that moved into "child" (PHASE_PROPAGATE)
+// "childLost" is 1 when the player to move in "child" loses at this level, 0 when they win
+static void UpdateParent(Solver* solver, const GameState* parent, int childLost)
+{
+    unsigned long long index = 0ull; // entry of the parent
+    unsigned short unknown = STATE_UNKNOWN; // expected state for the compare-exchange
+    int level = solver->level; // plies of the child
+
+    // qualifier: a step is only legal when no capture was possible
+    if (HasCapture(parent) || !TablebaseIndex(parent, &index)) { return; }
+    if (atomic_load(&solver->state[index]) != STATE_UNKNOWN) { return; }
+
+    // qualifier: a move into a lost position wins
+    if (childLost)
+    {
+        if (atomic_compare_exchange_strong(&solver->state[index], &unknown, (unsigned short)(level + 1))) { NoteLevel(solver, index, level + 1); }
+        return;
+    }
+
+    // otherwise one more move loses, the parent loses once every move does
+    // (unless a move into another slice wins or draws)
+    if (atomic_fetch_sub(&solver->remaining[index], 1u) == 1u)
+    {
+        unsigned short out = solver->out[index]; // result of the moves into other slices
+        int plies = level; // longest loss, this level is the last one inside the slice
+
+        if ((out & (OUT_WIN | OUT_DRAW)) != 0u) { return; }
+        if ((int)out > plies) { plies = (int)out; }
+        if (atomic_compare_exchange_strong(&solver->state[index], &unknown, (unsigned short)(STATE_LOSS | (plies + 1)))) { NoteLevel(solver, index, plies + 1); }
+    }
+}
+
+// method to step every piece of the player who just moved back, from an entry solved at this level
+// every step back gives a position (one ply earlier) whose entry is updated by UpdateParent
+static void PropagateEntry(Solver* solver, unsigned long long index)
+{
+    unsigned short state = atomic_load(&solver->state[index]); // solved state of the entry
+    GameState position; // position of the entry
+    unsigned long long* men = NULL; // men of the player who just moved
+    unsigned long long* kings = NULL; // kings of the player who just moved
+    unsigned long long occupied = 0ull; // every piece on the board
+    unsigned long long pieces = 0ull; // pieces of the player who just moved, not yet stepped back
+    int firstBack = 0; // first direction that leads back for the men (men only step forward)
+    int childLost = 0; // flagger for the player to move losing here
+
+    // qualifier: only entries solved at exactly this level (drawn captures have no plies)
+    if (state == STATE_INVALID || (state & (STATE_LOSS | STATE_PLIES)) == 0u || (int)(state & STATE_PLIES) != solver->level) { return; }
+    if (!TablebasePosition(&solver->material, index, &position)) { return; }
+    childLost = (state & STATE_LOSS) != 0u;
+
+    // the player who just moved is the one not to move, Red men move down so they came from above
+    if (position.current_turn == 2)
+    {
+        men = &position.player1_men;
+        kings = &position.player1_kings;
+        firstBack = 2;
+    }
+    else
+    {
+        men = &position.player2_men;
+        kings = &position.player2_kings;
+        firstBack = 0;
+    }
+    occupied = position.player1_men | position.player1_kings | position.player2_men | position.player2_kings;
+    position.current_turn = 3 - position.current_turn;
+
+    pieces = *men | *kings;
+    while (pieces != 0ull)
+    {
+        int square = PopLowestBit64(&pieces); // piece to step back
+        unsigned long long from = 1ull << square; // its bitboard mask
+        int isKing = (*kings & from) != 0ull; // kings could have come from any direction
+        int direction = 0; // loop iterator for the directions
+
+        for (direction = 0; direction < 4; direction++)
+        {
+            int origin = neighborSquare[square][direction]; // square the piece came from
+            unsigned long long back = 0ull; // its bitboard mask
+
+            // qualifier: men only come from behind, and the square must have been empty
+            if (!isKing && direction != firstBack && direction != firstBack + 1) { continue; }
+            if (origin == TABLE_NO_SQUARE) { continue; }
+            back = 1ull << origin;
+            if ((occupied & back) != 0ull) { continue; }
+
+            // move the piece back, update the parent, then put it where it was
+            if (isKing) { *kings = (*kings & ~from) | back; }
+            else { *men = (*men & ~from) | back; }
+            UpdateParent(solver, &position, childLost);
+            if (isKing) { *kings = (*kings & ~back) | from; }
+            else { *men = (*men & ~back) | from; }
+        }
+    }
+}
+
+// method to find the next level entry "index" still has work at, after the current level
+// returns LEVEL_NONE if its result was already stepped back from or it has none yet
+static unsigned int LaterLevel(const Solver* solver, unsigned long long index)
+{
+    unsigned short state = atomic_load(&solver->state[index]); // solving state
+    unsigned int out = solver->out[index]; // result of the moves into other slices
+    unsigned int plies = state & STATE_PLIES; // level of a result
+
+    if (state == STATE_INVALID) { return LEVEL_NONE; }
+    if ((state & (STATE_LOSS | STATE_PLIES)) != 0u) { return ((int)plies > solver->level) ? plies : LEVEL_NONE; }
+    if ((out & OUT_WIN) != 0u && (int)(out & STATE_PLIES) > solver->level) { return out & STATE_PLIES; }
+    return LEVEL_NONE;
+}
+
+// method to apply the current phase to one group of entries
+static void RunGroup(Solver* solver, unsigned long long first, unsigned long long last)
+{
+    _Atomic unsigned short* mark = &solver->groupLevel[first / TBGEN_GROUP]; // the group's mark
+    unsigned int next = LEVEL_NONE; // lowest later level found in the group
+    unsigned long long index = 0ull; // loop iterator for the group
+
+    if (solver->phase == PHASE_INIT)
+    {
+        for (index = first; index < last; index++) { InitEntry(solver, index); }
+        return;
+    }
+
+    // qualifier: groups with nothing at this level are skipped
+    if ((int)atomic_load(mark) > solver->level) { return; }
+    if (solver->phase == PHASE_PENDING)
+    {
+        for (index = first; index < last; index++) { PendingEntry(solver, index); }
+        return;
+    }
+
+    // clear the mark first: entries given a level while the group is scanned lower it again themselves
+    atomic_store(mark, (unsigned short)LEVEL_NONE);
+    for (index = first; index < last; index++)
+    {
+        unsigned int later = 0u; // next level of this entry
+
+        PropagateEntry(solver, index);
+        later = LaterLevel(solver, index);
+        if (later < next) { next = later; }
+    }
+    if (next != LEVEL_NONE) { NoteLevel(solver, first, (int)next); }
+}
+
+// method run by every worker thread, "context" is the Solver
+// takes chunks of indexes until the slice is covered and applies the current phase to each group
+static void* SolverWorker(void* context)
+{
+    Solver* solver = (Solver*)context; // shared slice
+
+    for (;;)
+    {
+        unsigned long long first = atomic_fetch_add(&solver->next, TBGEN_CHUNK); // first index of the chunk
+        unsigned long long last = first + TBGEN_CHUNK; // one past the last index
+        unsigned long long group = 0ull; // loop iterator for the groups of the chunk
+
+        if (first >= solver->entries) { break; }
+        if (last > solver->entries) { last = solver->entries; }
+
+        for (group = first; group < last; group += TBGEN_GROUP)
+        {
+            RunGroup(solver, group, (group + TBGEN_GROUP < last) ? group + TBGEN_GROUP : last);
+        }
+    }
+    return NULL;
+}
+
+// method to run one phase over the whole slice on "jobs" threads
+static void RunPhase(Solver* solver, int phase, int level, int jobs)
+{
+    pthread_t threads[TBGEN_MAX_JOBS]; // helper threads
+    int started = 0; // helper threads running
+    int i = 0; // loop iterator for the threads
+
+    solver->phase = phase;
+    solver->level = level;
+    atomic_store(&solver->next, 0ull);
+
+    // the calling thread is one of the workers
+    for (i = 1; i < jobs; i++)
+    {
+        if (pthread_create(&threads[started], NULL, SolverWorker, solver) == 0) { started++; }
+    }
+    SolverWorker(solver);
+    for (i = 0; i < started; i++) { pthread_join(threads[i], NULL); }
+}
+
+// method to solve and write one slice
+// returns 1 on success, 0 if memory ran out, a smaller slice was missing or the file could not be written
+static int SolveSlice(const char* folder, Tablebase* tablebase, const TablebaseMaterial* material, int jobs)
+{
+    Solver solver; // shared slice
+    unsigned long long entries = TablebaseSliceEntries(material); // entries in the slice
+    unsigned long long wins = 0ull, losses = 0ull, draws = 0ull; // results of the positions
+    unsigned long long index = 0ull; // loop iterator for the entries
+    unsigned char* values = NULL; // DTW stream written to the file
+    unsigned char* wdl = NULL; // WDL stream written to the file
+    char name[32]; // slice file name
+    char path[4096]; // folder and file name
+    char partPath[4104]; // file written first, renamed once complete
+    double start = WallSeconds(); // time when the slice started
+    int longest = 0; // longest win or loss, in plies
+    int level = 0; // loop iterator for the levels
+    int ok = 1; // flagger for success
+
+    TablebaseFileName(material, name, sizeof(name));
+    snprintf(path, sizeof(path), "%s/%s", folder, name);
+    snprintf(partPath, sizeof(partPath), "%s.part", path);
+
+    solver.tablebase = tablebase;
+    solver.material = *material;
+    solver.entries = entries;
+    solver.state = (_Atomic unsigned short*)calloc((size_t)entries, sizeof(unsigned short));
+    solver.groupLevel = (_Atomic unsigned short*)malloc((size_t)((entries + TBGEN_GROUP - 1) / TBGEN_GROUP) * sizeof(unsigned short));
+    solver.remaining = (_Atomic unsigned char*)calloc((size_t)entries, sizeof(unsigned char));
+    solver.out = (unsigned short*)calloc((size_t)entries, sizeof(unsigned short));
+    atomic_init(&solver.highest, 0);
+    atomic_init(&solver.missing, 0);
+    atomic_init(&solver.next, 0ull);
+
+    if (solver.state == NULL || solver.groupLevel == NULL || solver.remaining == NULL || solver.out == NULL)
+    {
+        printf("Out of memory for %s (%llu positions).\n", name, entries);
+        ok = 0;
+    }
+    for (index = 0ull; ok && index < (entries + TBGEN_GROUP - 1) / TBGEN_GROUP; index++) { atomic_init(&solver.groupLevel[index], (unsigned short)LEVEL_NONE); }
+
+    // every entry first, then every level in order of plies: wins and losses at level "n"
+    // decide the entries one ply before them, which always belong to a later level
+    if (ok) { RunPhase(&solver, PHASE_INIT, 0, jobs); }
+    if (ok && atomic_load(&solver.missing))
+    {
+        printf("A smaller slice needed by %s is missing.\n", name);
+        ok = 0;
+    }
+    for (level = 0; ok && level <= atomic_load(&solver.highest); level++)
+    {
+        if (level > 0) { RunPhase(&solver, PHASE_PENDING, level, jobs); }
+        RunPhase(&solver, PHASE_PROPAGATE, level, jobs);
+    }
+
+    // turn the solved states into the two streams (2 bytes, in place of the 3 of "out" and "remaining")
+    free(solver.out);
+    solver.out = NULL;
+    free((void*)solver.remaining);
+    solver.remaining = NULL;
+    free((void*)solver.groupLevel);
+    solver.groupLevel = NULL;
+    if (ok)
+    {
+        values = (unsigned char*)malloc((size_t)entries);
+        wdl = (unsigned char*)malloc((size_t)entries);
+    }
+    if (ok && (values == NULL || wdl == NULL))
+    {
+        printf("Out of memory for %s (%llu positions).\n", name, entries);
+        ok = 0;
+    }
+    for (index = 0ull; ok && index < entries; index++)
+    {
+        unsigned short state = atomic_load(&solver.state[index]); // solved state
+        int capture = (state != STATE_INVALID) && (state & STATE_CAPTURE) != 0u; // flagger for a capture position
+        int plies = (int)(state & STATE_PLIES); // plies to the end
+
+        // qualifier: the probe works captures out from the smaller slices, so the WDL stream does not need them
+        wdl[index] = TB_WDL_ANY;
+        values[index] = 0u;
+        if (state == STATE_INVALID) { continue; }
+        if (plies > longest) { longest = plies; }
+        if (plies > TB_MAX_PLIES) { plies = TB_MAX_PLIES; }
+
+        if ((state & STATE_LOSS) != 0u)
+        {
+            values[index] = (unsigned char)(128 + plies);
+            if (!capture) { wdl[index] = TB_WDL_LOSS; }
+            losses++;
+        }
+        else if (plies > 0)
+        {
+            values[index] = (unsigned char)plies;
+            if (!capture) { wdl[index] = TB_WDL_WIN; }
+            wins++;
+        }
+        else
+        {
+            if (!capture) { wdl[index] = TB_WDL_DRAW; }
+            draws++;
+        }
+    }
+    free((void*)solver.state);
+
+    // write the finished slice under a temporary name, so an interrupted run never leaves a partial slice
+    if (ok && (!WriteTablebaseSlice(partPath, material, values, wdl, entries) || rename(partPath, path) != 0))
+    {
+        printf("Could not write %s.\n", path);
+        remove(partPath);
+        ok = 0;
+    }
+    free(values);
+    free(wdl);
+    if (ok && !OpenTablebaseSlice(folder, material, tablebase))
+    {
+        printf("Could not open %s after writing it.\n", path);
+        ok = 0;
+    }
+
+    if (ok)
+    {
+        printf("%-14s %12llu positions  win %11llu  loss %11llu  draw %11llu  longest %3d plies  %8.2f s\n",
+            name, wins + losses + draws, wins, losses, draws, longest, WallSeconds() - start);
+        fflush(stdout);
+    }
+    return ok;
+}
+
+// run the "tbgen" command
+int RunTbGen(int argc, char* argv[])
+{
+    const char* folder = NULL; // folder receiving the slice files
+    Tablebase tablebase; // every slice solved so far
+    int pieces = TBGEN_DEFAULT_PIECES; // most pieces in a slice
+    int jobs = 0; // worker threads, 0 until chosen
+    int cacheMegabytes = TB_DEFAULT_CACHE_MB; // block cache for probing the smaller slices, in MB
+    int total = 0; // loop iterator for the number of pieces
+    int men = 0; // loop iterator for the number of men
+    int solved = 0; // slices written by this run
+    int skipped = 0; // slices already in the folder
+    int ok = 1; // flagger for every slice succeeding
+    double start = 0.0; // time when generation started
+    int i = 0; // loop iterator for the arguments
+
+    // read the options, the one other argument is the folder
+    for (i = 0; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--pieces") == 0 && i + 1 < argc) { pieces = atoi(argv[++i]); }
+        else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) { jobs = atoi(argv[++i]); }
+        else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) { cacheMegabytes = atoi(argv[++i]); }
+        else if (folder == NULL) { folder = argv[i]; }
+        else { folder = NULL; break; }
+    }
+
+    // qualifier: a folder is required and the settings must be in range
+    if (folder == NULL || pieces < 2 || pieces > TB_MAX_PIECES || jobs < 0 || jobs > TBGEN_MAX_JOBS || cacheMegabytes < 0)
+    {
+        printf("Usage: bitboardcheckers tbgen [--pieces N (2-%d)] [--jobs N (1-%d)] [--cache MB] <folder>\n", TB_MAX_PIECES, TBGEN_MAX_JOBS);
+        return 1;
+    }
+
+    // qualifier: one worker per CPU core unless "--jobs" was given
+    if (jobs == 0)
+    {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN); // online CPU cores
+        jobs = (cores < 1) ? 1 : (cores > TBGEN_MAX_JOBS ? TBGEN_MAX_JOBS : (int)cores);
+    }
+
+    InitZobrist(); // ApplyMove updates the position key, set the numbers up before the threads use them
+    OpenTablebase(folder, (size_t)cacheMegabytes, &tablebase);
+    start = WallSeconds();
+
+    // fewer pieces first, then fewer men: every capture or promotion leads into a slice solved earlier
+    for (total = 2; ok && total <= pieces; total++)
+    {
+        for (men = 0; ok && men <= total; men++)
+        {
+            TablebaseMaterial material; // slice to solve
+
+            for (material.redMen = 0; ok && material.redMen <= men; material.redMen++)
+            {
+                material.blackMen = men - material.redMen;
+                for (material.redKings = 0; ok && material.redKings <= total - men; material.redKings++)
+                {
+                    material.blackKings = total - men - material.redKings;
+
+                    // qualifier: both sides need a piece, and slices already in the folder are kept
+                    if (TablebaseSliceEntries(&material) == 0ull) { continue; }
+                    if (tablebase.slices[material.redMen][material.redKings][material.blackMen][material.blackKings] != NULL)
+                    {
+                        skipped++;
+                        continue;
+                    }
+
+                    ok = SolveSlice(folder, &tablebase, &material, jobs);
+                    if (ok) { solved++; }
+                }
+            }
+        }
+    }
+
+    printf("Solved %d slices up to %d pieces in %.2f s (%d already present, %d threads).\n",
+        solved, pieces, WallSeconds() - start, skipped, jobs);
+    CloseTablebase(&tablebase);
+    return ok ? 0 : 1;
+}
+
+// run the "tbprobe" command
+int RunTbProbe(int argc, char* argv[])
+{
+    Tablebase tablebase; // opened slices
+    int failed = 0; // files that could not be read or looked up
+    int i = 0; // loop iterator for the save files
+
+    // qualifier: a folder and at least one save file are required
+    if (argc < 2)
+    {
+        printf("Usage: bitboardcheckers tbprobe <folder> <savefiles...>\n");
+        return 1;
+    }
+
+    if (OpenTablebase(argv[0], TB_DEFAULT_CACHE_MB, &tablebase) == 0)
+    {
+        printf("No tablebase files found in: %s\n", argv[0]);
+        CloseTablebase(&tablebase);
+        return 1;
+    }
+
+    for (i = 1; i < argc; i++)
+    {
+        GameState game; // position to look up
+        TablebaseResult result; // its result
+        int errorLine = 0; // first invalid line of the file
+        const char* player = NULL; // name of the player to move
+
+        if (!ReadGameFile(argv[i], &game, &errorLine))
+        {
+            printf("%s: could not read the save file\n", argv[i]);
+            failed++;
+            continue;
+        }
+        if (!ProbeTablebase(&tablebase, &game, &result))
+        {
+            printf("%s: not in the tablebase\n", argv[i]);
+            failed++;
+            continue;
+        }
+
+        player = (game.current_turn == 1) ? "Red" : "Black";
+        if (result.outcome == TB_DRAW) { printf("%s: draw\n", argv[i]); }
+        else
+        {
+            printf("%s: %s to move %s in %s%d plies\n", argv[i], player, (result.outcome == TB_WIN) ? "wins" : "loses",
+                (result.plies == TB_MAX_PLIES) ? "at least " : "", result.plies);
+        }
+    }
+
+    CloseTablebase(&tablebase);
+    return (failed == 0) ? 0 : 1;
+}
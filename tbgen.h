@@ -0,0 +1,56 @@
+// [tbgen.h] header file
+// function declarations for "tbgen.c"
+// implemented in "main.c"
+
+#ifndef TBGEN_H
+#define TBGEN_H
+
+// { Phase 4 - Endgame Tablebase } //
+// command line generator and lookup for the endgame tablebase (see "tablebase.h")
+
+/*
+    Usage:
+        ./bitboardcheckers tbgen [--pieces N] [--jobs N] [--cache MB] <folder>
+            solve every slice with 2 to N pieces (default 6, at most 8) and
+            write one file per slice into the existing <folder>
+            --jobs N   worker threads (default: one per CPU core)
+            --cache MB block cache for reading the smaller slices (default 32)
+            slices already in the folder are kept, so an interrupted run
+            continues where it stopped
+
+        ./bitboardcheckers tbprobe <folder> <savefiles...>
+            print the tablebase result of each 5-line save file
+
+    Slices are solved in order of fewer pieces, then fewer men, so every
+    capture and promotion leads into a slice that is already on disk and is
+    probed from its mapped file. Only the slice being solved is kept in
+    memory (5 bytes per position while solving), and it is written to disk
+    as soon as it is finished.
+
+    Solving one slice (retrograde analysis):
+
+        1. every position generates its moves; moves into other slices are
+           probed, moves that stay in the slice (steps without promotion)
+           are only counted
+        2. level 0 holds the blocked positions, then for each level n:
+           a win in n plies through another slice is given if the position
+           is still unsolved, and every position solved at level n is
+           stepped back one ply (the last mover's piece moves backwards):
+               the position before a loss in n is a win in n + 1
+               the position before a win in n loses once all of its moves do
+        3. positions still unsolved are draws
+
+    Every pass is split into chunks of positions shared by the worker
+    threads; entries are updated with atomic operations, so the result is
+    the same for any number of threads.
+*/
+
+// run the "tbgen" command, "argc" / "argv" are the arguments after "tbgen"
+// returns 0 on success, 1 on a usage error or if a slice could not be solved or written
+int RunTbGen(int argc, char* argv[]);
+
+// run the "tbprobe" command, "argc" / "argv" are the arguments after "tbprobe"
+// returns 0 on success, 1 on a usage error or if a file could not be read or found
+int RunTbProbe(int argc, char* argv[]);
+
+#endif
@@ -0,0 +1,234 @@
+// [tt.c] file
+
+// note: entries are read and written with relaxed atomics, the XOR check
+// (not memory ordering) is what guarantees a reader never trusts a torn entry
+
+#include <stdlib.h> // for malloc / free of the table memory
+#include <stdint.h> // for uintptr_t (aligning the bucket array)
+
+#include "tt.h" // declare "tt" and "movegen" variables/methods
+
+// packed field positions inside the data word
+#define DATA_DEPTH_SHIFT 16
+#define DATA_BOUND_SHIFT 24
+#define DATA_GENERATION_SHIFT 26
+#define DATA_FROM_SHIFT 32
+#define DATA_TO_SHIFT 38
+#define DATA_HAS_MOVE_BIT (1ull << 44)
+
+// generations wrap around after 64 searches
+#define GENERATION_MASK 63u
+
+// method to read the generation stored in a data word
+static unsigned int DataGeneration(unsigned long long data)
+{
+    return (unsigned int)((data >> DATA_GENERATION_SHIFT) & GENERATION_MASK);
+}
+
+// method to read the depth stored in a data word
+static int DataDepth(unsigned long long data)
+{
+    return (int)((data >> DATA_DEPTH_SHIFT) & 0xFFull);
+}
+
+// allocate a table of about "megabytes" MB (rounded down to a power of 2 buckets, at least 1)
+// returns 1 on success, 0 if the memory could not be allocated
+int TTInit(TranspositionTable* table, size_t megabytes)
+{
+    unsigned long long bytes = (unsigned long long)megabytes * 1024ull * 1024ull; // requested size
+    unsigned long long count = 1ull; // number of buckets
+
+    // qualifier: double the bucket count while it still fits inside the requested size
+    while (count * 2ull * sizeof(TTBucket) <= bytes) { count = count * 2ull; }
+
+    // allocate one extra cache line, so the bucket array can start on a 64-byte boundary
+    table->memory = malloc((size_t)(count * sizeof(TTBucket)) + 64u);
+    if (table->memory == NULL)
+    {
+        table->buckets = NULL;
+        table->bucketCount = 0ull;
+        return 0;
+    }
+
+    table->buckets = (TTBucket*)(((uintptr_t)table->memory + 63u) & ~(uintptr_t)63u);
+    table->bucketCount = count;
+    atomic_init(&table->generation, 0u);
+    TTClear(table);
+    return 1;
+}
+
+// release the memory of a table created by TTInit
+void TTFree(TranspositionTable* table)
+{
+    free(table->memory);
+    table->memory = NULL;
+    table->buckets = NULL;
+    table->bucketCount = 0ull;
+}
+
+// empty every entry (the memory stays allocated)
+void TTClear(TranspositionTable* table)
+{
+    unsigned long long bucket = 0ull; // loop iterator for the buckets
+    int i = 0; // loop iterator for the entries of a bucket
+
+    for (bucket = 0ull; bucket < table->bucketCount; bucket++)
+    {
+        for (i = 0; i < TT_BUCKET_ENTRIES; i++)
+        {
+            atomic_store_explicit(&table->buckets[bucket].entries[i].key, 0ull, memory_order_relaxed);
+            atomic_store_explicit(&table->buckets[bucket].entries[i].data, 0ull, memory_order_relaxed);
+        }
+    }
+}
+
+// start a new search generation, older entries become preferred for replacement
+void TTNewSearch(TranspositionTable* table)
+{
+    unsigned int next = (atomic_load(&table->generation) + 1u) & GENERATION_MASK; // next generation
+    atomic_store(&table->generation, next);
+}
+
+// look up "key", on a hit fill "out" and return 1, otherwise return 0
+int TTProbe(TranspositionTable* table, unsigned long long key, TTData* out)
+{
+    TTBucket* bucket = &table->buckets[key & (table->bucketCount - 1ull)]; // bucket for this key
+    int i = 0; // loop iterator for the entries
+
+    for (i = 0; i < TT_BUCKET_ENTRIES; i++)
+    {
+        unsigned long long data = atomic_load_explicit(&bucket->entries[i].data, memory_order_relaxed);
+        unsigned long long check = atomic_load_explicit(&bucket->entries[i].key, memory_order_relaxed);
+
+        // qualifier: the entry belongs to this key only if the XOR gives the key back
+        // (an empty entry or one torn by a concurrent write fails this check)
+        if (data == 0ull || (check ^ data) != key) { continue; }
+
+        out->score = (int)(data & 0xFFFFull) - 32768;
+        out->depth = DataDepth(data);
+        out->bound = (int)((data >> DATA_BOUND_SHIFT) & 3ull);
+        out->hasMove = (data & DATA_HAS_MOVE_BIT) != 0ull;
+        out->from = (int)((data >> DATA_FROM_SHIFT) & 63ull);
+        out->to = (int)((data >> DATA_TO_SHIFT) & 63ull);
+        return 1;
+    }
+    return 0;
+}
+
+// method to write the packed entry "data" for "key" into its bucket, picking the entry to replace
+// an entry without a best move keeps the move already stored for the same key
+static void StoreData(TranspositionTable* table, unsigned long long key, unsigned long long data)
+{
+    TTBucket* bucket = &table->buckets[key & (table->bucketCount - 1ull)]; // bucket for this key
+    unsigned int generation = atomic_load_explicit(&table->generation, memory_order_relaxed);
+    int victim = 0; // entry that will be overwritten
+    int victimWorth = 0x7FFFFFFF; // how valuable the victim is, lower is replaced first
+    int i = 0; // loop iterator for the entries
+
+    for (i = 0; i < TT_BUCKET_ENTRIES; i++)
+    {
+        unsigned long long oldData = atomic_load_explicit(&bucket->entries[i].data, memory_order_relaxed);
+        unsigned long long oldKey = atomic_load_explicit(&bucket->entries[i].key, memory_order_relaxed);
+        int worth = 0; // replacement value of this entry
+
+        // qualifier: the same position is always overwritten, keeping its old move if none is given
+        if (oldData != 0ull && (oldKey ^ oldData) == key)
+        {
+            victim = i;
+            if ((data & DATA_HAS_MOVE_BIT) == 0ull && (oldData & DATA_HAS_MOVE_BIT) != 0ull)
+            {
+                data = data | (oldData & (DATA_HAS_MOVE_BIT | (0xFFFull << DATA_FROM_SHIFT)));
+            }
+            break;
+        }
+
+        // qualifier: an empty entry is used first
+        if (oldData == 0ull)
+        {
+            victim = i;
+            victimWorth = -0x7FFFFFFF;
+            continue;
+        }
+
+        // otherwise, entries from older searches and shallow entries are worth the least
+        worth = DataDepth(oldData) - 8 * (int)((generation - DataGeneration(oldData)) & GENERATION_MASK);
+        if (worth < victimWorth)
+        {
+            victim = i;
+            victimWorth = worth;
+        }
+    }
+
+    atomic_store_explicit(&bucket->entries[victim].key, key ^ data, memory_order_relaxed);
+    atomic_store_explicit(&bucket->entries[victim].data, data, memory_order_relaxed);
+}
+
+// store a search result for "key", "move" may be NULL when there is no best move
+void TTStore(TranspositionTable* table, unsigned long long key, int depth, int bound, int score, const Move* move)
+{
+    unsigned int generation = atomic_load_explicit(&table->generation, memory_order_relaxed);
+    unsigned long long data = 0ull; // packed new entry
+
+    // qualifier: keep the packed fields inside their bit widths
+    if (depth < 0) { depth = 0; }
+    if (depth > 255) { depth = 255; }
+
+    // pack the new entry
+    data = data | ((unsigned long long)(unsigned int)(score + 32768) & 0xFFFFull);
+    data = data | ((unsigned long long)depth << DATA_DEPTH_SHIFT);
+    data = data | ((unsigned long long)(bound & 3) << DATA_BOUND_SHIFT);
+    data = data | ((unsigned long long)generation << DATA_GENERATION_SHIFT);
+    if (move != NULL)
+    {
+        data = data | ((unsigned long long)move->from << DATA_FROM_SHIFT);
+        data = data | ((unsigned long long)move->to << DATA_TO_SHIFT);
+        data = data | DATA_HAS_MOVE_BIT;
+    }
+    StoreData(table, key, data);
+}
+
+// copy every entry of buckets "first" .. "last" - 1 of "source" into "table" and empty them in "source"
+void TTMergeBuckets(TranspositionTable* table, TranspositionTable* source, unsigned long long first, unsigned long long last)
+{
+    unsigned long long bucket = 0ull; // loop iterator for the source buckets
+    int i = 0; // loop iterator for the entries of a bucket
+
+    for (bucket = first; bucket < last; bucket++)
+    {
+        for (i = 0; i < TT_BUCKET_ENTRIES; i++)
+        {
+            TTEntry* entry = &source->buckets[bucket].entries[i]; // entry being moved
+            unsigned long long data = atomic_load_explicit(&entry->data, memory_order_relaxed);
+
+            if (data == 0ull) { continue; }
+
+            // the entry keeps its generation, depth and move, "table" decides where it goes
+            StoreData(table, atomic_load_explicit(&entry->key, memory_order_relaxed) ^ data, data);
+            atomic_store_explicit(&entry->key, 0ull, memory_order_relaxed);
+            atomic_store_explicit(&entry->data, 0ull, memory_order_relaxed);
+        }
+    }
+}
+
+// estimate how full the table is with entries of the current generation, in permille (0-1000)
+int TTHashfull(TranspositionTable* table)
+{
+    unsigned int generation = atomic_load_explicit(&table->generation, memory_order_relaxed);
+    unsigned long long samples = 250ull; // buckets sampled (1000 entries)
+    unsigned long long bucket = 0ull; // loop iterator for the sampled buckets
+    int used = 0; // sampled entries from the current generation
+    int i = 0; // loop iterator for the entries
+
+    // qualifier: small tables are sampled completely
+    if (samples > table->bucketCount) { samples = table->bucketCount; }
+
+    for (bucket = 0ull; bucket < samples; bucket++)
+    {
+        for (i = 0; i < TT_BUCKET_ENTRIES; i++)
+        {
+            unsigned long long data = atomic_load_explicit(&table->buckets[bucket].entries[i].data, memory_order_relaxed);
+            if (data != 0ull && DataGeneration(data) == generation) { used++; }
+        }
+    }
+    return (int)((unsigned long long)used * 1000ull / (samples * TT_BUCKET_ENTRIES));
+}
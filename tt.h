@@ -0,0 +1,112 @@
+// [tt.h] header file
+// function declarations for "tt.c"
+// implemented in "search.c" / "main.c"
+
+#ifndef TT_H
+#define TT_H
+
+#include <stddef.h> // for size_t (table size)
+#include <stdatomic.h> // for lock-free atomic entries
+
+#include "movegen.h" // implement Move structure
+
+// { Phase 4 - Transposition Table } //
+// remembers search results by position key, so a position reached again
+// (through another move order, or in the next iteration) is not searched twice
+
+/*
+    The table is an array of 64-byte buckets (one CPU cache line each),
+    every bucket holds 4 entries. A position's "zobrist_key" picks the bucket.
+
+    Each entry is two 64-bit words:
+        data: score, depth, bound type, generation, best move (packed below)
+        key:  zobrist_key XOR data
+
+    Threads read and write entries without locks. A reader accepts an entry
+    only if (key XOR data) gives back the key it is looking for, so an entry
+    torn by two threads writing at once is simply treated as a miss.
+
+    Packed "data" word:
+        bits  0-15  score + 32768 (unsigned)
+        bits 16-23  depth (0-255)
+        bits 24-25  bound type (TT_UPPER / TT_LOWER / TT_EXACT)
+        bits 26-31  generation (0-63)
+        bits 32-37  best move FROM (0-63)
+        bits 38-43  best move TO (0-63)
+        bit  44     1 if a best move is stored
+
+    Every new search increases the generation. When a bucket is full, the
+    entry to replace is the one from the oldest search, then the shallowest,
+    so a long analysis session keeps replacing stale entries.
+*/
+
+// bound types, how the stored score relates to the true score
+#define TT_UPPER 1 // true score <= stored score (no move beat alpha)
+#define TT_LOWER 2 // true score >= stored score (beta cut-off)
+#define TT_EXACT 3 // stored score is the true score
+
+// entries per 64-byte bucket
+#define TT_BUCKET_ENTRIES 4
+
+// one table entry, the key word is stored XORed with the data word
+typedef struct
+{
+    _Atomic unsigned long long key; // zobrist_key ^ data
+    _Atomic unsigned long long data; // packed score / depth / bound / generation / move
+} TTEntry;
+
+// 4 entries filling one 64-byte cache line
+typedef struct
+{
+    _Alignas(64) TTEntry entries[TT_BUCKET_ENTRIES];
+} TTBucket;
+
+// the whole table, shared by every search thread
+typedef struct
+{
+    TTBucket* buckets; // cache-line aligned bucket array
+    void* memory; // raw allocation holding "buckets" (freed by TTFree)
+    unsigned long long bucketCount; // number of buckets, a power of 2
+    _Atomic unsigned int generation; // generation of the current search (0-63)
+} TranspositionTable;
+
+// unpacked contents of an entry, filled by TTProbe
+typedef struct
+{
+    int score; // stored score
+    int depth; // depth the score was searched to
+    int bound; // TT_UPPER / TT_LOWER / TT_EXACT
+    int hasMove; // 1 if "from" / "to" hold a best move
+    int from; // best move FROM square
+    int to; // best move TO square
+} TTData;
+
+// allocate a table of about "megabytes" MB (rounded down to a power of 2 buckets, at least 1)
+// returns 1 on success, 0 if the memory could not be allocated
+int TTInit(TranspositionTable* table, size_t megabytes);
+
+// release the memory of a table created by TTInit
+void TTFree(TranspositionTable* table);
+
+// empty every entry (the memory stays allocated)
+void TTClear(TranspositionTable* table);
+
+// start a new search generation, older entries become preferred for replacement
+void TTNewSearch(TranspositionTable* table);
+
+// look up "key", on a hit fill "out" and return 1, otherwise return 0
+int TTProbe(TranspositionTable* table, unsigned long long key, TTData* out);
+
+// store a search result for "key", "move" may be NULL when there is no best move
+void TTStore(TranspositionTable* table, unsigned long long key, int depth, int bound, int score, const Move* move);
+
+// copy every entry of buckets "first" .. "last" - 1 of "source" into "table" (same replacement
+// rules as TTStore) and empty those buckets of "source", used to merge a thread's own table
+// into a shared one; with "source" no larger than "table", each bucket of "table" only receives
+// entries from one bucket of "source", so disjoint bucket ranges can be merged at the same time
+void TTMergeBuckets(TranspositionTable* table, TranspositionTable* source, unsigned long long first, unsigned long long last);
+
+// estimate how full the table is with entries of the current generation, in permille (0-1000)
+int TTHashfull(TranspositionTable* table);
+
+#endif
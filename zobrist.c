@@ -0,0 +1,78 @@
+// [zobrist.c] file
+
+#include "zobrist.h" // declare "zobrist" and "game" variables/methods
+#include "bitoperations.h" // PopLowestBit64 for walking over the pieces
+
+// fixed seed for the random numbers, keys must be identical in every run
+#define ZOBRIST_SEED 0x9E3779B97F4A7C15ull
+
+// random number for each piece type on each square (0-63)
+unsigned long long zobristPieces[4][64];
+
+// random number XORed into the key when Player 2 (Black) is to move
+unsigned long long zobristTurn = 0ull;
+
+// flagger so the tables are only filled once
+static int zobristReady = 0;
+
+// method for the splitmix64 random number generator
+// advances "state" and returns the next 64-bit random number
+static unsigned long long NextRandom(unsigned long long* state)
+{
+    unsigned long long value = 0ull; // mixed output
+
+    *state = *state + 0x9E3779B97F4A7C15ull;
+    value = *state;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+// fill the random number tables, safe to call more than once
+// called by SetBoard and LoadGame, before any key is computed
+void InitZobrist(void)
+{
+    unsigned long long state = ZOBRIST_SEED; // generator state
+    int type = 0; // loop iterator for the 4 piece types
+    int square = 0; // loop iterator for the 64 squares
+
+    // qualifier: the tables never change once filled
+    if (zobristReady) { return; }
+
+    for (type = 0; type < 4; type++)
+    {
+        for (square = 0; square < 64; square++) { zobristPieces[type][square] = NextRandom(&state); }
+    }
+    zobristTurn = NextRandom(&state);
+    zobristReady = 1;
+}
+
+// method to XOR the numbers for every piece of one type into "key"
+// visits only the set bits of "board", one bit scan per piece
+static unsigned long long HashBoard(unsigned long long key, unsigned long long board, int type)
+{
+    while (board != 0ull)
+    {
+        int square = PopLowestBit64(&board); // square of the next piece (cleared from "board")
+        key = key ^ zobristPieces[type][square];
+    }
+    return key;
+}
+
+// compute the key of "game" from scratch (every piece and the turn)
+// use after changing the bitboards directly, MakeMove / UnmakeMove keep the key up to date
+unsigned long long ComputeZobristKey(const GameState* game)
+{
+    unsigned long long key = 0ull; // key being built
+
+    InitZobrist();
+
+    key = HashBoard(key, game->player1_men, ZOBRIST_P1_MEN);
+    key = HashBoard(key, game->player1_kings, ZOBRIST_P1_KINGS);
+    key = HashBoard(key, game->player2_men, ZOBRIST_P2_MEN);
+    key = HashBoard(key, game->player2_kings, ZOBRIST_P2_KINGS);
+
+    // qualifier: the turn number is only included when Black is to move
+    if (game->current_turn == 2) { key = key ^ zobristTurn; }
+    return key;
+}
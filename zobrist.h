@@ -0,0 +1,52 @@
+// [zobrist.h] header file
+// function declarations for "zobrist.c"
+// implemented in "game.c" / "saveload.c" / "movegen.c"
+
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include "game.h" // implement GameState structure
+
+// { Phase 4 - Position Hashing } //
+// gives every position a 64-bit key, kept up to date by MakeMove with a few XORs
+
+/*
+    Zobrist hashing assigns a random 64-bit number to every (piece type, square)
+    pair and one more to "Player 2 (Black) to move". The key of a position is the
+    XOR of the numbers for every piece on the board (and the turn number when
+    Black is to move).
+
+    Since XOR undoes itself, moving a piece only needs:
+        key ^= zobristPieces[type][FROM] ^ zobristPieces[type][TO]
+    and each capture or promotion is one more XOR. Two positions with different
+    keys are always different, equal keys mean the same position with near certainty.
+
+    Piece types (first index of "zobristPieces"):
+        0: player1_men      1: player1_kings
+        2: player2_men      3: player2_kings
+
+    The numbers come from a fixed seed, so the same position has the same key
+    in every run and every build (keys can be stored in files).
+*/
+
+// piece type indexes for "zobristPieces"
+#define ZOBRIST_P1_MEN 0
+#define ZOBRIST_P1_KINGS 1
+#define ZOBRIST_P2_MEN 2
+#define ZOBRIST_P2_KINGS 3
+
+// random number for each piece type on each square (0-63)
+extern unsigned long long zobristPieces[4][64];
+
+// random number XORed into the key when Player 2 (Black) is to move
+extern unsigned long long zobristTurn;
+
+// fill the random number tables, safe to call more than once
+// called by SetBoard and LoadGame, before any key is computed
+void InitZobrist(void);
+
+// compute the key of "game" from scratch (every piece and the turn)
+// use after changing the bitboards directly, MakeMove / UnmakeMove keep the key up to date
+unsigned long long ComputeZobristKey(const GameState* game);
+
+#endif